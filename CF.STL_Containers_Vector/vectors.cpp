@@ -21,6 +21,60 @@
 #include <unordered_set>
 #include <compare>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <limits>
+#include <typeinfo>
+#include <array>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <bit>
+#include <type_traits>
+#include <concepts>
+#include <iterator>
+#include <stdexcept>
+#include <initializer_list>
+#include <utility>
+#include <charconv>
+#include <sstream>
+#include <ranges>
+#include <tuple>
+#include <random>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <exception>
+#include <map>
+#include <cstdio>
+#include <cerrno>
+#include <system_error>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <source_location>
+#include <ctime>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif  /* defined(__x86_64__) || defined(__i386__) */
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif  /* defined(__unix__) || defined(__APPLE__) */
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#endif  /* defined(__linux__) */
 
 using namespace std::literals::string_literals;
 
@@ -48,373 +102,10302 @@ auto const dot = delimiter('.');
 //  MARK: namespace valc
 namespace valc {
 
-template <class T>
-struct Mallocator {
-  typedef T value_type;
-
-  Mallocator () = default;
-  template <class U>
-  constexpr Mallocator(const Mallocator <U> &) noexcept {
-    std::cout << "In: "s << __func__ << std::endl;
-  }
-
-  [[nodiscard]]
-  T * allocate(std::size_t n_) {
-    std::cout << "In: "s << __func__
-              << ", request size: "s << n_
-              << ", request typeid: "s << typeid(T).name()
-              << ", type size: "s << sizeof(T)
-              << ", bytes: " << n_ * sizeof(T)
-              << std::endl;
-    if (n_ > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
-      throw std::bad_alloc();
-    }
-
-    if (auto pm = static_cast<T *>(std::malloc(n_ * sizeof(T)))) {
-      report(pm, n_);
-      return pm;
-    }
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace valc::trace
+/*
+ *  Allocator tracing.
+ *
+ *  mode::stream - every call is written through std::cout (the original demo).
+ *  mode::ring   - every call is recorded as a fixed-size event in a per-thread
+ *                 single-producer/single-consumer ring; the rings are drained
+ *                 on demand, by an optional background thread, or at exit.
+ *  mode::off    - nothing is recorded.
+ *
+ *  The ring fast path is a relaxed load of the mode, a steady_clock read and
+ *  one release store: no locks, no allocation, no init guard.  A thread's
+ *  ring is allocated and registered once, on that thread's first recorded
+ *  event.  When a ring is full new events are dropped and counted rather
+ *  than blocking; events recorded after the collector is destroyed at exit
+ *  are discarded.  The clock read is most of the cost (about 45 ns of it in
+ *  a VM whose steady_clock is slow).
+ */
+namespace trace {
 
-    throw std::bad_alloc();
-  }
+enum class mode : int { stream, ring, off, };
 
-  void deallocate(T * pm, std::size_t n_) noexcept {
-    std::cout << "In: "s << __func__ << std::endl;
-    report(pm, n_, 0);
-    std::free(pm);
-  }
+enum class event_type : std::uint8_t { allocate, deallocate, rebind, };
 
-private:
-  void report(T * pm, std::size_t n_, bool alloc = true) const {
-    std::cout << "In: "s << __func__ << std::endl;
-    std::cout << (alloc ? "Alloc: "s : "Dealloc: "s) << sizeof(T) * n_
-              << " bytes at "s << std::hex << std::showbase
-              << reinterpret_cast<void*>(pm) << std::dec << std::noshowbase
-              << '\n';
-  }
+struct event {
+  std::int64_t ns;            //  steady_clock, nanoseconds
+  std::size_t bytes;
+  void const * addr;
+  char const * type_name;     //  typeid(T).name(), static storage
+  event_type type;
 };
 
-template <class T, class U>
-bool operator==(const Mallocator <T> & lhs, const Mallocator <U> & rhs) {
-  std::cout << "In: "s << __func__ << ' '
-            << typeid(T).name() << " == "s << typeid(U).name() << std::endl;
-  return typeid(T) == typeid(U) ? true : false;
-}
+inline std::atomic<mode> current_mode { mode::stream };
 
-template <class T, class U>
-bool operator!=(const Mallocator <T> & lhs, const Mallocator <U> & rhs) {
-  std::cout << "In: "s << __func__ << ' '
-            << typeid(T).name() << " != "s << typeid(U).name() << std::endl;
-  return typeid(T) != typeid(U) ? true : false;
+inline void set_mode(mode md) noexcept {
+  current_mode.store(md, std::memory_order_relaxed);
 }
 
-} /* namespace valc */
+inline bool streaming() noexcept {
+  return current_mode.load(std::memory_order_relaxed) == mode::stream;
+}
 
-#if (__cplusplus > 201707L)
-#endif  /* (__cplusplus > 201707L) */
+inline bool ringing() noexcept {
+  return current_mode.load(std::memory_order_relaxed) == mode::ring;
+}
 
-//  MARK: - Function Prototype.
-int C_vector(int argc, const char * argv[]);
-int C_vector_bool(int argc, const char * argv[]);
+//  the mode for one scope; the one before comes back at its end, on an
+//  exception too.
+class mode_scope {
+public:
+  explicit mode_scope(mode md) noexcept
+    : was_(current_mode.load(std::memory_order_relaxed)) {
+    set_mode(md);
+  }
 
-//  MARK: - Implementation.
-/*
- *  MARK: main()
- */
-int main(int argc, const char * argv[]) {
-  // insert code here...
-  std::cout << "CF.STL_Containers_Vector\n";
-  std::cout << "C++ Version: "s << __cplusplus << std::endl;
+  ~mode_scope() { set_mode(was_); }
 
-  std::cout << '\n' << konst::dlm << std::endl;
-  C_vector(argc, argv);
+  mode_scope(mode_scope const &) = delete;
+  mode_scope & operator=(mode_scope const &) = delete;
 
-  std::cout << '\n' << konst::dlm << std::endl;
-  C_vector_bool(argc, argv);
+private:
+  mode was_;
+};
 
-  return 0;
-}
+class ring {
+public:
+  static constexpr std::size_t capacity = 4096;   //  must be a power of two
+  static_assert((capacity & (capacity - 1)) == 0);
 
-//  MARK: - C_vector
-//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
-//  ================================================================================
-//  MARK: namespace vec
-namespace vec {
-template<typename T>
-std::ostream & operator<<(std::ostream & strm, const std::vector<T> & vec)
-{
-  strm.put('[');
-  char comma[3] = {'\0', ' ', '\0'};
-  for (auto const & el : vec) {
-    strm << comma << el;
-    comma[0] = ',';
+  bool push(event const & ev) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == capacity) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    buf_[head & (capacity - 1)] = ev;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
   }
 
-  return strm << ']';
-}
+  //  only one consumer at a time; collector serialises callers.
+  template <class Fn>
+  std::size_t drain(Fn && fn) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    auto const head = head_.load(std::memory_order_acquire);
+    auto const count = head - tail;
+    for (; tail != head; ++tail) {
+      fn(buf_[tail & (capacity - 1)]);
+    }
+    tail_.store(tail, std::memory_order_release);
+    return count;
+  }
 
-} /* namespace vec */
+  std::size_t dropped() const noexcept {
+    return dropped_.load(std::memory_order_relaxed);
+  }
 
-namespace vecpop {
+private:
+  alignas(64) std::atomic<std::size_t> head_ { 0 };
+  alignas(64) std::atomic<std::size_t> tail_ { 0 };
+  std::atomic<std::size_t> dropped_ { 0 };
+  std::array<event, capacity> buf_;
+};
 
-template<typename T>
-void print(T const & xs) {
-  std::cout << "[ "s;
-  for (auto const & x_ : xs) {
-    std::cout << x_ << ' ';
+class collector {
+public:
+  static collector & instance() {
+    static collector cl;
+    return cl;
   }
-  std::cout << "]\n"s;
-}
 
-} /* namespace vecpop */
+  //  register a ring for the calling thread.  Rings are owned by the
+  //  collector so events survive the thread that produced them.
+  ring * attach() noexcept {
+    try {
+      std::lock_guard<std::mutex> lock(mtx_);
+      rings_.push_back(std::make_unique<ring>());
+      return rings_.back().get();
+    }
+    catch (...) {
+      return nullptr;
+    }
+  }
 
-//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
-//  MARK: namespace vecrsv
-namespace vecrsv {
+  template <class Fn>
+  std::size_t drain(Fn && fn) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto count = 0ul;
+    for (auto & rg : rings_) {
+      count += rg->drain(fn);
+    }
+    return count;
+  }
 
-// minimal C++11 allocator with debug output
-template <class Tp>
-struct NAlloc {
-  typedef Tp value_type;
+  std::size_t drain(std::ostream & os) {
+    return drain([&os](event const & ev) { print(os, ev); });
+  }
 
-  NAlloc() = default;
+  std::size_t dropped() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto count = 0ul;
+    for (auto & rg : rings_) {
+      count += rg->dropped();
+    }
+    return count;
+  }
 
-  template <class T> NAlloc(const NAlloc<T> &) {
-    std::cout << "In: "s << __func__ << std::endl;
+  //  background drain every period_ into os.
+  void start(std::chrono::milliseconds period_, std::ostream & os = std::cout) {
+    stop();
+    running_ = true;
+    drainer_ = std::thread([this, period_, &os]() {
+      std::unique_lock<std::mutex> lock(cv_mtx_);
+      while (running_) {
+        cv_.wait_for(lock, period_, [this]() { return !running_; });
+        drain(os);
+      }
+    });
   }
 
-  Tp * allocate(std::size_t nv) {
-    std::cout << "In: "s << __func__
-              << ", request size: "s << nv
-              << ", request typeid: "s << typeid(Tp).name()
-              << ", type size: "s << sizeof(Tp)
-              << ", bytes: " << nv * sizeof(Tp)
-              << std::endl;
-    nv *= sizeof(Tp);
-    Tp * p_typ = static_cast<Tp *>(::operator new(nv));
-    std::cout << "allocating "s << nv
-              << " bytes at address "s << p_typ
-              << std::endl;
-    return p_typ;
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(cv_mtx_);
+      running_ = false;
+    }
+    cv_.notify_all();
+    if (drainer_.joinable()) {
+      drainer_.join();
+    }
   }
 
-  void deallocate(Tp * p_typ, std::size_t nv) {
-    std::cout << "In: "s << __func__ << std::endl;
-    std::cout << "deallocating "s << nv * sizeof * p_typ
-              << " bytes from address "s << p_typ
-              << std::endl;
-    ::operator delete(p_typ);
+  static void print(std::ostream & os, event const & ev) {
+    static char const * const names[] = { "allocate", "deallocate", "rebind", };
+    os << '[' << ev.ns << "] "s << names[static_cast<int>(ev.type)]
+       << ' ' << ev.type_name;
+    if (ev.type != event_type::rebind) {
+      os << ' ' << ev.bytes << " bytes at "s << ev.addr;
+    }
+    os << '\n';
   }
+
+  ~collector();
+
+private:
+  collector() = default;
+
+  std::mutex mtx_;
+  std::vector<std::unique_ptr<ring>> rings_;
+  std::mutex cv_mtx_;
+  std::condition_variable cv_;
+  bool running_ { false };
+  std::thread drainer_;
 };
 
-template <class T, class U>
-bool operator==(const NAlloc<T> &, const NAlloc<U> &) {
-  std::cout << "In: "s << __func__ << std::endl;
-  return true;
-}
+//  constant-initialised, so the fast path runs no static or thread_local
+//  guard; the collector is only reached on a thread's first event.
+inline constinit std::atomic<bool> destroyed { false };
+inline constinit thread_local ring * local_ring { nullptr };
+inline constinit thread_local bool attached { false };
 
-template <class T, class U>
-bool operator!=(const NAlloc<T> &, const NAlloc<U> &) {
-  std::cout << "In: "s << __func__ << std::endl;
-  return false;
+inline collector::~collector() {
+  stop();
+  drain(std::cout);
+  destroyed.store(true, std::memory_order_relaxed);
 }
 
-} /* namespace vecrsv */
-
-//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
-//  MARK: namespace vecswp
-namespace vecswp {
+//  out of line: the first event on a thread, or any after exit began.
+[[gnu::noinline, gnu::cold]] inline ring * attach_local() noexcept {
+  if (destroyed.load(std::memory_order_relaxed) || attached) {
+    return nullptr;
+  }
+  attached = true;
+  local_ring = collector::instance().attach();
+  return local_ring;
+}
 
-template<class Os, class Co> Os & operator<<(Os & os, const Co& co) {
-  os << "{"s;
-  for (auto const & i : co) {
-    os << ' ' << i;
+inline void record(event_type type, std::size_t bytes, void const * addr,
+                   char const * type_name) noexcept {
+  if (!ringing()) {
+    return;
   }
-  return os << " } "s;
+  auto local = local_ring;
+  if (local == nullptr || destroyed.load(std::memory_order_relaxed)) [[unlikely]] {
+    if ((local = attach_local()) == nullptr) {
+      return;
+    }
+  }
+  auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+  local->push({ ns, bytes, addr, type_name, type, });
 }
 
-} /* namespace vecswp */
+} /* namespace trace */
 
 //  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace valc::stats
 /*
- *  MARK: C_vector()
+ *  Allocation statistics.
+ *
+ *  While enabled, Mallocator and vecrsv::NAlloc feed every allocate,
+ *  deallocate and reallocate into a registry instead of relying on the
+ *  per-call output; main()'s --alloc-stats also turns tracing off, so
+ *  none is written unless --trace= asks for it.  Calls are aggregated per value type and per call site,
+ *  the innermost stats::site scope on the allocating thread ("(unscoped)"
+ *  outside any).  Each record keeps the allocation count and bytes, a
+ *  power-of-two size histogram, live and peak live bytes, and the copies
+ *  caused by growth: a block freed straight after a larger block was
+ *  allocated for the same type and site (std::vector's grow-and-move), or a
+ *  reallocate that had to move the block.
+ *
+ *  A record is created once under the registry lock and updated with relaxed
+ *  atomics after that; each thread caches the records it has used.  Live
+ *  blocks are kept in a sharded address table so a block freed on another
+ *  thread, or after its scope has ended, is charged to the record that
+ *  allocated it.  Blocks allocated while disabled are not tracked.
+ *
+ *  snapshot() and report() query the registry at any time; dump_at_exit()
+ *  writes it as JSON when the program ends.
  */
-int C_vector(int argc, const char * argv[]) {
-  std::cout << "In "s << __func__ << std::endl;
+namespace stats {
 
-  // ....+....!....+....!....+....!....+....!....+....!....+....!
-  std::cout << konst::dot << '\n';
-  std::cout << "std::vector"s << '\n';
-  {
-    // Create a vector containing integers
-    std::vector<int> vnr = { 7, 5, 16, 8, };
+inline std::atomic<bool> enabled_ { false };
 
-    // Add two more integers to vector
-    vnr.push_back(25);
-    vnr.push_back(13);
+inline void enable(bool on = true) noexcept {
+  enabled_.store(on, std::memory_order_relaxed);
+}
 
-    // Print out the vector
-    std::cout << "v = { "s;
-    for (int nr : vnr) {
-      std::cout << nr << ", "s;
-    }
-    std::cout << "}; \n"s;
+inline bool enabled() noexcept {
+  return enabled_.load(std::memory_order_relaxed);
+}
+
+//  attribute allocations on this thread to a call site for the scope's life.
+class site {
+public:
+  explicit site(char const * label = nullptr,
+                std::source_location loc = std::source_location::current()) noexcept
+    : label_(label), file_(loc.file_name()), line_(loc.line()), prev_(top_) {
+    top_ = this;
   }
-  std::cout << std::endl; //  make sure cout is flushed.
 
-  /// Constructors
-  // ....+....!....+....!....+....!....+....!....+....!....+....!
-  std::cout << konst::dot << '\n';
-  std::cout << "std::vector - constructor"s << '\n';
-  {
-    using namespace vec;
+  ~site() {
+    top_ = prev_;
+  }
 
-    // c++11 initializer list syntax:
-    std::vector<std::string> words1 { "the"s, "frogurt"s, "is"s, "also"s, "cursed"s, };
-    std::cout << "words1: "s << words1 << '\n';
+  site(site const &) = delete;
+  site & operator=(site const &) = delete;
 
-    // words2 == words1
-    std::vector<std::string> words2(words1.begin(), words1.end());
-    std::cout << "words2: "s << words2 << '\n';
+  static site const * current() noexcept { return top_; }
 
-    // words3 == words1
-    std::vector<std::string> words3(words1);
-    std::cout << "words3: "s << words3 << '\n';
+  char const * label() const noexcept { return label_; }
+  char const * file() const noexcept { return file_; }
+  std::uint_least32_t line() const noexcept { return line_; }
 
-    // words4 is {"Mo", "Mo", "Mo", "Mo", "Mo"}
-    std::vector<std::string> words4(5, "Mo");
-    std::cout << "words4: "s << words4 << '\n';
-  }
-  std::cout << std::endl; //  make sure cout is flushed.
+private:
+  char const * label_;
+  char const * file_;
+  std::uint_least32_t line_;
+  site * prev_;
 
-  // ....+....!....+....!....+....!....+....!....+....!....+....!
-  std::cout << konst::dot << '\n';
-  std::cout << "std::vector - constructor, custom allocator"s << '\n';
-  {
-    auto cc(0ul);
-    auto constexpr cc_max(10ul);
-    auto sp(4);
-    auto prtnumeric = [&cc, &sp](auto el) {
-      std::cout << std::setw(sp) << el
-      << (++cc % cc_max == 0 ? "\n"s : ""s);
-    };
+  static inline thread_local site * top_ = nullptr;
+};
 
-    std::vector<int, valc::Mallocator<int>> vnr(8);
-    std::cout << "initial size: "s << std::setw(4) << vnr.size()
-              << ", capacity: "s << std::setw(6) << vnr.capacity()
-              << '\n';
+//  all members point at static storage: typeid names, literals, __FILE__.
+struct key {
+  char const * type_name;
+  char const * label;
+  char const * file;
+  std::uint_least32_t line;
 
-    if (!vnr.empty()) {
-      std::cout << vnr.data() << '\n';
-      cc = 0ul;
-      sp = 4ul;
-      std::for_each(vnr.cbegin(), vnr.cend(), prtnumeric);
-      std::cout << '\n';
+  bool operator==(key const &) const = default;
+};
+
+struct key_hash {
+  std::size_t operator()(key const & id) const noexcept {
+    auto hs = std::hash<void const *>{}(id.type_name);
+    for (auto ptr : { static_cast<void const *>(id.label), static_cast<void const *>(id.file), }) {
+      hs = hs * 31 + std::hash<void const *>{}(ptr);
     }
-    std::cout << "add a value.\n"s;
-    vnr.push_back(42);
+    return hs * 31 + id.line;
+  }
+};
 
-    std::cout << "add a value.\n"s;
-    for (auto nr : { -42, 21, 77, -0, -1, 0, 666, 33, -99, 3, }) {
-      std::cout << "adding "s << std::setw(4) << nr << '\n';
-      vnr.push_back(nr);
+//  bucket k holds sizes [2^(k-1), 2^k); bucket 0 holds empty requests.
+inline constexpr std::size_t buckets = std::numeric_limits<std::size_t>::digits + 1;
+
+inline std::size_t bucket(std::size_t bytes) noexcept {
+  return static_cast<std::size_t>(std::bit_width(bytes));
+}
+
+struct counters {
+  explicit counters(key const & id) noexcept : id(id) {}
+
+  void allocated(std::size_t bytes) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(bytes, std::memory_order_relaxed);
+    histogram[bucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+    auto const now = live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    auto high = peak.load(std::memory_order_relaxed);
+    while (high < now
+           && !peak.compare_exchange_weak(high, now, std::memory_order_relaxed)) {
     }
+  }
 
-    std::cout << vnr.data() << '\n';
-    std::cout << "new size: "s << std::setw(4) << vnr.size()
-              << ", capacity: "s << std::setw(6) << vnr.capacity()
-              << '\n';
-    cc = 0ul;
-    sp = 4ul;
-    std::for_each(vnr.cbegin(), vnr.cend(), prtnumeric);
-    std::cout << '\n';
+  void deallocated(std::size_t bytes) noexcept {
+    deallocations.fetch_add(1, std::memory_order_relaxed);
+    live.fetch_sub(bytes, std::memory_order_relaxed);
   }
-  std::cout << std::endl; //  make sure cout is flushed.
 
-  /// Container functions
+  void relocated(std::size_t bytes) noexcept {
+    relocations.fetch_add(1, std::memory_order_relaxed);
+    relocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  void clear() noexcept {
+    for (auto * ct : { &allocations, &deallocations, &total, &live, &peak,
+                       &relocations, &relocated_bytes, }) {
+      ct->store(0, std::memory_order_relaxed);
+    }
+    for (auto & hc : histogram) {
+      hc.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  key const id;
+  std::atomic<std::uint64_t> allocations { 0 };
+  std::atomic<std::uint64_t> deallocations { 0 };
+  std::atomic<std::uint64_t> total { 0 };
+  std::atomic<std::uint64_t> live { 0 };
+  std::atomic<std::uint64_t> peak { 0 };
+  std::atomic<std::uint64_t> relocations { 0 };
+  std::atomic<std::uint64_t> relocated_bytes { 0 };
+  std::array<std::atomic<std::uint64_t>, buckets> histogram {};
+};
+
+//  a point-in-time copy of one record.
+struct record {
+  std::string type_name;
+  std::string site;               //  label, or "(unscoped)"
+  std::string file;
+  std::uint_least32_t line;
+  std::uint64_t allocations;
+  std::uint64_t deallocations;
+  std::uint64_t bytes;
+  std::uint64_t live;
+  std::uint64_t peak;
+  std::uint64_t relocations;
+  std::uint64_t relocated_bytes;
+  std::array<std::uint64_t, buckets> histogram;
+};
+
+class registry {
+public:
+  //  never destroyed: containers with static storage may still free blocks
+  //  after every other static object has gone.
+  static registry & instance() {
+    static registry * const rg = new registry;
+    return *rg;
+  }
+
+  counters * find(key const & id) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto & slot = table_[id];
+    if (!slot) {
+      slot = std::make_unique<counters>(id);
+    }
+    return slot.get();
+  }
+
+  void track(void const * addr, counters * ct) {
+    auto & sh = shard_for(addr);
+    std::lock_guard<std::mutex> lock(sh.mtx);
+    sh.blocks[addr] = ct;
+    tracked_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  //  the record that allocated addr, or nullptr for an untracked block.
+  counters * untrack(void const * addr) noexcept {
+    auto & sh = shard_for(addr);
+    std::lock_guard<std::mutex> lock(sh.mtx);
+    auto const it = sh.blocks.find(addr);
+    if (it == sh.blocks.end()) {
+      return nullptr;
+    }
+    auto * const ct = it->second;
+    sh.blocks.erase(it);
+    tracked_.fetch_sub(1, std::memory_order_relaxed);
+    return ct;
+  }
+
+  bool tracking() const noexcept {
+    return tracked_.load(std::memory_order_relaxed) != 0;
+  }
+
+  //  records sorted by bytes allocated, largest first.
+  std::vector<record> snapshot() {
+    std::vector<record> rcs;
+    std::lock_guard<std::mutex> lock(mtx_);
+    rcs.reserve(table_.size());
+    for (auto const & [id, ct] : table_) {
+      auto & rc = rcs.emplace_back();
+      rc.type_name = id.type_name;
+      rc.site = id.label != nullptr ? id.label : "(unscoped)";
+      rc.file = id.file != nullptr ? id.file : "";
+      rc.line = id.line;
+      rc.allocations = ct->allocations.load(std::memory_order_relaxed);
+      rc.deallocations = ct->deallocations.load(std::memory_order_relaxed);
+      rc.bytes = ct->total.load(std::memory_order_relaxed);
+      rc.live = ct->live.load(std::memory_order_relaxed);
+      rc.peak = ct->peak.load(std::memory_order_relaxed);
+      rc.relocations = ct->relocations.load(std::memory_order_relaxed);
+      rc.relocated_bytes = ct->relocated_bytes.load(std::memory_order_relaxed);
+      for (auto bk = 0ul; bk < buckets; ++bk) {
+        rc.histogram[bk] = ct->histogram[bk].load(std::memory_order_relaxed);
+      }
+    }
+    std::sort(rcs.begin(), rcs.end(), [](record const & lhs, record const & rhs) {
+      return lhs.bytes > rhs.bytes;
+    });
+    return rcs;
+  }
+
+  //  zero every record and forget the live blocks; records stay allocated
+  //  because threads cache pointers to them.
+  void reset() {
+    for (auto & sh : shards_) {
+      std::lock_guard<std::mutex> lock(sh.mtx);
+      tracked_.fetch_sub(sh.blocks.size(), std::memory_order_relaxed);
+      sh.blocks.clear();
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (auto & [id, ct] : table_) {
+      ct->clear();
+    }
+  }
+
+private:
+  registry() = default;
+
+  struct shard {
+    std::mutex mtx;
+    std::unordered_map<void const *, counters *> blocks;
+  };
+  static constexpr std::size_t shard_count = 16;
+
+  shard & shard_for(void const * addr) noexcept {
+    auto const bits = reinterpret_cast<std::uintptr_t>(addr);
+    return shards_[((bits >> 4) ^ (bits >> 12)) & (shard_count - 1)];
+  }
+
+  std::mutex mtx_;
+  std::unordered_map<key, std::unique_ptr<counters>, key_hash> table_;
+  std::array<shard, shard_count> shards_;
+  std::atomic<std::size_t> tracked_ { 0 };
+};
+
+//  the last block this thread allocated; a free of a smaller block from the
+//  same record straight after it is a grow-and-move.
+struct last_allocation {
+  counters * ct;
+  std::size_t bytes;
+};
+
+inline last_allocation & last() noexcept {
+  thread_local last_allocation la { nullptr, 0, };
+  return la;
+}
+
+inline counters * lookup(char const * type_name) {
+  thread_local std::unordered_map<key, counters *, key_hash> cache;
+  thread_local std::pair<key, counters *> recent { key {}, nullptr, };
+  auto const * const st = site::current();
+  auto const id = st != nullptr
+                ? key { type_name, st->label(), st->file(), st->line(), }
+                : key { type_name, nullptr, nullptr, 0, };
+  if (recent.second != nullptr && recent.first == id) {
+    return recent.second;
+  }
+  auto & slot = cache[id];
+  if (slot == nullptr) {
+    slot = registry::instance().find(id);
+  }
+  recent = { id, slot, };
+  return slot;
+}
+
+inline void on_allocate(char const * type_name, void const * addr, std::size_t bytes) noexcept {
+  if (!enabled()) {
+    return;
+  }
+  try {
+    auto * const ct = lookup(type_name);
+    registry::instance().track(addr, ct);
+    ct->allocated(bytes);
+    last() = { ct, bytes, };
+  }
+  catch (...) {
+    //  out of memory for the bookkeeping: the block simply goes untracked.
+  }
+}
+
+inline void on_deallocate(void const * addr, std::size_t bytes) noexcept {
+  auto & rg = registry::instance();
+  if (!rg.tracking()) {
+    return;
+  }
+  if (auto * const ct = rg.untrack(addr)) {
+    ct->deallocated(bytes);
+    if (auto & la = last(); la.ct == ct && la.bytes > bytes) {
+      ct->relocated(bytes);
+    }
+  }
+  last() = { nullptr, 0, };
+}
+
+//  the first half of a reallocate: the old block leaves the address table
+//  before realloc, since once realloc has freed it another thread may be
+//  handed the same address.  Nothing is charged until the outcome is known.
+inline counters * on_reallocate_begin(void const * addr) noexcept {
+  auto & rg = registry::instance();
+  return rg.tracking() ? rg.untrack(addr) : nullptr;
+}
+
+//  realloc failed: the old block is still live and goes back in the table.
+inline void on_reallocate_failed(void const * addr, counters * old_ct) noexcept {
+  if (old_ct == nullptr) {
+    return;
+  }
+  try {
+    registry::instance().track(addr, old_ct);
+  }
+  catch (...) {
+    //  out of memory for the bookkeeping: the block simply goes untracked.
+  }
+}
+
+//  the second half of a successful reallocate: the old block is charged as
+//  freed to the record that allocated it, the new one as allocated.
+inline void on_reallocate(char const * type_name, bool moved, counters * old_ct,
+                          std::size_t old_bytes, void const * new_addr,
+                          std::size_t new_bytes) noexcept {
+  if (old_ct != nullptr) {
+    old_ct->deallocated(old_bytes);
+  }
+  on_allocate(type_name, new_addr, new_bytes);
+  if (moved && enabled()) {
+    if (auto & la = last(); la.ct != nullptr) {
+      la.ct->relocated(std::min(old_bytes, new_bytes));
+    }
+  }
+  last() = { nullptr, 0, };
+}
+
+inline std::vector<record> snapshot() {
+  return registry::instance().snapshot();
+}
+
+inline void reset() {
+  registry::instance().reset();
+}
+
+inline void report(std::vector<record> const & rcs, std::ostream & os = std::cout) {
+  os << std::left << std::setw(12) << "type"s << std::setw(20) << "site"s << std::right
+     << std::setw(8) << "allocs"s << std::setw(12) << "bytes"s
+     << std::setw(10) << "peak"s << std::setw(10) << "live"s
+     << std::setw(8) << "moves"s << std::setw(12) << "moved"s << '\n';
+  for (auto const & rc : rcs) {
+    os << std::left << std::setw(12) << rc.type_name << std::setw(20) << rc.site << std::right
+       << std::setw(8) << rc.allocations << std::setw(12) << rc.bytes
+       << std::setw(10) << rc.peak << std::setw(10) << rc.live
+       << std::setw(8) << rc.relocations << std::setw(12) << rc.relocated_bytes << '\n';
+    os << "  sizes:"s;
+    for (auto bk = 0ul; bk < buckets; ++bk) {
+      if (rc.histogram[bk] != 0) {
+        os << ' ' << (bk == 0 ? 0ul : 1ul << (bk - 1)) << "+: "s << rc.histogram[bk];
+      }
+    }
+    os << '\n';
+  }
+}
+
+inline void report(std::ostream & os = std::cout) {
+  report(snapshot(), os);
+}
+
+inline void json_string(std::ostream & os, std::string_view sv) {
+  os << '"';
+  for (auto ch : sv) {
+    switch (ch) {
+    case '"':  os << "\\\""s; break;
+    case '\\': os << "\\\\"s; break;
+    case '\n': os << "\\n"s;  break;
+    case '\t': os << "\\t"s;  break;
+    default:
+      if (static_cast<unsigned char>(ch) < 0x20) {
+        char esc[8];
+        std::snprintf(esc, sizeof(esc), "\\u%04x", static_cast<unsigned>(ch));
+        os << esc;
+      }
+      else {
+        os << ch;
+      }
+      break;
+    }
+  }
+  os << '"';
+}
+
+inline void json(std::vector<record> const & rcs, std::ostream & os) {
+  os << "{\n  \"records\": ["s;
+  char const * sep = "\n";
+  for (auto const & rc : rcs) {
+    os << sep << "    {\"type\": "s;
+    json_string(os, rc.type_name);
+    os << ", \"site\": "s;
+    json_string(os, rc.site);
+    os << ", \"file\": "s;
+    json_string(os, rc.file);
+    os << ", \"line\": "s << rc.line
+       << ",\n     \"allocations\": "s << rc.allocations
+       << ", \"deallocations\": "s << rc.deallocations
+       << ", \"bytes\": "s << rc.bytes
+       << ", \"live_bytes\": "s << rc.live
+       << ", \"peak_bytes\": "s << rc.peak
+       << ", \"relocations\": "s << rc.relocations
+       << ", \"relocated_bytes\": "s << rc.relocated_bytes
+       << ",\n     \"histogram\": ["s;
+    char const * hsep = "";
+    for (auto bk = 0ul; bk < buckets; ++bk) {
+      if (rc.histogram[bk] != 0) {
+        auto const lo = bk == 0 ? 0ul : 1ul << (bk - 1);
+        auto const hi = bk == 0 ? 0ul : lo + (lo - 1);
+        os << hsep << "{\"min\": "s << lo << ", \"max\": "s << hi
+           << ", \"count\": "s << rc.histogram[bk] << '}';
+        hsep = ", ";
+      }
+    }
+    os << "]}"s;
+    sep = ",\n";
+  }
+  os << "\n  ]\n}\n"s;
+}
+
+inline void json(std::ostream & os) {
+  json(snapshot(), os);
+}
+
+//  write the registry as JSON to path ("-" for stdout) when the program ends.
+inline void dump_at_exit(std::string path) {
+  static std::string target;
+  static std::once_flag registered;
+  target = std::move(path);
+  std::call_once(registered, []() {
+    std::atexit([]() {
+      enable(false);
+      if (target == "-") {
+        json(std::cout);
+        return;
+      }
+      std::ofstream ofs(target);
+      if (!ofs) {
+        std::cerr << "valc::stats: cannot write "s << target << '\n';
+        return;
+      }
+      json(ofs);
+    });
+  });
+}
+
+} /* namespace stats */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace valc::Mallocator
+template <class T>
+struct Mallocator {
+  typedef T value_type;
+
+  Mallocator () = default;
+  template <class U>
+  constexpr Mallocator(const Mallocator <U> &) noexcept {
+    if (trace::streaming()) {
+      std::cout << "In: "s << __func__ << std::endl;
+    }
+    else {
+      trace::record(trace::event_type::rebind, 0, nullptr, typeid(T).name());
+    }
+  }
+
+  [[nodiscard]]
+  T * allocate(std::size_t n_) {
+    if (trace::streaming()) {
+      std::cout << "In: "s << __func__
+                << ", request size: "s << n_
+                << ", request typeid: "s << typeid(T).name()
+                << ", type size: "s << sizeof(T)
+                << ", bytes: " << n_ * sizeof(T)
+                << std::endl;
+    }
+    if (n_ > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+
+    if (auto pm = static_cast<T *>(std::malloc(n_ * sizeof(T)))) {
+      report(pm, n_);
+      stats::on_allocate(typeid(T).name(), pm, n_ * sizeof(T));
+      return pm;
+    }
+
+    throw std::bad_alloc();
+  }
+
+  void deallocate(T * pm, std::size_t n_) noexcept {
+    if (trace::streaming()) {
+      std::cout << "In: "s << __func__ << std::endl;
+    }
+    report(pm, n_, 0);
+    stats::on_deallocate(pm, n_ * sizeof(T));
+    std::free(pm);
+  }
+
+  //  grow or shrink in place with std::realloc (which may mremap large
+  //  blocks); only valid for types that can be relocated with memcpy.
+  [[nodiscard]]
+  T * reallocate(T * pm, std::size_t old_n, std::size_t n_) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (trace::streaming()) {
+      std::cout << "In: "s << __func__
+                << ", request size: "s << old_n << " -> "s << n_
+                << ", request typeid: "s << typeid(T).name()
+                << ", bytes: " << n_ * sizeof(T)
+                << std::endl;
+    }
+    if (n_ > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+
+    report(pm, old_n, 0);
+    auto * const old_ct = stats::on_reallocate_begin(pm);
+    auto const from = reinterpret_cast<std::uintptr_t>(pm);
+    if (auto pn = static_cast<T *>(std::realloc(pm, n_ * sizeof(T)))) {
+      report(pn, n_);
+      stats::on_reallocate(typeid(T).name(), reinterpret_cast<std::uintptr_t>(pn) != from,
+                           old_ct, old_n * sizeof(T), pn, n_ * sizeof(T));
+      return pn;
+    }
+
+    report(reinterpret_cast<T *>(from), old_n);
+    stats::on_reallocate_failed(reinterpret_cast<void const *>(from), old_ct);
+    throw std::bad_alloc();
+  }
+
+private:
+  void report(T * pm, std::size_t n_, bool alloc = true) const {
+    if (!trace::streaming()) {
+      trace::record(alloc ? trace::event_type::allocate : trace::event_type::deallocate,
+                    sizeof(T) * n_, pm, typeid(T).name());
+      return;
+    }
+    std::cout << "In: "s << __func__ << std::endl;
+    std::cout << (alloc ? "Alloc: "s : "Dealloc: "s) << sizeof(T) * n_
+              << " bytes at "s << std::hex << std::showbase
+              << reinterpret_cast<void*>(pm) << std::dec << std::noshowbase
+              << '\n';
+  }
+};
+
+template <class T, class U>
+bool operator==(const Mallocator <T> & lhs, const Mallocator <U> & rhs) {
+  std::cout << "In: "s << __func__ << ' '
+            << typeid(T).name() << " == "s << typeid(U).name() << std::endl;
+  return typeid(T) == typeid(U) ? true : false;
+}
+
+template <class T, class U>
+bool operator!=(const Mallocator <T> & lhs, const Mallocator <U> & rhs) {
+  std::cout << "In: "s << __func__ << ' '
+            << typeid(T).name() << " != "s << typeid(U).name() << std::endl;
+  return typeid(T) != typeid(U) ? true : false;
+}
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace valc::DefaultInitAllocator
+/*
+ *  Allocator adaptor: construct(p) with no arguments default-initialises
+ *  (`new (p) U`) instead of value-initialising (`new (p) U()`), so
+ *  resize(n) on a vector of trivial type leaves the new elements
+ *  unwritten instead of zero-filling them.  Every other call, including
+ *  construct with arguments, goes to the wrapped allocator, e.g.
+ *
+ *    std::vector<char, valc::DefaultInitAllocator<valc::Mallocator<char>>>
+ */
+template <class Alloc>
+struct DefaultInitAllocator : Alloc {
+  using traits = std::allocator_traits<Alloc>;
+  typedef typename traits::value_type value_type;
+
+  template <class U>
+  struct rebind {
+    using other = DefaultInitAllocator<typename traits::template rebind_alloc<U>>;
+  };
+
+  DefaultInitAllocator() = default;
+  DefaultInitAllocator(Alloc const & al) noexcept : Alloc(al) {}
+  template <class A2>
+  DefaultInitAllocator(const DefaultInitAllocator <A2> & other) noexcept
+    : Alloc(static_cast<A2 const &>(other)) {}
+
+  template <class U>
+  void construct(U * pm) noexcept(std::is_nothrow_default_constructible_v<U>) {
+    ::new (static_cast<void *>(pm)) U;
+  }
+
+  template <class U, class... Args>
+  void construct(U * pm, Args &&... args) {
+    traits::construct(static_cast<Alloc &>(*this), pm, std::forward<Args>(args)...);
+  }
+};
+
+template <class A1, class A2>
+bool operator==(const DefaultInitAllocator <A1> & lhs, const DefaultInitAllocator <A2> & rhs) {
+  return static_cast<A1 const &>(lhs) == static_cast<A2 const &>(rhs);
+}
+
+template <class A1, class A2>
+bool operator!=(const DefaultInitAllocator <A1> & lhs, const DefaultInitAllocator <A2> & rhs) {
+  return static_cast<A1 const &>(lhs) != static_cast<A2 const &>(rhs);
+}
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace valc::arena
+/*
+ *  Thread-local bump (monotonic) arena.
+ *
+ *  Memory is carved from 64 KiB slabs obtained with std::malloc; an
+ *  allocation larger than a slab gets a slab of its own.  deallocate only
+ *  gives memory back when it is the most recent allocation, everything
+ *  else is reclaimed in O(1) when the enclosing arena::scope ends.  Scopes
+ *  nest; slabs are kept for reuse and returned to the system at thread exit.
+ *
+ *  Containers using ArenaAllocator must not outlive the scope they were
+ *  filled in.
+ */
+class arena {
+public:
+  static constexpr std::size_t slab_size = 64 * 1024;
+
+  struct marker {
+    std::size_t slab;
+    std::byte * top;
+    std::size_t used;
+  };
+
+  static arena & local() noexcept {
+    thread_local arena ar;
+    return ar;
+  }
+
+  void * allocate(std::size_t bytes, std::size_t align) {
+    auto aligned = align_up(top_, align);
+    if (top_ == nullptr || aligned + bytes > end_) {
+      next_slab(bytes + align);
+      aligned = align_up(top_, align);
+    }
+    last_ = { aligned, top_, };
+    used_ += static_cast<std::size_t>(aligned - top_) + bytes;
+    top_ = aligned + bytes;
+    high_water_ = std::max(high_water_, used_);
+    ++allocations_;
+    return aligned;
+  }
+
+  //  the most recent block goes back with the padding in front of it; a
+  //  block freed top-down behind it gets back its bytes alone.
+  void deallocate(void * pm, std::size_t bytes) noexcept {
+    auto const ptr = static_cast<std::byte *>(pm);
+    if (ptr + bytes == top_) {
+      auto const back = ptr == last_.block ? last_.top : ptr;
+      used_ -= static_cast<std::size_t>(top_ - back);
+      top_ = back;
+      last_ = {};
+    }
+  }
+
+  marker mark() const noexcept {
+    return { current_, top_, used_, };
+  }
+
+  void release(marker const & mk) noexcept {
+    current_ = mk.slab;
+    top_ = mk.top;
+    end_ = top_ == nullptr ? nullptr : slabs_[current_].base + slabs_[current_].size;
+    used_ = mk.used;
+    last_ = {};
+  }
+
+  std::size_t used() const noexcept { return used_; }
+  std::size_t high_water() const noexcept { return high_water_; }
+  std::size_t allocations() const noexcept { return allocations_; }
+
+  std::size_t reserved() const noexcept {
+    auto total = 0ul;
+    for (auto const & sl : slabs_) {
+      total += sl.size;
+    }
+    return total;
+  }
+
+  void reset_high_water() noexcept {
+    high_water_ = used_;
+    allocations_ = 0;
+  }
+
+  void report(std::ostream & os = std::cout) const {
+    os << "arena: used: "s << used_
+       << ", high water: "s << high_water_
+       << ", reserved: "s << reserved()
+       << " bytes in "s << slabs_.size() << " slabs, allocations: "s
+       << allocations_ << '\n';
+  }
+
+  //  RAII: everything allocated inside the scope is released when it ends.
+  class scope {
+  public:
+    scope() noexcept : ar_(local()), mk_(ar_.mark()) {}
+    ~scope() { ar_.release(mk_); }
+    scope(scope const &) = delete;
+    scope & operator=(scope const &) = delete;
+
+  private:
+    arena & ar_;
+    marker mk_;
+  };
+
+  ~arena() {
+    for (auto & sl : slabs_) {
+      std::free(sl.base);
+    }
+  }
+
+private:
+  struct slab {
+    std::byte * base;
+    std::size_t size;
+  };
+
+  //  the latest allocation and the top it was aligned up from.
+  struct latest {
+    std::byte * block { nullptr };
+    std::byte * top { nullptr };
+  };
+
+  arena() = default;
+
+  static std::byte * align_up(std::byte * ptr, std::size_t align) noexcept {
+    auto const addr = reinterpret_cast<std::uintptr_t>(ptr);
+    return ptr + ((align - addr % align) % align);
+  }
+
+  //  advance to the next retained slab if it is big enough, otherwise
+  //  insert a fresh one after the current slab.
+  void next_slab(std::size_t need) {
+    auto const next = top_ == nullptr ? 0ul : current_ + 1;
+    if (next >= slabs_.size() || slabs_[next].size < need) {
+      auto const size = std::max(slab_size, need);
+      auto base = static_cast<std::byte *>(std::malloc(size));
+      if (base == nullptr) {
+        throw std::bad_alloc();
+      }
+      slabs_.insert(slabs_.begin() + next, { base, size, });
+    }
+    current_ = next;
+    top_ = slabs_[current_].base;
+    end_ = top_ + slabs_[current_].size;
+  }
+
+  std::vector<slab> slabs_;
+  std::size_t current_ { 0 };
+  std::byte * top_ { nullptr };
+  std::byte * end_ { nullptr };
+  latest last_;
+  std::size_t used_ { 0 };
+  std::size_t high_water_ { 0 };
+  std::size_t allocations_ { 0 };
+};
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace valc::ArenaAllocator
+template <class T>
+struct ArenaAllocator {
+  typedef T value_type;
+
+  ArenaAllocator () = default;
+  template <class U>
+  constexpr ArenaAllocator(const ArenaAllocator <U> &) noexcept {}
+
+  [[nodiscard]]
+  T * allocate(std::size_t n_) {
+    if (n_ > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(arena::local().allocate(n_ * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T * pm, std::size_t n_) noexcept {
+    arena::local().deallocate(pm, n_ * sizeof(T));
+  }
+};
+
+//  all ArenaAllocators on a thread share that thread's arena.
+template <class T, class U>
+bool operator==(const ArenaAllocator <T> &, const ArenaAllocator <U> &) {
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator <T> &, const ArenaAllocator <U> &) {
+  return false;
+}
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace valc::pool
+/*
+ *  Size-class free-list pool.
+ *
+ *  Requests are rounded up to a power of two between 16 bytes and 1 MiB and
+ *  served from a per-thread free list for that class.  An empty thread list
+ *  is refilled with a batch of blocks from the central list; a thread list
+ *  that grows past cache_limit hands a batch back.  Only when both are empty
+ *  does a request reach std::malloc, and blocks are never returned to the
+ *  system before exit, so repeated grow/shrink cycles recycle the same
+ *  buffers.  Larger requests go straight to std::malloc/std::free.
+ */
+class pool {
+public:
+  static constexpr std::size_t min_shift = 4;     //  16 bytes
+  static constexpr std::size_t max_shift = 20;    //  1 MiB
+  static constexpr std::size_t classes = max_shift - min_shift + 1;
+  static constexpr std::size_t batch = 16;
+  static constexpr std::size_t cache_limit = 2 * batch;
+
+  //  per thread.
+  struct counters {
+    std::size_t hits;       //  served from the thread list
+    std::size_t refills;    //  served after a batch from the central list
+    std::size_t misses;     //  served by std::malloc
+    std::size_t oversize;   //  larger than the biggest class
+    std::size_t flushes;    //  batches handed back to the central list
+  };
+
+  static void * allocate(std::size_t bytes) {
+    auto & ch = cache::local();
+    auto const cls = size_class(bytes);
+    if (cls == classes) {
+      ++ch.cnt.oversize;
+      return checked(std::malloc(bytes));
+    }
+
+    auto & lst = ch.lists[cls];
+    if (lst.head != nullptr) {
+      ++ch.cnt.hits;
+      return lst.pop();
+    }
+    if (central::instance().take(cls, lst) != 0) {
+      ++ch.cnt.refills;
+      return lst.pop();
+    }
+    ++ch.cnt.misses;
+    return checked(std::malloc(class_bytes(cls)));
+  }
+
+  static void deallocate(void * pm, std::size_t bytes) noexcept {
+    if (pm == nullptr) {
+      return;
+    }
+    auto const cls = size_class(bytes);
+    if (cls == classes) {
+      std::free(pm);
+      return;
+    }
+
+    auto & ch = cache::local();
+    auto & lst = ch.lists[cls];
+    lst.push(static_cast<node *>(pm));
+    if (lst.count > cache_limit) {
+      central::instance().give(cls, lst, batch);
+      ++ch.cnt.flushes;
+    }
+  }
+
+  static counters const & stats() noexcept {
+    return cache::local().cnt;
+  }
+
+  static void reset_stats() noexcept {
+    cache::local().cnt = {};
+  }
+
+  static void report(std::ostream & os = std::cout) {
+    auto const & cnt = stats();
+    auto const pooled = cnt.hits + cnt.refills + cnt.misses;
+    auto const pct = [pooled](std::size_t nr) {
+      return pooled == 0 ? 0.0 : 100.0 * nr / pooled;
+    };
+    os << "pool: allocations: "s << pooled + cnt.oversize
+       << ", thread hits: "s << cnt.hits
+       << ", central refills: "s << cnt.refills
+       << ", misses: "s << cnt.misses
+       << ", oversize: "s << cnt.oversize
+       << ", flushes: "s << cnt.flushes << '\n'
+       << std::fixed << std::setprecision(1)
+       << "pool: thread cache hit rate: "s << pct(cnt.hits)
+       << "%, recycled: "s << pct(cnt.hits + cnt.refills) << "%\n"s
+       << std::defaultfloat;
+  }
+
+private:
+  struct node {
+    node * next;
+  };
+
+  struct list {
+    node * head { nullptr };
+    std::size_t count { 0 };
+
+    void push(node * nd) noexcept {
+      nd->next = head;
+      head = nd;
+      ++count;
+    }
+
+    node * pop() noexcept {
+      auto nd = head;
+      head = nd->next;
+      --count;
+      return nd;
+    }
+  };
+
+  static std::size_t size_class(std::size_t bytes) noexcept {
+    auto const shift = bytes <= (1ul << min_shift)
+                     ? min_shift
+                     : static_cast<std::size_t>(std::bit_width(bytes - 1));
+    return shift > max_shift ? classes : shift - min_shift;
+  }
+
+  static std::size_t class_bytes(std::size_t cls) noexcept {
+    return 1ul << (cls + min_shift);
+  }
+
+  static void * checked(void * pm) {
+    if (pm == nullptr) {
+      throw std::bad_alloc();
+    }
+    return pm;
+  }
+
+  class central {
+  public:
+    static central & instance() {
+      static central ct;
+      return ct;
+    }
+
+    //  move up to one batch into lst; returns the number moved.
+    std::size_t take(std::size_t cls, list & lst) {
+      std::lock_guard<std::mutex> lock(mtx_);
+      auto & src = lists_[cls];
+      auto moved = 0ul;
+      while (src.head != nullptr && moved < batch) {
+        lst.push(src.pop());
+        ++moved;
+      }
+      return moved;
+    }
+
+    //  move up to count blocks out of lst.
+    void give(std::size_t cls, list & lst, std::size_t count) noexcept {
+      std::lock_guard<std::mutex> lock(mtx_);
+      auto & dst = lists_[cls];
+      while (lst.head != nullptr && count-- > 0) {
+        dst.push(lst.pop());
+      }
+    }
+
+    ~central() {
+      for (auto & lst : lists_) {
+        while (lst.head != nullptr) {
+          std::free(lst.pop());
+        }
+      }
+    }
+
+  private:
+    central() = default;
+
+    std::mutex mtx_;
+    std::array<list, classes> lists_ {};
+  };
+
+  struct cache {
+    std::array<list, classes> lists {};
+    counters cnt {};
+
+    static cache & local() noexcept {
+      thread_local cache ch;
+      return ch;
+    }
+
+    //  make sure central outlives every thread cache.
+    cache() { central::instance(); }
+
+    ~cache() {
+      for (auto cls = 0ul; cls < classes; ++cls) {
+        central::instance().give(cls, lists[cls], lists[cls].count);
+      }
+    }
+  };
+};
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace valc::PoolAllocator
+template <class T>
+struct PoolAllocator {
+  typedef T value_type;
+  static_assert(alignof(T) <= alignof(std::max_align_t));
+
+  PoolAllocator () = default;
+  template <class U>
+  constexpr PoolAllocator(const PoolAllocator <U> &) noexcept {}
+
+  [[nodiscard]]
+  T * allocate(std::size_t n_) {
+    if (n_ > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(pool::allocate(n_ * sizeof(T)));
+  }
+
+  void deallocate(T * pm, std::size_t n_) noexcept {
+    pool::deallocate(pm, n_ * sizeof(T));
+  }
+};
+
+//  all PoolAllocators share the same size-class pool.
+template <class T, class U>
+bool operator==(const PoolAllocator <T> &, const PoolAllocator <U> &) {
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const PoolAllocator <T> &, const PoolAllocator <U> &) {
+  return false;
+}
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace valc::mapped
+/*
+ *  File-backed storage for vectors larger than RAM.  Every block is a file
+ *  of its own, mapped MAP_SHARED, so the kernel pages dirty memory out to
+ *  that file instead of to swap and the working size is bounded by disk.
+ *
+ *  A block is resized with ftruncate + mremap (Linux; elsewhere the new
+ *  size is mapped before the old mapping goes), which keeps the contents
+ *  without copying them.  A store creates its files unlinked in a directory
+ *  (the temp directory by default), so they vanish when unmapped.
+ *  advise() passes madvise hints; hugepage is only honoured where the file
+ *  system supports it.
+ *
+ *  store::persistent(path) keeps a vector's storage in the file at path:
+ *
+ *    - the first block maps the file as it is (nothing is truncated), at
+ *      least persisted() bytes, so a vector that reserves or
+ *      resize_for_overwrite()s persisted() / sizeof(T) elements first
+ *      reopens the data in place;
+ *    - while that block is live, new blocks go to named files beside it,
+ *      and when it is freed the newest live block is renamed onto path.
+ *      std::vector's allocate-copy-free growth therefore carries the file
+ *      along with the data; growth_vector grows the block in place;
+ *    - sync() writes a block back with msync and records the byte count,
+ *      and the file is cut to the count last synced when its block is
+ *      freed (a file never synced keeps its page-rounded size).
+ *
+ *  A vector that allocates less than persisted() before reading the file
+ *  loses the rest when it grows, since it only copies its own elements.
+ */
+#if defined(__unix__) || defined(__APPLE__)
+#define VALC_MAPPED 1
+
+namespace mapped {
+
+enum class advice : int { normal, sequential, random, willneed, hugepage, };
+
+class store {
+public:
+  explicit store(std::string dir = std::filesystem::temp_directory_path().string(),
+                 advice adv = advice::normal)
+    : dir_(std::move(dir)), advice_(adv) {}
+
+  //  the live block's storage is kept in the file at path.
+  static std::shared_ptr<store> persistent(std::string path, advice adv = advice::normal) {
+    auto dir = std::filesystem::path(path).parent_path();
+    auto st = std::make_shared<store>(dir.empty() ? "."s : dir.string(), adv);
+    std::error_code ec;
+    auto const size = std::filesystem::file_size(path, ec);
+    st->persisted_ = ec ? 0 : static_cast<std::size_t>(size);
+    st->path_ = std::move(path);
+    return st;
+  }
+
+  //  the store behind default-constructed MappedAllocators.
+  static std::shared_ptr<store> const & shared() {
+    static auto const st = std::make_shared<store>();
+    return st;
+  }
+
+  store(store const &) = delete;
+  store & operator=(store const &) = delete;
+
+  ~store() {
+    for (auto & [base, blk] : blocks_) {
+      release(blk);
+    }
+  }
+
+  //  bytes in the persistent file when the store was made.
+  std::size_t persisted() const noexcept { return persisted_; }
+
+  void * allocate(std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    block blk { -1, nullptr, round(bytes), false, keep, ++serial_, {}, };
+    auto const reopen = !path_.empty() && !path_busy_;
+    if (reopen) {
+      blk.fd = ::open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+      blk.named = true;
+    }
+    else if (!path_.empty()) {
+      blk.temp = path_ + ".XXXXXX";
+      blk.fd = ::mkstemp(blk.temp.data());
+    }
+    else {
+      blk.fd = temp_file();
+    }
+    if (blk.fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "valc::mapped: cannot create file");
+    }
+    struct stat st {};
+    if (reopen && ::fstat(blk.fd, &st) == 0 && st.st_size > 0) {
+      blk.bytes = std::max(blk.bytes, round(static_cast<std::size_t>(st.st_size)));
+      blk.synced = static_cast<std::size_t>(st.st_size);
+    }
+    if (::ftruncate(blk.fd, static_cast<off_t>(blk.bytes)) != 0) {
+      auto const err = errno;
+      discard(blk);
+      throw std::system_error(err, std::generic_category(), "valc::mapped: cannot size file");
+    }
+    blk.base = ::mmap(nullptr, blk.bytes, PROT_READ | PROT_WRITE, MAP_SHARED, blk.fd, 0);
+    if (blk.base == MAP_FAILED) {
+      discard(blk);
+      throw std::bad_alloc();
+    }
+    madvise(blk, advice_);
+    path_busy_ = path_busy_ || blk.named;
+    auto * const base = blk.base;
+    blocks_.emplace(base, std::move(blk));
+    return base;
+  }
+
+  //  the file grows before the mapping and shrinks after it, so no mapped
+  //  page is ever past the end of the file; on failure the block is as it was.
+  void * reallocate(void * pm, std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = blocks_.find(pm);
+    assert(it != blocks_.end());
+    auto const want = round(bytes);
+    auto const have = it->second.bytes;
+    if (want == have) {
+      return pm;
+    }
+    auto const fd = it->second.fd;
+    if (want > have && ::ftruncate(fd, static_cast<off_t>(want)) != 0) {
+      throw std::system_error(errno, std::generic_category(), "valc::mapped: cannot resize file");
+    }
+#if defined(__linux__)
+    auto * const base = ::mremap(pm, have, want, MREMAP_MAYMOVE);
+#else
+    auto * const base = ::mmap(nullptr, want, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base != MAP_FAILED) {
+      ::munmap(pm, have);
+    }
+#endif  /* defined(__linux__) */
+    if (base == MAP_FAILED) {
+      if (want > have) {
+        (void) ::ftruncate(fd, static_cast<off_t>(have));
+      }
+      throw std::bad_alloc();
+    }
+    if (want < have) {
+      //  failure only leaves the file longer than the mapping.
+      (void) ::ftruncate(fd, static_cast<off_t>(want));
+    }
+    auto node = blocks_.extract(it);
+    node.key() = base;
+    node.mapped().base = base;
+    node.mapped().bytes = want;
+    madvise(node.mapped(), advice_);
+    blocks_.insert(std::move(node));
+    return base;
+  }
+
+  void deallocate(void * pm) noexcept {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto node = blocks_.extract(pm);
+    assert(!node.empty());
+    auto & blk = node.mapped();
+    if (!blk.named) {
+      release(blk);
+      return;
+    }
+    //  hand the name on to the newest live block, which holds the data
+    //  when std::vector has just grown into it.
+    auto heir = blocks_.end();
+    for (auto it = blocks_.begin(); it != blocks_.end(); ++it) {
+      if (heir == blocks_.end() || it->second.serial > heir->second.serial) {
+        heir = it;
+      }
+    }
+    if (heir != blocks_.end() && ::rename(heir->second.temp.c_str(), path_.c_str()) == 0) {
+      heir->second.named = true;
+      heir->second.temp.clear();
+      blk.synced = keep;      //  the file is the heir's now.
+    }
+    else {
+      path_busy_ = false;
+    }
+    release(blk);
+  }
+
+  void advise(void * pm, advice adv) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (auto it = blocks_.find(pm); it != blocks_.end()) {
+      madvise(it->second, adv);
+    }
+  }
+
+  //  write the first bytes of the block back to its file; a persistent
+  //  file is cut to that length when the block is freed.
+  void sync(void * pm, std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = blocks_.find(pm);
+    if (it == blocks_.end()) {
+      return;
+    }
+    auto const count = std::min(bytes, it->second.bytes);
+    if (count != 0 && ::msync(pm, std::min(round(count), it->second.bytes), MS_SYNC) != 0) {
+      throw std::system_error(errno, std::generic_category(), "valc::mapped: msync");
+    }
+    it->second.synced = count;
+  }
+
+private:
+  static constexpr std::size_t keep = std::numeric_limits<std::size_t>::max();
+
+  struct block {
+    int fd;
+    void * base;
+    std::size_t bytes;
+    bool named;             //  the file at path_
+    std::size_t synced;     //  bytes the file is cut to when freed, or keep
+    std::uint64_t serial;   //  allocation order
+    std::string temp;       //  persistent store: this block's file until it is renamed
+  };
+
+  static std::size_t round(std::size_t bytes) noexcept {
+    static auto const page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return std::max(page, (bytes + page - 1) / page * page);
+  }
+
+  static void madvise(block const & blk, advice adv) noexcept {
+    int flag = MADV_NORMAL;
+    switch (adv) {
+      case advice::normal: flag = MADV_NORMAL; break;
+      case advice::sequential: flag = MADV_SEQUENTIAL; break;
+      case advice::random: flag = MADV_RANDOM; break;
+      case advice::willneed: flag = MADV_WILLNEED; break;
+      case advice::hugepage:
+#if defined(MADV_HUGEPAGE)
+        flag = MADV_HUGEPAGE;
+#endif  /* defined(MADV_HUGEPAGE) */
+        break;
+    }
+    //  only a hint: failure leaves the default behaviour.
+    ::madvise(blk.base, blk.bytes, flag);
+  }
+
+  //  a block that was never mapped.
+  static void discard(block const & blk) noexcept {
+    ::close(blk.fd);
+    if (!blk.temp.empty()) {
+      ::unlink(blk.temp.c_str());
+    }
+  }
+
+  static void release(block const & blk) noexcept {
+    ::munmap(blk.base, blk.bytes);
+    if (blk.named && blk.synced != keep) {
+      (void) ::ftruncate(blk.fd, static_cast<off_t>(blk.synced));
+    }
+    discard(blk);
+  }
+
+  int temp_file() const {
+#if defined(O_TMPFILE)
+    if (auto const fd = ::open(dir_.c_str(), O_TMPFILE | O_RDWR, 0600); fd >= 0) {
+      return fd;
+    }
+#endif  /* defined(O_TMPFILE) */
+    auto name = dir_ + "/valc_mapped_XXXXXX";
+    auto const fd = ::mkstemp(name.data());
+    if (fd >= 0) {
+      ::unlink(name.c_str());
+    }
+    return fd;
+  }
+
+  std::mutex mtx_;
+  std::map<void *, block> blocks_;
+  std::string dir_;
+  std::string path_;
+  std::size_t persisted_ = 0;
+  std::uint64_t serial_ = 0;
+  bool path_busy_ = false;
+  advice advice_;
+};
+
+} /* namespace mapped */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace valc::MappedAllocator
+//  copies and rebinds share one mapped::store.
+template <class T>
+struct MappedAllocator {
+  typedef T value_type;
+
+  MappedAllocator() : store_(mapped::store::shared()) {}
+  explicit MappedAllocator(std::shared_ptr<mapped::store> st) noexcept : store_(std::move(st)) {}
+  template <class U>
+  MappedAllocator(const MappedAllocator <U> & other) noexcept : store_(other.store_) {}
+
+  [[nodiscard]]
+  T * allocate(std::size_t n_) {
+    if (n_ > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(store_->allocate(n_ * sizeof(T)));
+  }
+
+  void deallocate(T * pm, std::size_t) noexcept {
+    store_->deallocate(pm);
+  }
+
+  //  resizes the backing file; the contents stay, usually at the same address.
+  [[nodiscard]]
+  T * reallocate(T * pm, std::size_t, std::size_t n_) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (n_ > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(store_->reallocate(pm, n_ * sizeof(T)));
+  }
+
+  //  pm is the vector's data().
+  void advise(T * pm, mapped::advice adv) const { store_->advise(pm, adv); }
+  void sync(T * pm, std::size_t n_) const { store_->sync(pm, n_ * sizeof(T)); }
+
+  std::shared_ptr<mapped::store> store_;
+};
+
+template <class T, class U>
+bool operator==(const MappedAllocator <T> & lhs, const MappedAllocator <U> & rhs) {
+  return lhs.store_ == rhs.store_;
+}
+
+template <class T, class U>
+bool operator!=(const MappedAllocator <T> & lhs, const MappedAllocator <U> & rhs) {
+  return lhs.store_ != rhs.store_;
+}
+#endif  /* defined(__unix__) || defined(__APPLE__) */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace valc::huge
+/*
+ *  Large-page, NUMA-placed memory for big vectors.  Blocks below the
+ *  policy threshold come from std::malloc, as in Mallocator.  Larger ones
+ *  are mapped directly, rounded up to 2 MiB:
+ *
+ *    1. MAP_HUGETLB, when the hugetlbfs pool has pages free;
+ *    2. otherwise a 2 MiB aligned anonymous mapping with
+ *       madvise(MADV_HUGEPAGE), for transparent huge pages;
+ *    3. otherwise (no THP) plain 4 KiB pages.
+ *
+ *  The mapping is then placed with mbind (called through syscall, so there
+ *  is no libnuma dependency): local node, one bound node, or interleaved
+ *  over all online nodes.  On a single node machine or a kernel without
+ *  mbind the placement step is skipped.  Nothing fails because a feature
+ *  is missing; report() says what each block got.
+ */
+#if defined(__unix__) || defined(__APPLE__)
+#define VALC_HUGE 1
+
+namespace huge {
+
+enum class numa : int { none, local, bind, interleave, };
+
+struct policy {
+  std::size_t threshold = 2ul << 20;
+  numa placement = numa::none;
+  int node = 0;
+};
+
+static constexpr std::size_t page = 2ul << 20;
+
+//  what a block ended up with.
+enum class kind : int { heap, hugetlb, thp, small_pages, };
+
+inline char const * name(kind kd) noexcept {
+  static char const * const names[] = { "malloc", "MAP_HUGETLB", "THP madvise", "4 KiB pages", };
+  return names[static_cast<int>(kd)];
+}
+
+//  online NUMA nodes, from sysfs; 1 where that is not available.
+inline int nodes() {
+  static int const count = []() {
+    std::ifstream is("/sys/devices/system/node/online");
+    std::string text;
+    if (!(is >> text)) {
+      return 1;
+    }
+    auto last = 0;
+    for (auto cur = text.c_str(); *cur != '\0'; ) {
+      char * end;
+      last = std::max(last, static_cast<int>(std::strtol(cur, &end, 10)));
+      cur = *end != '\0' ? end + 1 : end;
+    }
+    return last + 1;
+  }();
+  return count;
+}
+
+//  true when the pages were placed as asked.
+inline bool place(void * base, std::size_t bytes, policy const & pol) noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+  //  from <numaif.h>
+  enum { mpol_preferred = 1, mpol_bind = 2, mpol_interleave = 3, mpol_local = 4, };
+  unsigned long mask = 0;
+  int mode = mpol_local;
+  switch (pol.placement) {
+    case numa::none:
+      return true;
+    case numa::local:
+      mode = mpol_local;
+      break;
+    case numa::bind:
+      if (pol.node < 0 || pol.node >= nodes() || pol.node >= 64) {
+        return false;
+      }
+      mode = mpol_bind;
+      mask = 1ul << pol.node;
+      break;
+    case numa::interleave:
+      if (nodes() < 2) {
+        return false;
+      }
+      mode = mpol_interleave;
+      mask = nodes() >= 64 ? ~0ul : (1ul << nodes()) - 1;
+      break;
+  }
+  return ::syscall(SYS_mbind, base, bytes, mode, mode == mpol_local ? nullptr : &mask,
+                   mode == mpol_local ? 0ul : 65ul, 0u) == 0;
+#else
+  return pol.placement == numa::none;
+#endif  /* defined(__linux__) && defined(SYS_mbind) */
+}
+
+inline std::size_t round(std::size_t bytes) noexcept {
+  return (bytes + page - 1) / page * page;
+}
+
+struct block {
+  void * base;
+  kind got;
+  bool placed;
+};
+
+inline block map(std::size_t bytes, policy const & pol) {
+  auto const size = round(bytes);
+#if defined(MAP_HUGETLB)
+  if (auto * const base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      base != MAP_FAILED) {
+    return { base, kind::hugetlb, place(base, size, pol), };
+  }
+#endif  /* defined(MAP_HUGETLB) */
+  //  over-map by a page and trim, so the block starts on a 2 MiB boundary.
+  auto * const raw = static_cast<std::byte *>(::mmap(nullptr, size + page, PROT_READ | PROT_WRITE,
+                                                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  if (raw == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  auto const addr = reinterpret_cast<std::uintptr_t>(raw);
+  auto * const base = raw + ((page - addr % page) % page);
+  if (base != raw) {
+    ::munmap(raw, static_cast<std::size_t>(base - raw));
+  }
+  if (auto const tail = static_cast<std::size_t>(raw + size + page - (base + size)); tail != 0) {
+    ::munmap(base + size, tail);
+  }
+  auto got = kind::small_pages;
+#if defined(MADV_HUGEPAGE)
+  if (::madvise(base, size, MADV_HUGEPAGE) == 0) {
+    got = kind::thp;
+  }
+#endif  /* defined(MADV_HUGEPAGE) */
+  return { base, got, place(base, size, pol), };
+}
+
+inline void unmap(void * base, std::size_t bytes) noexcept {
+  ::munmap(base, round(bytes));
+}
+
+//  hugetlbfs pool, THP mode and node count, for the benchmark header.
+inline std::string describe() {
+  std::string pool = "?";
+  std::ifstream meminfo("/proc/meminfo");
+  for (std::string line; std::getline(meminfo, line); ) {
+    if (line.starts_with("HugePages_Free:")) {
+      pool = std::to_string(std::strtol(line.c_str() + 15, nullptr, 10));
+    }
+  }
+  std::string thp = "?";
+  std::ifstream enabled("/sys/kernel/mm/transparent_hugepage/enabled");
+  std::getline(enabled, thp);
+  return "hugetlb pages free: "s + pool + ", THP: "s + thp + ", NUMA nodes: "s
+       + std::to_string(nodes());
+}
+
+} /* namespace huge */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace valc::HugePageAllocator
+template <class T>
+struct HugePageAllocator {
+  typedef T value_type;
+
+  HugePageAllocator() = default;
+  explicit HugePageAllocator(huge::policy const & pol) noexcept : policy_(pol) {}
+  template <class U>
+  HugePageAllocator(const HugePageAllocator <U> & other) noexcept : policy_(other.policy_) {}
+
+  [[nodiscard]]
+  T * allocate(std::size_t n_) {
+    if (trace::streaming()) {
+      std::cout << "In: "s << __func__
+                << ", request size: "s << n_
+                << ", request typeid: "s << typeid(T).name()
+                << ", type size: "s << sizeof(T)
+                << ", bytes: " << n_ * sizeof(T)
+                << std::endl;
+    }
+    if (n_ > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+
+    auto const bytes = n_ * sizeof(T);
+    if (bytes < policy_.threshold) {
+      if (auto pm = static_cast<T *>(std::malloc(bytes))) {
+        report(pm, n_, { pm, huge::kind::heap, true, });
+        return pm;
+      }
+      throw std::bad_alloc();
+    }
+    auto const blk = huge::map(bytes, policy_);
+    auto * const pm = static_cast<T *>(blk.base);
+    report(pm, n_, blk);
+    return pm;
+  }
+
+  void deallocate(T * pm, std::size_t n_) noexcept {
+    if (trace::streaming()) {
+      std::cout << "In: "s << __func__ << std::endl;
+    }
+    auto const bytes = n_ * sizeof(T);
+    report(pm, n_, {}, false);
+    if (bytes < policy_.threshold) {
+      std::free(pm);
+    }
+    else {
+      huge::unmap(pm, bytes);
+    }
+  }
+
+  huge::policy policy_;
+
+private:
+  void report(T * pm, std::size_t n_, huge::block const & blk, bool alloc = true) const {
+    if (!trace::streaming()) {
+      trace::record(alloc ? trace::event_type::allocate : trace::event_type::deallocate,
+                    sizeof(T) * n_, pm, typeid(T).name());
+      return;
+    }
+    std::cout << "In: "s << __func__ << std::endl;
+    std::cout << (alloc ? "Alloc: "s : "Dealloc: "s) << sizeof(T) * n_
+              << " bytes at "s << std::hex << std::showbase
+              << reinterpret_cast<void*>(pm) << std::dec << std::noshowbase;
+    if (alloc) {
+      std::cout << " ("s << huge::name(blk.got)
+                << (policy_.placement != huge::numa::none && !blk.placed ? ", not placed"s : ""s)
+                << ')';
+    }
+    std::cout << '\n';
+  }
+};
+
+template <class T, class U>
+bool operator==(const HugePageAllocator <T> & lhs, const HugePageAllocator <U> & rhs) {
+  return lhs.policy_.threshold == rhs.policy_.threshold;
+}
+
+template <class T, class U>
+bool operator!=(const HugePageAllocator <T> & lhs, const HugePageAllocator <U> & rhs) {
+  return !(lhs == rhs);
+}
+#endif  /* defined(__unix__) || defined(__APPLE__) */
+
+} /* namespace valc */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  ================================================================================
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace perf
+/*
+ *  Section instrumentation.
+ *
+ *  A perf::section names the enclosing scope.  When the scope ends, the
+ *  counts seen on the calling thread are added to that name's row: cycles,
+ *  instructions, cache misses, branch misses and page faults from Linux
+ *  perf_event_open (user space only, which the default perf_event_paranoid
+ *  level allows), scaled when the kernel had to multiplex an event.  Each
+ *  event is opened on its own, so one the machine cannot count (no PMU in a
+ *  VM, a locked-down kernel, not Linux) only blanks its column; wall and CPU
+ *  time always come from clock_gettime.
+ *
+ *  perf::summary() prints a row per section in first-seen order; main()
+ *  calls it after the demonstrations.  Sections nest, and an outer row
+ *  includes the inner ones.
+ */
+namespace perf {
+
+enum counter : std::size_t {
+  cycles, instructions, cache_misses, branch_misses, page_faults, counter_count,
+};
+
+inline constexpr std::array<char const *, counter_count> counter_names {
+  "cycles", "instructions", "cache-misses", "branch-misses", "page-faults",
+};
+
+struct sample {
+  std::int64_t wall_ns;
+  std::int64_t cpu_ns;
+  std::array<std::uint64_t, counter_count> counts;
+
+  //  a multiplexed count is an estimate and may step back; clamp at zero.
+  sample operator-(sample const & rhs) const noexcept {
+    sample df { wall_ns - rhs.wall_ns, cpu_ns - rhs.cpu_ns, {}, };
+    for (auto ct = 0ul; ct < counter_count; ++ct) {
+      df.counts[ct] = counts[ct] > rhs.counts[ct] ? counts[ct] - rhs.counts[ct] : 0;
+    }
+    return df;
+  }
+};
+
+//  the calling thread's counters, opened on first use.
+class events {
+public:
+  static events & instance() {
+    thread_local events ev;
+    return ev;
+  }
+
+  events(events const &) = delete;
+  events & operator=(events const &) = delete;
+
+  bool available(counter ct) const noexcept {
+    return fds_[ct] >= 0;
+  }
+
+  sample read() const noexcept {
+    sample sm { now(clock_wall), now(clock_cpu), {}, };
+#if defined(__linux__)
+    for (auto ct = 0ul; ct < counter_count; ++ct) {
+      //  value, time enabled, time running
+      std::uint64_t buf[3] {};
+      if (fds_[ct] >= 0 && ::read(fds_[ct], buf, sizeof(buf)) == sizeof(buf)) {
+        sm.counts[ct] = buf[2] != 0 && buf[2] < buf[1]
+                      ? static_cast<std::uint64_t>(double(buf[0]) * buf[1] / buf[2])
+                      : buf[0];
+      }
+    }
+#endif  /* defined(__linux__) */
+    return sm;
+  }
+
+private:
+#if defined(__unix__) || defined(__APPLE__)
+  static constexpr clockid_t clock_wall = CLOCK_MONOTONIC;
+  static constexpr clockid_t clock_cpu = CLOCK_THREAD_CPUTIME_ID;
+
+  static std::int64_t now(clockid_t clk) noexcept {
+    timespec ts {};
+    ::clock_gettime(clk, &ts);
+    return std::int64_t(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+  }
+#else
+  static constexpr int clock_wall = 0;
+  static constexpr int clock_cpu = 1;
+
+  static std::int64_t now(int clk) noexcept {
+    if (clk == clock_cpu) {
+      return std::int64_t(double(std::clock()) * 1e9 / CLOCKS_PER_SEC);
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+#endif  /* defined(__unix__) || defined(__APPLE__) */
+
+#if defined(__linux__)
+  static int open(std::uint32_t type, std::uint64_t config) noexcept {
+    perf_event_attr attr {};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1,
+                                      PERF_FLAG_FD_CLOEXEC));
+  }
+
+  events() noexcept
+    : fds_ {
+        open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES),
+        open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS),
+        open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES),
+        open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES),
+        open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS),
+      } {
+  }
+
+  ~events() {
+    for (auto fd : fds_) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+  }
+#else
+  events() noexcept {
+    fds_.fill(-1);
+  }
+#endif  /* defined(__linux__) */
+
+  std::array<int, counter_count> fds_;
+};
+
+struct row {
+  std::string name;
+  std::uint64_t calls;
+  sample total;
+};
+
+class registry {
+public:
+  static registry & instance() {
+    static registry rg;
+    return rg;
+  }
+
+  void add(std::string const & name, sample const & delta) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto [it, inserted] = index_.try_emplace(name, rows_.size());
+    if (inserted) {
+      rows_.push_back({ name, 0, {}, });
+    }
+    auto & rw = rows_[it->second];
+    ++rw.calls;
+    rw.total.wall_ns += delta.wall_ns;
+    rw.total.cpu_ns += delta.cpu_ns;
+    for (auto ct = 0ul; ct < counter_count; ++ct) {
+      rw.total.counts[ct] += delta.counts[ct];
+    }
+  }
+
+  std::vector<row> rows() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return rows_;
+  }
+
+private:
+  registry() = default;
+
+  std::mutex mtx_;
+  std::vector<row> rows_;
+  std::unordered_map<std::string, std::size_t> index_;
+};
+
+class section {
+public:
+  explicit section(std::string name)
+    : name_(std::move(name)), start_(events::instance().read()) {
+  }
+
+  ~section() {
+    auto const delta = events::instance().read() - start_;
+    try {
+      registry::instance().add(name_, delta);
+    }
+    catch (...) {
+      //  losing a row is better than terminating from a destructor.
+    }
+  }
+
+  section(section const &) = delete;
+  section & operator=(section const &) = delete;
+
+private:
+  std::string name_;
+  sample start_;
+};
+
+inline void summary(std::ostream & os = std::cout) {
+  auto const rows = registry::instance().rows();
+  if (rows.empty()) {
+    return;
+  }
+  auto const & ev = events::instance();
+
+  os << "perf: per-section counters"s;
+  char const * sep = " (not available: ";
+  for (auto ct = 0ul; ct < counter_count; ++ct) {
+    if (!ev.available(counter(ct))) {
+      os << sep << counter_names[ct];
+      sep = ", ";
+    }
+  }
+  os << (*sep == ',' ? "; clock_gettime only)\n"s : "\n"s);
+
+  auto const flags = os.flags();
+  auto const prec = os.precision();
+  os << std::right << std::setw(10) << "wall ms"s << std::setw(10) << "cpu ms"s
+     << std::setw(14) << "cycles"s << std::setw(14) << "instructions"s
+     << std::setw(6) << "IPC"s << std::setw(13) << "cache-misses"s
+     << std::setw(14) << "branch-misses"s << std::setw(12) << "page-faults"s
+     << "  section\n"s;
+  auto cell = [&](std::size_t wd, counter ct, std::uint64_t val) {
+    if (ev.available(ct)) {
+      os << std::setw(wd) << val;
+    }
+    else {
+      os << std::setw(wd) << '-';
+    }
+  };
+  for (auto const & rw : rows) {
+    auto const & tl = rw.total;
+    os << std::fixed << std::setprecision(3)
+       << std::setw(10) << tl.wall_ns / 1e6 << std::setw(10) << tl.cpu_ns / 1e6;
+    cell(14, cycles, tl.counts[cycles]);
+    cell(14, instructions, tl.counts[instructions]);
+    if (ev.available(cycles) && ev.available(instructions) && tl.counts[cycles] != 0) {
+      os << std::setprecision(2) << std::setw(6)
+         << double(tl.counts[instructions]) / tl.counts[cycles];
+    }
+    else {
+      os << std::setw(6) << '-';
+    }
+    cell(13, cache_misses, tl.counts[cache_misses]);
+    cell(14, branch_misses, tl.counts[branch_misses]);
+    cell(12, page_faults, tl.counts[page_faults]);
+    os << "  "s << rw.name;
+    if (rw.calls > 1) {
+      os << " (x"s << rw.calls << ')';
+    }
+    os << '\n';
+  }
+  os.flags(flags);
+  os.precision(prec);
+}
+
+} /* namespace perf */
+
+#if (__cplusplus > 201707L)
+#endif  /* (__cplusplus > 201707L) */
+
+//  MARK: - Function Prototype.
+int C_vector(int argc, const char * argv[]);
+int C_vector_bool(int argc, const char * argv[]);
+int C_vector_bench(int argc, const char * argv[]);
+int C_vector_suite(int argc, const char * argv[]);
+
+//  MARK: - Implementation.
+/*
+ *  MARK: main()
+ */
+int main(int argc, const char * argv[]) {
+  //  --bench-json=-: stdout carries only the JSON, the rest goes to stderr.
+  if (std::any_of(argv + 1, argv + argc, [](char const * arg) {
+    return std::string_view(arg) == "--bench-json=-";
+  })) {
+    std::cout.rdbuf(std::cerr.rdbuf());
+  }
+
+  // insert code here...
+  std::cout << "CF.STL_Containers_Vector\n";
+  std::cout << "C++ Version: "s << __cplusplus << std::endl;
+
+  //  --alloc-stats[=file]: aggregate allocator calls, dump JSON at exit.
+  //  Tracing is switched off with it, so the calls pay no per-call output.
+  //  --trace=off|ring|stream: the tracing mode (default stream), after
+  //  --alloc-stats whatever the order.
+  auto trace_mode = std::optional<valc::trace::mode> {};
+  for (auto arg : std::span(argv + 1, argv + argc)) {
+    auto const opt = std::string_view(arg);
+    if (opt == "--alloc-stats" || opt.starts_with("--alloc-stats=")) {
+      auto const eq = opt.find('=');
+      valc::stats::dump_at_exit(eq == opt.npos ? "alloc_stats.json"s
+                                               : std::string(opt.substr(eq + 1)));
+      valc::stats::enable();
+      valc::trace::set_mode(valc::trace::mode::off);
+    }
+    else if (opt == "--trace=off") {
+      trace_mode = valc::trace::mode::off;
+    }
+    else if (opt == "--trace=ring") {
+      trace_mode = valc::trace::mode::ring;
+    }
+    else if (opt == "--trace=stream") {
+      trace_mode = valc::trace::mode::stream;
+    }
+  }
+  if (trace_mode) {
+    valc::trace::set_mode(*trace_mode);
+  }
+
+  //  run the benchmark suite instead of the demonstrations.
+  if (std::any_of(argv + 1, argv + argc, [](char const * arg) {
+    return std::string_view(arg) == "--bench-suite";
+  })) {
+    std::cout << '\n' << konst::dlm << std::endl;
+    return C_vector_suite(argc, argv);
+  }
+
+  //  run the benchmarks instead of the demonstrations.
+  if (std::any_of(argv + 1, argv + argc, [](char const * arg) {
+    return std::string_view(arg) == "--bench";
+  })) {
+    std::cout << '\n' << konst::dlm << std::endl;
+    return C_vector_bench(argc, argv);
+  }
+
+  std::cout << '\n' << konst::dlm << std::endl;
+  C_vector(argc, argv);
+
+  std::cout << '\n' << konst::dlm << std::endl;
+  C_vector_bool(argc, argv);
+
+  std::cout << '\n' << konst::dlm << std::endl;
+  perf::summary(std::cout);
+
+  return 0;
+}
+
+//  MARK: - C_vector
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  ================================================================================
+//  MARK: namespace vec
+namespace vec {
+template<typename T>
+std::ostream & operator<<(std::ostream & strm, const std::vector<T> & vec)
+{
+  strm.put('[');
+  char comma[3] = {'\0', ' ', '\0'};
+  for (auto const & el : vec) {
+    strm << comma << el;
+    comma[0] = ',';
+  }
+
+  return strm << ']';
+}
+
+} /* namespace vec */
+
+namespace vecpop {
+
+template<typename T>
+void print(T const & xs) {
+  std::cout << "[ "s;
+  for (auto const & x_ : xs) {
+    std::cout << x_ << ' ';
+  }
+  std::cout << "]\n"s;
+}
+
+} /* namespace vecpop */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecrsv
+namespace vecrsv {
+
+// minimal C++11 allocator with debug output; the output follows
+// valc::trace's stream mode and every call feeds valc::stats.
+template <class Tp>
+struct NAlloc {
+  typedef Tp value_type;
+
+  NAlloc() = default;
+
+  template <class T> NAlloc(const NAlloc<T> &) {
+    if (valc::trace::streaming()) {
+      std::cout << "In: "s << __func__ << std::endl;
+    }
+  }
+
+  Tp * allocate(std::size_t nv) {
+    if (valc::trace::streaming()) {
+      std::cout << "In: "s << __func__
+                << ", request size: "s << nv
+                << ", request typeid: "s << typeid(Tp).name()
+                << ", type size: "s << sizeof(Tp)
+                << ", bytes: " << nv * sizeof(Tp)
+                << std::endl;
+    }
+    nv *= sizeof(Tp);
+    Tp * p_typ = static_cast<Tp *>(::operator new(nv));
+    if (valc::trace::streaming()) {
+      std::cout << "allocating "s << nv
+                << " bytes at address "s << p_typ
+                << std::endl;
+    }
+    valc::stats::on_allocate(typeid(Tp).name(), p_typ, nv);
+    return p_typ;
+  }
+
+  void deallocate(Tp * p_typ, std::size_t nv) {
+    if (valc::trace::streaming()) {
+      std::cout << "In: "s << __func__ << std::endl;
+      std::cout << "deallocating "s << nv * sizeof * p_typ
+                << " bytes from address "s << p_typ
+                << std::endl;
+    }
+    valc::stats::on_deallocate(p_typ, nv * sizeof * p_typ);
+    ::operator delete(p_typ);
+  }
+};
+
+template <class T, class U>
+bool operator==(const NAlloc<T> &, const NAlloc<U> &) {
+  if (valc::trace::streaming()) {
+    std::cout << "In: "s << __func__ << std::endl;
+  }
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const NAlloc<T> &, const NAlloc<U> &) {
+  if (valc::trace::streaming()) {
+    std::cout << "In: "s << __func__ << std::endl;
+  }
+  return false;
+}
+
+} /* namespace vecrsv */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecswp
+namespace vecswp {
+
+template<class Os, class Co> Os & operator<<(Os & os, const Co& co) {
+  os << "{"s;
+  for (auto const & i : co) {
+    os << ' ' << i;
+  }
+  return os << " } "s;
+}
+
+} /* namespace vecswp */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecfmt
+/*
+ *  Buffered container printing in the three styles above:
+ *
+ *    style::vec     [1, 2, 3]        vec::operator<<
+ *    style::vecpop  [ 1 2 3 ]\n      vecpop::print
+ *    style::vecswp  { 1 2 3 }        vecswp::operator<<
+ *
+ *  A writer formats into a fixed 64 KiB buffer held in the object, so it
+ *  never allocates, and hands the buffer to the stream (one sputn) or FILE
+ *  (one fwrite) each time it fills.  Integers go through std::to_chars;
+ *  chars, bools and floating point print as an ostream with the same flags
+ *  would.  Other element types are formatted with operator<< on a scratch
+ *  stream, which does allocate.
+ */
+namespace vecfmt {
+
+enum class style : int { vec, vecpop, vecswp, };
+
+class writer {
+public:
+  static constexpr std::size_t capacity = 64 * 1024;
+
+  //  bools and floating point follow the stream's boolalpha and precision.
+  explicit writer(std::ostream & os) noexcept
+    : os_(&os), boolalpha_((os.flags() & std::ios::boolalpha) != 0),
+      precision_(static_cast<int>(os.precision())) {}
+  explicit writer(std::FILE * fp) noexcept : fp_(fp) {}
+
+  writer(writer const &) = delete;
+  writer & operator=(writer const &) = delete;
+
+  ~writer() { flush(); }
+
+  void flush() {
+    if (used_ != 0) {
+      if (os_ != nullptr) {
+        os_->rdbuf()->sputn(buf_.data(), static_cast<std::streamsize>(used_));
+      }
+      else {
+        std::fwrite(buf_.data(), 1, used_, fp_);
+      }
+      used_ = 0;
+    }
+  }
+
+  writer & operator<<(char ch) {
+    room(1);
+    buf_[used_++] = ch;
+    return *this;
+  }
+
+  writer & operator<<(std::string_view sv) {
+    while (!sv.empty()) {
+      room(1);
+      auto const part = std::min(sv.size(), capacity - used_);
+      std::memcpy(buf_.data() + used_, sv.data(), part);
+      used_ += part;
+      sv.remove_prefix(part);
+    }
+    return *this;
+  }
+
+  template <class T>
+  writer & operator<<(T const & val) {
+    if constexpr (std::is_same_v<T, bool>) {
+      if (boolalpha_) {
+        return *this << (val ? std::string_view("true") : std::string_view("false"));
+      }
+      return *this << (val ? '1' : '0');
+    }
+    else if constexpr (std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>) {
+      return *this << static_cast<char>(val);
+    }
+    else if constexpr (std::is_integral_v<T>) {
+      room(std::numeric_limits<T>::digits10 + 3);
+      used_ = static_cast<std::size_t>(std::to_chars(buf_.data() + used_, buf_.data() + capacity, val).ptr
+                                       - buf_.data());
+      return *this;
+    }
+    else if constexpr (std::is_floating_point_v<T>) {
+      room(64);
+      auto const res = std::to_chars(buf_.data() + used_, buf_.data() + capacity, val,
+                                     std::chars_format::general, precision_);
+      used_ = static_cast<std::size_t>(res.ptr - buf_.data());
+      return *this;
+    }
+    else if constexpr (std::is_convertible_v<T const &, std::string_view>) {
+      return *this << std::string_view(val);
+    }
+    else {
+      std::ostringstream os;
+      os << val;
+      return *this << std::string_view(os.str());
+    }
+  }
+
+private:
+  void room(std::size_t count) {
+    if (capacity - used_ < count) {
+      flush();
+    }
+  }
+
+  std::ostream * os_ = nullptr;
+  std::FILE * fp_ = nullptr;
+  bool boolalpha_ = false;
+  int precision_ = 6;
+  std::size_t used_ = 0;
+  std::array<char, capacity> buf_;
+};
+
+template <class Range>
+writer & print(writer & out, Range const & rg, style st = style::vec) {
+  switch (st) {
+    case style::vec: {
+      out << '[';
+      auto first = true;
+      for (auto const & el : rg) {
+        if (!first) {
+          out << std::string_view(", ");
+        }
+        out << el;
+        first = false;
+      }
+      return out << ']';
+    }
+    case style::vecpop:
+      out << std::string_view("[ ");
+      for (auto const & el : rg) {
+        out << el << ' ';
+      }
+      return out << std::string_view("]\n");
+    case style::vecswp:
+      out << '{';
+      for (auto const & el : rg) {
+        out << ' ' << el;
+      }
+      return out << std::string_view(" } ");
+  }
+  return out;
+}
+
+template <class Range>
+void print(std::ostream & os, Range const & rg, style st = style::vec) {
+  writer out(os);
+  print(out, rg, st);
+}
+
+} /* namespace vecfmt */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecgrw
+/*
+ *  growth_vector: a std::vector work-alike whose growth factor is a
+ *  template parameter.  A growth policy is any type with
+ *
+ *    static std::size_t next(std::size_t capacity, std::size_t needed);
+ *
+ *  returning the new capacity (at least needed).  When the allocator has a
+ *  reallocate(p, old_n, new_n) member, as valc::Mallocator does, and T is
+ *  trivially copyable, storage is grown and shrunk in place with realloc
+ *  instead of allocate/copy/deallocate.
+ */
+namespace vecgrw {
+
+template <std::size_t Num, std::size_t Den>
+struct growth_ratio {
+  static_assert(Num > Den && Den > 0);
+
+  static constexpr std::size_t next(std::size_t cap, std::size_t need) noexcept {
+    return std::max(need, std::max(cap * Num / Den, cap + 1));
+  }
+};
+
+using growth_2x = growth_ratio<2, 1>;
+using growth_1_5x = growth_ratio<3, 2>;
+
+template <class T, class Alloc = std::allocator<T>, class Growth = growth_2x>
+class growth_vector {
+  using traits = std::allocator_traits<Alloc>;
+
+  static constexpr bool in_place =
+    std::is_trivially_copyable_v<T> &&
+    requires(Alloc & al, T * pm, std::size_t nv) { al.reallocate(pm, nv, nv); };
+
+  //  value-initialising a trivial T is zeroing, unless the allocator
+  //  constructs for itself (DefaultInitAllocator does not zero).
+  static constexpr bool zero_fill =
+    std::is_trivial_v<T> && !requires(Alloc & al, T * pm) { al.construct(pm); };
+
+public:
+  using value_type = T;
+  using allocator_type = Alloc;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T &;
+  using const_reference = T const &;
+  using pointer = T *;
+  using const_pointer = T const *;
+  using iterator = T *;
+  using const_iterator = T const *;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  growth_vector() noexcept(noexcept(Alloc())) = default;
+  explicit growth_vector(Alloc const & al) noexcept : al_(al) {}
+
+  explicit growth_vector(size_type nv, Alloc const & al = Alloc()) : al_(al) {
+    resize(nv);
+  }
+
+  growth_vector(size_type nv, T const & val, Alloc const & al = Alloc()) : al_(al) {
+    resize(nv, val);
+  }
+
+  template <std::input_iterator It>
+  growth_vector(It first, It last, Alloc const & al = Alloc()) : al_(al) {
+    if constexpr (std::forward_iterator<It>) {
+      reserve(static_cast<size_type>(std::distance(first, last)));
+    }
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+  }
+
+  growth_vector(std::initializer_list<T> il, Alloc const & al = Alloc())
+    : growth_vector(il.begin(), il.end(), al) {}
+
+  growth_vector(growth_vector const & other)
+    : growth_vector(other.begin(), other.end(),
+                    traits::select_on_container_copy_construction(other.al_)) {}
+
+  growth_vector(growth_vector && other) noexcept
+    : al_(std::move(other.al_)),
+      first_(std::exchange(other.first_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      cap_(std::exchange(other.cap_, 0)) {}
+
+  growth_vector & operator=(growth_vector other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~growth_vector() {
+    clear();
+    release();
+  }
+
+  allocator_type get_allocator() const noexcept { return al_; }
+
+  /// Element access
+  reference operator[](size_type ix) noexcept { return first_[ix]; }
+  const_reference operator[](size_type ix) const noexcept { return first_[ix]; }
+
+  reference at(size_type ix) {
+    if (ix >= size_) {
+      throw std::out_of_range("vecgrw::growth_vector::at");
+    }
+    return first_[ix];
+  }
+
+  const_reference at(size_type ix) const {
+    return const_cast<growth_vector *>(this)->at(ix);
+  }
+
+  reference front() noexcept { return first_[0]; }
+  const_reference front() const noexcept { return first_[0]; }
+  reference back() noexcept { return first_[size_ - 1]; }
+  const_reference back() const noexcept { return first_[size_ - 1]; }
+  T * data() noexcept { return first_; }
+  T const * data() const noexcept { return first_; }
+
+  /// Iterators
+  iterator begin() noexcept { return first_; }
+  iterator end() noexcept { return first_ + size_; }
+  const_iterator begin() const noexcept { return first_; }
+  const_iterator end() const noexcept { return first_ + size_; }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+  /// Capacity
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  size_type capacity() const noexcept { return cap_; }
+  size_type max_size() const noexcept { return traits::max_size(al_); }
+
+  void reserve(size_type nv) {
+    if (nv > cap_) {
+      relocate(nv);
+    }
+  }
+
+  void shrink_to_fit() {
+    if (cap_ > size_) {
+      relocate(size_);
+    }
+  }
+
+  /// Modifiers
+  void clear() noexcept {
+    destroy(first_, first_ + size_);
+    size_ = 0;
+  }
+
+  template <class... Args>
+  reference emplace_back(Args &&... args) {
+    if (size_ == cap_) {
+      //  args may refer to an element that is about to move.
+      T tmp(std::forward<Args>(args)...);
+      relocate(Growth::next(cap_, size_ + 1));
+      traits::construct(al_, first_ + size_, std::move(tmp));
+    }
+    else {
+      traits::construct(al_, first_ + size_, std::forward<Args>(args)...);
+    }
+    return first_[size_++];
+  }
+
+  void push_back(T const & val) { emplace_back(val); }
+  void push_back(T && val) { emplace_back(std::move(val)); }
+
+  void pop_back() noexcept {
+    traits::destroy(al_, first_ + --size_);
+  }
+
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args &&... args) {
+    auto const ix = static_cast<size_type>(pos - first_);
+    emplace_back(std::forward<Args>(args)...);
+    std::rotate(first_ + ix, first_ + size_ - 1, first_ + size_);
+    return first_ + ix;
+  }
+
+  iterator insert(const_iterator pos, T const & val) { return emplace(pos, val); }
+  iterator insert(const_iterator pos, T && val) { return emplace(pos, std::move(val)); }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    auto const dst = first_ + (first - first_);
+    auto const src = first_ + (last - first_);
+    auto const tail = std::move(src, end(), dst);
+    destroy(tail, end());
+    size_ = static_cast<size_type>(tail - first_);
+    return dst;
+  }
+
+  /// Bulk append: storage grows at most once per call.  The source must
+  /// not alias the vector's own elements.
+  template <std::input_iterator It>
+  void append(It first, It last) {
+    if constexpr (std::forward_iterator<It>) {
+      auto const count = static_cast<size_type>(std::distance(first, last));
+      grow_for(count);
+      if constexpr (std::contiguous_iterator<It>
+                    && std::is_same_v<std::iter_value_t<It>, T>
+                    && std::is_trivially_copyable_v<T>) {
+        if (count != 0) {
+          std::memcpy(first_ + size_, std::to_address(first), count * sizeof(T));
+        }
+        size_ += count;
+      }
+      else {
+        for (; first != last; ++first, ++size_) {
+          traits::construct(al_, first_ + size_, *first);
+        }
+      }
+    }
+    else {
+      for (; first != last; ++first) {
+        emplace_back(*first);
+      }
+    }
+  }
+
+  template <std::ranges::input_range Range>
+  void append_range(Range && rg) {
+    append(std::ranges::begin(rg), std::ranges::end(rg));
+  }
+
+  void append(std::initializer_list<T> il) {
+    append(il.begin(), il.end());
+  }
+
+  //  construct count elements from fn(index) or fn().  If fn throws, the
+  //  elements already constructed stay.
+  template <class Fn>
+  void append_n(size_type count, Fn && fn) {
+    grow_for(count);
+    auto const start = size_;
+    for (; size_ != start + count; ++size_) {
+      if constexpr (std::is_invocable_v<Fn &, size_type>) {
+        traits::construct(al_, first_ + size_, fn(size_ - start));
+      }
+      else {
+        traits::construct(al_, first_ + size_, fn());
+      }
+    }
+  }
+
+  void resize(size_type nv) {
+    if constexpr (zero_fill) {
+      if (nv > size_) {
+        reserve(nv);
+        std::uninitialized_value_construct_n(first_ + size_, nv - size_);
+        size_ = nv;
+        return;
+      }
+    }
+    resize_with(nv, [this](T * pm) { traits::construct(al_, pm); });
+  }
+
+  void resize(size_type nv, T const & val) {
+    resize_with(nv, [this, cp = val](T * pm) { traits::construct(al_, pm, cp); });
+  }
+
+  //  like resize, but new elements are default-initialised: for trivial T
+  //  they are left unwritten, for the caller to overwrite.
+  void resize_for_overwrite(size_type nv) {
+    if constexpr (std::is_trivially_default_constructible_v<T>
+                  && std::is_trivially_destructible_v<T>) {
+      reserve(nv);
+      size_ = nv;
+    }
+    else {
+      resize_with(nv, [](T * pm) { ::new (static_cast<void *>(pm)) T; });
+    }
+  }
+
+  void swap(growth_vector & other) noexcept {
+    using std::swap;
+    swap(al_, other.al_);
+    swap(first_, other.first_);
+    swap(size_, other.size_);
+    swap(cap_, other.cap_);
+  }
+
+  friend void swap(growth_vector & lhs, growth_vector & rhs) noexcept {
+    lhs.swap(rhs);
+  }
+
+  friend bool operator==(growth_vector const & lhs, growth_vector const & rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+  friend auto operator<=>(growth_vector const & lhs, growth_vector const & rhs) {
+    return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(),
+                                                  rhs.begin(), rhs.end());
+  }
+
+private:
+  void grow_for(size_type count) {
+    if (size_ + count > cap_) {
+      relocate(Growth::next(cap_, size_ + count));
+    }
+  }
+
+  //  new elements go up to a local end and size_ is stored once: a char
+  //  element store could alias size_ and keep the loop from vectorising.
+  template <class Fn>
+  void resize_with(size_type nv, Fn && construct) {
+    if (nv < size_) {
+      destroy(first_ + nv, first_ + size_);
+      size_ = nv;
+      return;
+    }
+    reserve(nv);
+    auto const first = first_ + size_;
+    auto const last = first_ + nv;
+    auto pm = first;
+    try {
+      for (; pm != last; ++pm) {
+        construct(pm);
+      }
+    }
+    catch (...) {
+      destroy(first, pm);
+      throw;
+    }
+    size_ = nv;
+  }
+
+  void destroy(T * first, T * last) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (; first != last; ++first) {
+        traits::destroy(al_, first);
+      }
+    }
+  }
+
+  void release() noexcept {
+    if (first_ != nullptr) {
+      traits::deallocate(al_, first_, cap_);
+      first_ = nullptr;
+      cap_ = 0;
+    }
+  }
+
+  //  move the elements into storage for exactly nv elements (nv >= size_).
+  void relocate(size_type nv) {
+    if (nv > max_size()) {
+      throw std::length_error("vecgrw::growth_vector");
+    }
+    if (nv == 0) {
+      release();
+      return;
+    }
+    if constexpr (in_place) {
+      if (first_ != nullptr) {
+        first_ = al_.reallocate(first_, cap_, nv);
+        cap_ = nv;
+        return;
+      }
+    }
+
+    auto const fresh = traits::allocate(al_, nv);
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (size_ != 0) {
+        std::memcpy(fresh, first_, size_ * sizeof(T));
+      }
+    }
+    else {
+      auto done = 0ul;
+      try {
+        for (; done < size_; ++done) {
+          traits::construct(al_, fresh + done, std::move_if_noexcept(first_[done]));
+        }
+      }
+      catch (...) {
+        destroy(fresh, fresh + done);
+        traits::deallocate(al_, fresh, nv);
+        throw;
+      }
+      destroy(first_, first_ + size_);
+    }
+    release();
+    first_ = fresh;
+    cap_ = nv;
+  }
+
+  [[no_unique_address]] Alloc al_ {};
+  T * first_ { nullptr };
+  size_type size_ { 0 };
+  size_type cap_ { 0 };
+};
+
+} /* namespace vecgrw */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecsbo
+/*
+ *  small_vector<T, N, Alloc>: a std::vector work-alike that keeps up to N
+ *  elements in an inline buffer and only goes to the allocator when it
+ *  grows past N.  shrink_to_fit moves the elements back inline when they
+ *  fit.  Move assignment and swap steal a heap buffer when the allocator
+ *  propagates (it then moves along with the buffer) or the two allocators
+ *  compare equal; otherwise the elements move one by one.
+ */
+namespace vecsbo {
+
+template <class T, std::size_t N, class Alloc = std::allocator<T>>
+class small_vector {
+  static_assert(N > 0);
+  using traits = std::allocator_traits<Alloc>;
+
+  //  as in growth_vector: value-initialising a trivial T is zeroing.
+  static constexpr bool zero_fill =
+    std::is_trivial_v<T> && !requires(Alloc & al, T * pm) { al.construct(pm); };
+
+public:
+  using value_type = T;
+  using allocator_type = Alloc;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T &;
+  using const_reference = T const &;
+  using pointer = T *;
+  using const_pointer = T const *;
+  using iterator = T *;
+  using const_iterator = T const *;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  static constexpr size_type inline_capacity = N;
+
+  small_vector() noexcept {}
+  explicit small_vector(Alloc const & al) noexcept : al_(al) {}
+
+  explicit small_vector(size_type nv, Alloc const & al = Alloc()) : al_(al) {
+    resize(nv);
+  }
+
+  small_vector(size_type nv, T const & val, Alloc const & al = Alloc()) : al_(al) {
+    resize(nv, val);
+  }
+
+  template <std::input_iterator It>
+  small_vector(It first, It last, Alloc const & al = Alloc()) : al_(al) {
+    append(first, last);
+  }
+
+  small_vector(std::initializer_list<T> il, Alloc const & al = Alloc())
+    : small_vector(il.begin(), il.end(), al) {}
+
+  small_vector(small_vector const & other)
+    : small_vector(other.begin(), other.end(),
+                   traits::select_on_container_copy_construction(other.al_)) {}
+
+  small_vector(small_vector && other)
+    noexcept(std::is_nothrow_move_constructible_v<T>) : al_(other.al_) {
+    take(other);
+  }
+
+  small_vector & operator=(small_vector const & other) {
+    if (this != &other) {
+      assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  small_vector & operator=(small_vector && other)
+    noexcept(std::is_nothrow_move_constructible_v<T>
+             && (traits::propagate_on_container_move_assignment::value
+                 || traits::is_always_equal::value)) {
+    if (this != &other) {
+      replace<traits::propagate_on_container_move_assignment::value>(other);
+    }
+    return *this;
+  }
+
+  small_vector & operator=(std::initializer_list<T> il) {
+    assign(il);
+    return *this;
+  }
+
+  ~small_vector() {
+    clear();
+    release();
+  }
+
+  void assign(size_type nv, T const & val) {
+    T cp(val);
+    clear();
+    resize(nv, cp);
+  }
+
+  template <std::input_iterator It>
+  void assign(It first, It last) {
+    clear();
+    append(first, last);
+  }
+
+  void assign(std::initializer_list<T> il) {
+    assign(il.begin(), il.end());
+  }
+
+  allocator_type get_allocator() const noexcept { return al_; }
+
+  /// Element access
+  reference operator[](size_type ix) noexcept { return first_[ix]; }
+  const_reference operator[](size_type ix) const noexcept { return first_[ix]; }
+
+  reference at(size_type ix) {
+    if (ix >= size_) {
+      throw std::out_of_range("vecsbo::small_vector::at");
+    }
+    return first_[ix];
+  }
+
+  const_reference at(size_type ix) const {
+    return const_cast<small_vector *>(this)->at(ix);
+  }
+
+  reference front() noexcept { return first_[0]; }
+  const_reference front() const noexcept { return first_[0]; }
+  reference back() noexcept { return first_[size_ - 1]; }
+  const_reference back() const noexcept { return first_[size_ - 1]; }
+  T * data() noexcept { return first_; }
+  T const * data() const noexcept { return first_; }
+
+  /// Iterators
+  iterator begin() noexcept { return first_; }
+  iterator end() noexcept { return first_ + size_; }
+  const_iterator begin() const noexcept { return first_; }
+  const_iterator end() const noexcept { return first_ + size_; }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+  /// Capacity
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  size_type capacity() const noexcept { return cap_; }
+  size_type max_size() const noexcept { return traits::max_size(al_); }
+  bool is_inline() const noexcept { return first_ == buffer(); }
+
+  void reserve(size_type nv) {
+    if (nv > cap_) {
+      relocate(nv);
+    }
+  }
+
+  void shrink_to_fit() {
+    if (!is_inline() && cap_ > size_) {
+      relocate(std::max(size_, N));
+    }
+  }
+
+  /// Modifiers
+  void clear() noexcept {
+    destroy(first_, first_ + size_);
+    size_ = 0;
+  }
+
+  template <class... Args>
+  reference emplace_back(Args &&... args) {
+    if (size_ == cap_) {
+      //  args may refer to an element that is about to move.
+      T tmp(std::forward<Args>(args)...);
+      relocate(next_capacity(size_ + 1));
+      traits::construct(al_, first_ + size_, std::move(tmp));
+    }
+    else {
+      traits::construct(al_, first_ + size_, std::forward<Args>(args)...);
+    }
+    return first_[size_++];
+  }
+
+  void push_back(T const & val) { emplace_back(val); }
+  void push_back(T && val) { emplace_back(std::move(val)); }
+
+  void pop_back() noexcept {
+    traits::destroy(al_, first_ + --size_);
+  }
+
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args &&... args) {
+    auto const ix = index(pos);
+    emplace_back(std::forward<Args>(args)...);
+    std::rotate(first_ + ix, first_ + size_ - 1, first_ + size_);
+    return first_ + ix;
+  }
+
+  iterator insert(const_iterator pos, T const & val) { return emplace(pos, val); }
+  iterator insert(const_iterator pos, T && val) { return emplace(pos, std::move(val)); }
+
+  iterator insert(const_iterator pos, size_type nv, T const & val) {
+    auto const ix = index(pos);
+    auto const old = size_;
+    T cp(val);
+    grow(size_ + nv);
+    for (auto nn = 0ul; nn < nv; ++nn) {
+      traits::construct(al_, first_ + size_, cp);
+      ++size_;
+    }
+    std::rotate(first_ + ix, first_ + old, first_ + size_);
+    return first_ + ix;
+  }
+
+  template <std::input_iterator It>
+  iterator insert(const_iterator pos, It first, It last) {
+    auto const ix = index(pos);
+    auto const old = size_;
+    append(first, last);
+    std::rotate(first_ + ix, first_ + old, first_ + size_);
+    return first_ + ix;
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<T> il) {
+    return insert(pos, il.begin(), il.end());
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    auto const dst = first_ + index(first);
+    if (first == last) {
+      return dst;
+    }
+    auto const tail = std::move(first_ + index(last), end(), dst);
+    destroy(tail, end());
+    size_ = static_cast<size_type>(tail - first_);
+    return dst;
+  }
+
+  void resize(size_type nv) {
+    if constexpr (zero_fill) {
+      if (nv > size_) {
+        reserve(nv);
+        std::uninitialized_value_construct_n(first_ + size_, nv - size_);
+        size_ = nv;
+        return;
+      }
+    }
+    resize_with(nv, [this](T * pm) { traits::construct(al_, pm); });
+  }
+
+  void resize(size_type nv, T const & val) {
+    resize_with(nv, [this, cp = val](T * pm) { traits::construct(al_, pm, cp); });
+  }
+
+  void swap(small_vector & other)
+    noexcept(std::is_nothrow_move_constructible_v<T>
+             && (traits::propagate_on_container_swap::value
+                 || traits::is_always_equal::value)) {
+    small_vector tmp(std::move(other));
+    other.replace<traits::propagate_on_container_swap::value>(*this);
+    replace<traits::propagate_on_container_swap::value>(tmp);
+  }
+
+  friend void swap(small_vector & lhs, small_vector & rhs)
+    noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+  }
+
+  friend bool operator==(small_vector const & lhs, small_vector const & rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+  friend auto operator<=>(small_vector const & lhs, small_vector const & rhs) {
+    return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(),
+                                                  rhs.begin(), rhs.end());
+  }
+
+private:
+  T * buffer() noexcept { return reinterpret_cast<T *>(inline_); }
+  T const * buffer() const noexcept { return reinterpret_cast<T const *>(inline_); }
+
+  size_type index(const_iterator pos) const noexcept {
+    return static_cast<size_type>(pos - first_);
+  }
+
+  size_type next_capacity(size_type need) const noexcept {
+    return std::max(need, 2 * cap_);
+  }
+
+  void grow(size_type need) {
+    if (need > cap_) {
+      relocate(next_capacity(need));
+    }
+  }
+
+  template <class It>
+  void append(It first, It last) {
+    if constexpr (std::forward_iterator<It>) {
+      grow(size_ + static_cast<size_type>(std::distance(first, last)));
+    }
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+  }
+
+  //  new elements go up to a local end and size_ is stored once: a char
+  //  element store could alias size_ and keep the loop from vectorising.
+  template <class Fn>
+  void resize_with(size_type nv, Fn && construct) {
+    if (nv < size_) {
+      destroy(first_ + nv, first_ + size_);
+      size_ = nv;
+      return;
+    }
+    reserve(nv);
+    auto const first = first_ + size_;
+    auto const last = first_ + nv;
+    auto pm = first;
+    try {
+      for (; pm != last; ++pm) {
+        construct(pm);
+      }
+    }
+    catch (...) {
+      destroy(first, pm);
+      throw;
+    }
+    size_ = nv;
+  }
+
+  void destroy(T * first, T * last) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (; first != last; ++first) {
+        traits::destroy(al_, first);
+      }
+    }
+  }
+
+  //  give back the heap buffer, if any; the object is then inline and empty.
+  void release() noexcept {
+    if (!is_inline()) {
+      traits::deallocate(al_, first_, cap_);
+      first_ = buffer();
+      cap_ = N;
+    }
+  }
+
+  //  move construct the elements of src into dst.
+  void move_elements(T * src, T * dst, size_type count) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (count != 0) {
+        std::memcpy(dst, src, count * sizeof(T));
+      }
+    }
+    else {
+      auto done = 0ul;
+      try {
+        for (; done < count; ++done) {
+          traits::construct(al_, dst + done, std::move_if_noexcept(src[done]));
+        }
+      }
+      catch (...) {
+        destroy(dst, dst + done);
+        throw;
+      }
+      destroy(src, src + count);
+    }
+  }
+
+  //  *this is empty and inline; steal other's heap buffer or move its
+  //  inline elements, leaving other empty.
+  void take(small_vector & other) {
+    if (!other.is_inline()) {
+      first_ = std::exchange(other.first_, other.buffer());
+      cap_ = std::exchange(other.cap_, N);
+      size_ = std::exchange(other.size_, 0);
+      return;
+    }
+    move_elements(other.first_, first_, other.size_);
+    size_ = std::exchange(other.size_, 0);
+  }
+
+  //  drop the elements and take src's, leaving src empty.  A heap buffer
+  //  is only stolen when it can be freed through al_ afterwards: the
+  //  allocator propagates with it, or the two compare equal.
+  template <bool Propagate>
+  void replace(small_vector & src) {
+    clear();
+    if (Propagate || traits::is_always_equal::value || al_ == src.al_) {
+      release();
+      if constexpr (Propagate) {
+        al_ = src.al_;
+      }
+      take(src);
+      return;
+    }
+    reserve(src.size_);
+    move_elements(src.first_, first_, src.size_);
+    size_ = std::exchange(src.size_, 0);
+  }
+
+  //  move the elements into storage for nv elements (nv >= size_); inline
+  //  when nv <= N.
+  void relocate(size_type nv) {
+    if (nv > max_size()) {
+      throw std::length_error("vecsbo::small_vector");
+    }
+    auto const to_inline = nv <= N;
+    if (to_inline && is_inline()) {
+      return;
+    }
+    auto const fresh = to_inline ? buffer() : traits::allocate(al_, nv);
+    try {
+      move_elements(first_, fresh, size_);
+    }
+    catch (...) {
+      if (!to_inline) {
+        traits::deallocate(al_, fresh, nv);
+      }
+      throw;
+    }
+    if (!is_inline()) {
+      traits::deallocate(al_, first_, cap_);
+    }
+    first_ = fresh;
+    cap_ = to_inline ? N : nv;
+  }
+
+  [[no_unique_address]] Alloc al_ {};
+  T * first_ { buffer() };
+  size_type size_ { 0 };
+  size_type cap_ { N };
+  alignas(T) std::byte inline_[N * sizeof(T)];
+};
+
+template <class T, std::size_t N, class Alloc, class U>
+typename small_vector<T, N, Alloc>::size_type
+erase(small_vector<T, N, Alloc> & sv, U const & val) {
+  auto const it = std::remove(sv.begin(), sv.end(), val);
+  auto const count = static_cast<std::size_t>(sv.end() - it);
+  sv.erase(it, sv.end());
+  return count;
+}
+
+template <class T, std::size_t N, class Alloc, class Pred>
+typename small_vector<T, N, Alloc>::size_type
+erase_if(small_vector<T, N, Alloc> & sv, Pred pred) {
+  auto const it = std::remove_if(sv.begin(), sv.end(), pred);
+  auto const count = static_cast<std::size_t>(sv.end() - it);
+  sv.erase(it, sv.end());
+  return count;
+}
+
+} /* namespace vecsbo */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecapp
+/*
+ *  Bulk append for any vector type.  Containers with their own append
+ *  members (vecgrw::growth_vector) construct straight into uninitialised
+ *  storage; std::vector and the rest reserve once and then insert, which
+ *  for trivial types is a single memmove.
+ *
+ *  append_from parses whitespace separated integers from a stream: the
+ *  text is read into memory, the tokens are counted, the vector grows once,
+ *  and each value is parsed with std::from_chars straight into place.
+ *  Parsing stops at the first bad token, which sets failbit.  A seekable
+ *  stream (file, string) reports what is left, so the text buffer is sized
+ *  once and filled with one read; a pipe or terminal cannot, and its text
+ *  is read in 64 KiB blocks into a buffer that grows geometrically.
+ */
+namespace vecapp {
+
+template <class Vec>
+concept has_append = requires(Vec & vec, typename Vec::value_type const * ptr) {
+  vec.append(ptr, ptr);
+};
+
+//  room for count more elements, growing geometrically.
+template <class Vec>
+void reserve_more(Vec & vec, std::size_t count) {
+  auto const need = vec.size() + count;
+  if (need > vec.capacity()) {
+    vec.reserve(std::max(need, 2 * vec.capacity()));
+  }
+}
+
+template <class Vec, std::input_iterator It>
+void append(Vec & vec, It first, It last) {
+  if constexpr (has_append<Vec>) {
+    vec.append(first, last);
+  }
+  else {
+    if constexpr (std::forward_iterator<It>) {
+      reserve_more(vec, static_cast<std::size_t>(std::distance(first, last)));
+    }
+    vec.insert(vec.end(), first, last);
+  }
+}
+
+template <class Vec, std::ranges::input_range Range>
+void append(Vec & vec, Range && rg) {
+  append(vec, std::ranges::begin(rg), std::ranges::end(rg));
+}
+
+template <class Vec, class Fn>
+void append_n(Vec & vec, std::size_t count, Fn && fn) {
+  if constexpr (has_append<Vec>) {
+    vec.append_n(count, std::forward<Fn>(fn));
+  }
+  else {
+    reserve_more(vec, count);
+    for (auto ix = 0ul; ix < count; ++ix) {
+      if constexpr (std::is_invocable_v<Fn &, std::size_t>) {
+        vec.emplace_back(fn(ix));
+      }
+      else {
+        vec.emplace_back(fn());
+      }
+    }
+  }
+}
+
+//  bytes left in a seekable stream, or 0 when it cannot tell.
+inline std::size_t remaining(std::istream & is) {
+  auto const here = is.tellg();
+  if (here == std::istream::pos_type(-1)) {
+    return 0;
+  }
+  is.seekg(0, std::ios::end);
+  auto const there = is.fail() ? here : is.tellg();
+  is.clear();
+  is.seekg(here);
+  return there > here ? static_cast<std::size_t>(there - here) : 0;
+}
+
+inline bool is_blank(char ch) noexcept {
+  return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r' || ch == '\v' || ch == '\f';
+}
+
+//  returns the number of values appended.
+template <class Vec>
+std::size_t append_from(Vec & vec, std::istream & is) {
+  using T = typename Vec::value_type;
+  static_assert(std::is_integral_v<T>);
+
+  std::string text;
+  if (auto const left = remaining(is); left != 0) {
+    text.resize(left);
+    is.read(text.data(), static_cast<std::streamsize>(left));
+    text.resize(static_cast<std::size_t>(is.gcount()));
+  }
+  std::array<char, 64 * 1024> block;
+  while (is.read(block.data(), block.size()) || is.gcount() > 0) {
+    text.append(block.data(), static_cast<std::size_t>(is.gcount()));
+  }
+  is.clear(is.rdstate() & ~std::ios::failbit);
+
+  auto tokens(0ul);
+  auto blank = true;
+  for (auto const ch : text) {
+    auto const bl = is_blank(ch);
+    tokens += blank && !bl;
+    blank = bl;
+  }
+
+  auto const before = vec.size();
+  char const * cur = text.data();
+  char const * const end = text.data() + text.size();
+  struct bad_token {};
+  try {
+    append_n(vec, tokens, [&cur, end]() {
+      for (; cur != end && is_blank(*cur); ++cur) {}
+      T val {};
+      auto const [ptr, ec] = std::from_chars(cur, end, val);
+      if (ec != std::errc() || (ptr != end && !is_blank(*ptr))) {
+        throw bad_token {};
+      }
+      cur = ptr;
+      return val;
+    });
+  }
+  catch (bad_token const &) {
+    is.setstate(std::ios::failbit);
+  }
+  return vec.size() - before;
+}
+
+} /* namespace vecapp */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecers
+/*
+ *  Stream compaction: vecers::erase_if(vec, pred) does what std::erase_if
+ *  does, returning the erased count, for any contiguous vector.  For
+ *  trivially copyable 1, 2, 4 and 8 byte elements the predicate is run over
+ *  a block of elements into keep masks, then a kernel packs the kept
+ *  elements down in place:
+ *
+ *    AVX-512   vpcompressd/q, and vpcompressb/w where VBMI2 is present
+ *    AVX2      vpermd/pshufb with index tables looked up by lane mask
+ *    portable  a branch-free copy that advances the output on keep
+ *
+ *  The output never passes the input, so a full-width store only overwrites
+ *  elements that have already been loaded.  Other element types fall back
+ *  to std::remove_if.
+ */
+namespace vecers {
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VECERS_X86 1
+#define VECERS_AVX2 __attribute__((target("avx2,popcnt")))
+#define VECERS_AVX512 __attribute__((target("avx512f,popcnt")))
+#define VECERS_VBMI2 __attribute__((target("avx512f,avx512bw,avx512vbmi2,popcnt")))
+#endif  /* defined(__x86_64__) || defined(__i386__) */
+
+using word = std::uint64_t;
+
+//  elements per predicate pass; a multiple of every kernel's lane count.
+static constexpr std::size_t block = 512;
+
+enum class isa : int { portable, avx2, avx512, avx512_vbmi2, };
+
+inline isa detect() noexcept {
+#if defined(VECERS_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512vbmi2") && __builtin_cpu_supports("avx512bw")) {
+    return isa::avx512_vbmi2;
+  }
+  if (__builtin_cpu_supports("avx512f")) {
+    return isa::avx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return isa::avx2;
+  }
+#endif  /* defined(VECERS_X86) */
+  return isa::portable;
+}
+
+inline isa const active = detect();
+
+inline char const * name(isa is = active) noexcept {
+  static char const * const names[] = { "portable", "avx2", "avx512", "avx512+vbmi2", };
+  return names[static_cast<int>(is)];
+}
+
+template <class T>
+concept compactable = std::is_trivially_copyable_v<T>
+  && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+template <std::size_t Size>
+using lane_type = std::conditional_t<Size == 1, std::uint8_t,
+                  std::conditional_t<Size == 2, std::uint16_t,
+                  std::conditional_t<Size == 4, std::uint32_t, std::uint64_t>>>;
+
+inline word lanes(word const * keep, std::size_t ix, std::size_t width) noexcept {
+  return (keep[ix / 64] >> (ix % 64)) & (width == 64 ? ~word(0) : (word(1) << width) - 1);
+}
+
+//  the kernels pack the elements of in[0, count) whose keep bit is set down
+//  to out and return how many they wrote; out <= in.  The SIMD kernels take
+//  a count that is a multiple of 64.
+template <class T>
+inline std::size_t portable_compress(T * out, T const * in, word const * keep,
+                                     std::size_t count) noexcept {
+  auto kept(0ul);
+  for (auto ix = 0ul; ix < count; ++ix) {
+    out[kept] = in[ix];
+    kept += (keep[ix / 64] >> (ix % 64)) & 1;
+  }
+  return kept;
+}
+
+#if defined(VECERS_X86)
+//  pshufb byte indices: for each 8 lane mask, the kept byte lanes in order.
+inline constexpr auto shuffle8 = []() {
+  std::array<std::uint64_t, 256> tbl {};
+  for (auto mask = 0u; mask < 256; ++mask) {
+    for (auto lane = 0u, kept = 0u; lane < 8; ++lane) {
+      if (mask >> lane & 1) {
+        tbl[mask] |= std::uint64_t(lane) << (8 * kept++);
+      }
+    }
+  }
+  return tbl;
+}();
+
+//  pshufb byte indices for eight 16-bit lanes.
+inline constexpr auto shuffle16 = []() {
+  std::array<std::array<std::uint8_t, 16>, 256> tbl {};
+  for (auto mask = 0u; mask < 256; ++mask) {
+    for (auto lane = 0u, kept = 0u; lane < 8; ++lane) {
+      if (mask >> lane & 1) {
+        tbl[mask][2 * kept] = static_cast<std::uint8_t>(2 * lane);
+        tbl[mask][2 * kept + 1] = static_cast<std::uint8_t>(2 * lane + 1);
+        ++kept;
+      }
+    }
+  }
+  return tbl;
+}();
+
+//  vpermd indices packed a nibble per lane: eight 32-bit lanes, and four
+//  64-bit lanes as pairs of 32-bit ones.
+inline constexpr auto permute32 = []() {
+  std::array<std::uint32_t, 256> tbl {};
+  for (auto mask = 0u; mask < 256; ++mask) {
+    for (auto lane = 0u, kept = 0u; lane < 8; ++lane) {
+      if (mask >> lane & 1) {
+        tbl[mask] |= lane << (4 * kept++);
+      }
+    }
+  }
+  return tbl;
+}();
+
+inline constexpr auto permute64 = []() {
+  std::array<std::uint32_t, 16> tbl {};
+  for (auto mask = 0u; mask < 16; ++mask) {
+    for (auto lane = 0u, kept = 0u; lane < 4; ++lane) {
+      if (mask >> lane & 1) {
+        tbl[mask] |= (2 * lane) << (8 * kept) | (2 * lane + 1) << (8 * kept + 4);
+        ++kept;
+      }
+    }
+  }
+  return tbl;
+}();
+
+template <class U>
+VECERS_AVX2
+inline std::size_t avx2_compress(U * out, U const * in, word const * keep,
+                                 std::size_t count) noexcept {
+  auto * const first = out;
+  if constexpr (sizeof(U) == 1) {
+    for (auto ix = 0ul; ix < count; ix += 8) {
+      auto const mask = lanes(keep, ix, 8);
+      auto const blk = _mm_loadl_epi64(reinterpret_cast<__m128i const *>(in + ix));
+      auto const idx = _mm_loadl_epi64(reinterpret_cast<__m128i const *>(&shuffle8[mask]));
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_shuffle_epi8(blk, idx));
+      out += std::popcount(mask);
+    }
+  }
+  if constexpr (sizeof(U) == 2) {
+    for (auto ix = 0ul; ix < count; ix += 8) {
+      auto const mask = lanes(keep, ix, 8);
+      auto const blk = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + ix));
+      auto const idx = _mm_loadu_si128(reinterpret_cast<__m128i const *>(shuffle16[mask].data()));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_shuffle_epi8(blk, idx));
+      out += std::popcount(mask);
+    }
+  }
+  if constexpr (sizeof(U) >= 4) {
+    auto constexpr width = 32 / sizeof(U);
+    auto const shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+    for (auto ix = 0ul; ix < count; ix += width) {
+      auto const mask = lanes(keep, ix, width);
+      auto const packed = sizeof(U) == 4 ? permute32[mask] : permute64[mask];
+      auto const idx = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(packed)),
+                                                          shifts), _mm256_set1_epi32(7));
+      auto const blk = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(in + ix));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_permutevar8x32_epi32(blk, idx));
+      out += std::popcount(mask);
+    }
+  }
+  return static_cast<std::size_t>(out - first);
+}
+
+template <class U>
+VECERS_AVX512
+inline std::size_t avx512_compress(U * out, U const * in, word const * keep,
+                                   std::size_t count) noexcept {
+  static_assert(sizeof(U) >= 4);
+  auto constexpr width = 64 / sizeof(U);
+  auto * const first = out;
+  for (auto ix = 0ul; ix < count; ix += width) {
+    auto const mask = lanes(keep, ix, width);
+    auto const blk = _mm512_loadu_si512(in + ix);
+    if constexpr (sizeof(U) == 4) {
+      _mm512_storeu_si512(out, _mm512_maskz_compress_epi32(static_cast<__mmask16>(mask), blk));
+    }
+    else {
+      _mm512_storeu_si512(out, _mm512_maskz_compress_epi64(static_cast<__mmask8>(mask), blk));
+    }
+    out += std::popcount(mask);
+  }
+  return static_cast<std::size_t>(out - first);
+}
+
+template <class U>
+VECERS_VBMI2
+inline std::size_t vbmi2_compress(U * out, U const * in, word const * keep,
+                                  std::size_t count) noexcept {
+  static_assert(sizeof(U) <= 2);
+  auto constexpr width = 64 / sizeof(U);
+  auto * const first = out;
+  for (auto ix = 0ul; ix < count; ix += width) {
+    auto const mask = lanes(keep, ix, width);
+    auto const blk = _mm512_loadu_si512(in + ix);
+    if constexpr (sizeof(U) == 1) {
+      _mm512_storeu_si512(out, _mm512_maskz_compress_epi8(static_cast<__mmask64>(mask), blk));
+    }
+    else {
+      _mm512_storeu_si512(out, _mm512_maskz_compress_epi16(static_cast<__mmask32>(mask), blk));
+    }
+    out += std::popcount(mask);
+  }
+  return static_cast<std::size_t>(out - first);
+}
+#endif  /* defined(VECERS_X86) */
+
+//  the SIMD kernels see T as same-sized integer lanes and only touch them
+//  through the vector load/store intrinsics, which may alias anything; the
+//  scalar fallback copies T as T.
+template <class T>
+inline std::size_t compress(T * out, T const * in, word const * keep, std::size_t count) noexcept {
+#if defined(VECERS_X86)
+  using U = lane_type<sizeof(T)>;
+  auto * const lout = reinterpret_cast<U *>(out);
+  auto const * const lin = reinterpret_cast<U const *>(in);
+  if constexpr (sizeof(T) <= 2) {
+    if (active == isa::avx512_vbmi2) {
+      return vbmi2_compress(lout, lin, keep, count);
+    }
+  }
+  else {
+    if (active >= isa::avx512) {
+      return avx512_compress(lout, lin, keep, count);
+    }
+  }
+  if (active >= isa::avx2) {
+    return avx2_compress(lout, lin, keep, count);
+  }
+#endif  /* defined(VECERS_X86) */
+  return portable_compress(out, in, keep, count);
+}
+
+template <class Vec, class Pred>
+typename Vec::size_type erase_if(Vec & vec, Pred pred) {
+  using T = typename Vec::value_type;
+  if constexpr (compactable<T> && std::ranges::contiguous_range<Vec>) {
+    T * const data = std::ranges::data(vec);
+    auto const size = static_cast<std::size_t>(vec.size());
+    std::array<word, block / 64> keep;
+    auto out(0ul);
+    for (auto ix = 0ul; ix < size; ix += block) {
+      auto const count = std::min(block, size - ix);
+      auto kept(0ul);
+      for (auto wx = 0ul; wx * 64 < count; ++wx) {
+        auto const end = std::min(count, wx * 64 + 64);
+        word bits {};
+        for (auto jx = wx * 64; jx < end; ++jx) {
+          bits |= word(!pred(data[ix + jx])) << (jx % 64);
+        }
+        keep[wx] = bits;
+        kept += static_cast<std::size_t>(std::popcount(bits));
+      }
+      //  nothing erased so far or in this block: it stays where it is.
+      if (out == ix && kept == count) {
+        out += count;
+        continue;
+      }
+      auto const full = count - count % 64;
+      auto const packed = full == 0 ? 0ul
+        : compress(data + out, data + ix, keep.data(), full);
+      portable_compress(data + out + packed, data + ix + full, keep.data() + full / 64, count - full);
+      out += kept;
+    }
+    vec.erase(vec.begin() + static_cast<typename Vec::difference_type>(out), vec.end());
+    return size - out;
+  }
+  else {
+    auto const it = std::remove_if(vec.begin(), vec.end(), pred);
+    auto const count = static_cast<typename Vec::size_type>(vec.end() - it);
+    vec.erase(it, vec.end());
+    return count;
+  }
+}
+
+} /* namespace vecers */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecpar
+/*
+ *  Parallel algorithms over any contiguous vector (std::vector<T, Alloc>,
+ *  vecgrw::growth_vector, ...) on a small work-stealing pool: for_each,
+ *  reduce, inclusive_scan, exclusive_scan and sort.
+ *
+ *  pool(n) runs n - 1 worker threads; the thread calling parallel_for is
+ *  the n-th and runs tasks too until its batch is done, so nested calls
+ *  from inside a task cannot deadlock.  Each thread has its own task
+ *  queue: it takes from the back of its own and steals from the front of
+ *  the others.
+ *
+ *  sort sorts one run per thread, then merges runs pairwise; every merge
+ *  round is cut into equal output pieces by co-ranking (merge path), so
+ *  all threads stay busy through the final merge.
+ */
+namespace vecpar {
+
+class pool {
+public:
+  explicit pool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+    : queues_(std::max(threads, std::size_t(1))) {
+    for (auto ix = 1ul; ix < queues_.size(); ++ix) {
+      workers_.emplace_back([this, ix]() { work(ix); });
+    }
+  }
+
+  pool(pool const &) = delete;
+  pool & operator=(pool const &) = delete;
+
+  ~pool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto & th : workers_) {
+      th.join();
+    }
+  }
+
+  std::size_t size() const noexcept { return queues_.size(); }
+
+  //  calls fn(ix) for ix in [0, count), in parallel; rethrows the first
+  //  exception a call throws once all calls have finished.
+  template <class Fn>
+  void parallel_for(std::size_t count, Fn && fn) {
+    if (count == 0) {
+      return;
+    }
+    batch bt {
+      &fn,
+      [](void * ctx, std::size_t ix) { (*static_cast<std::remove_reference_t<Fn> *>(ctx))(ix); },
+    };
+    bt.remaining.store(count, std::memory_order_relaxed);
+
+    auto const home = self_ == this ? index_ : 0ul;
+    for (auto ix = 0ul; ix < count; ++ix) {
+      auto & qu = queues_[(home + ix) % queues_.size()];
+      std::lock_guard<std::mutex> lock(qu.mtx);
+      qu.tasks.push_back({ &bt, ix, });
+    }
+    queued_.fetch_add(count, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lock(sleep_);
+    }
+    wake_.notify_all();
+
+    while (bt.remaining.load(std::memory_order_acquire) != 0) {
+      if (!run_one(home)) {
+        std::this_thread::yield();
+      }
+    }
+    if (bt.error) {
+      std::rethrow_exception(bt.error);
+    }
+  }
+
+private:
+  struct batch {
+    void * ctx { nullptr };
+    void (* call)(void *, std::size_t) { nullptr };
+    std::atomic<std::size_t> remaining {};
+    std::once_flag failed {};
+    std::exception_ptr error {};
+  };
+
+  struct task {
+    batch * bt;
+    std::size_t ix;
+  };
+
+  struct queue {
+    std::mutex mtx;
+    std::deque<task> tasks;
+  };
+
+  //  own queue from the back, then the others from the front.
+  bool run_one(std::size_t home) {
+    std::optional<task> tk;
+    for (auto nq = 0ul; nq < queues_.size() && !tk; ++nq) {
+      auto & qu = queues_[(home + nq) % queues_.size()];
+      std::lock_guard<std::mutex> lock(qu.mtx);
+      if (!qu.tasks.empty()) {
+        if (nq == 0) {
+          tk = qu.tasks.back();
+          qu.tasks.pop_back();
+        }
+        else {
+          tk = qu.tasks.front();
+          qu.tasks.pop_front();
+        }
+      }
+    }
+    if (!tk) {
+      return false;
+    }
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    auto * const bt = tk->bt;
+    try {
+      bt->call(bt->ctx, tk->ix);
+    }
+    catch (...) {
+      std::call_once(bt->failed, [bt]() { bt->error = std::current_exception(); });
+    }
+    //  the batch may be gone as soon as this reaches zero.
+    bt->remaining.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+  }
+
+  void work(std::size_t ix) {
+    self_ = this;
+    index_ = ix;
+    for (;;) {
+      if (run_one(ix)) {
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_);
+      wake_.wait(lock, [this]() {
+        return stop_ || queued_.load(std::memory_order_acquire) != 0;
+      });
+      if (stop_) {
+        return;
+      }
+    }
+  }
+
+  std::vector<queue> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<std::size_t> queued_ {};
+  std::mutex sleep_;
+  std::condition_variable wake_;
+  bool stop_ = false;
+
+  inline static thread_local pool * self_ = nullptr;
+  inline static thread_local std::size_t index_ = 0;
+};
+
+//  below this many elements the algorithms run on the calling thread.
+static constexpr std::size_t serial_cutoff = 1ul << 14;
+
+//  a few chunks per thread, none smaller than the serial cutoff.
+inline std::size_t chunks(pool const & pl, std::size_t size) noexcept {
+  return std::max(std::size_t(1), std::min(4 * pl.size(), size / serial_cutoff));
+}
+
+inline std::size_t bound(std::size_t size, std::size_t chunk, std::size_t count) noexcept {
+  return size / count * chunk + size % count * chunk / count;
+}
+
+template <class Vec, class Fn>
+void for_each(pool & pl, Vec & vec, Fn fn) {
+  auto * const data = std::ranges::data(vec);
+  auto const size = std::ranges::size(vec);
+  auto const count = chunks(pl, size);
+  pl.parallel_for(count, [&](std::size_t ch) {
+    std::for_each(data + bound(size, ch, count), data + bound(size, ch + 1, count), fn);
+  });
+}
+
+template <class Vec, class T, class Op = std::plus<>>
+T reduce(pool & pl, Vec const & vec, T init, Op op = {}) {
+  auto const * const data = std::ranges::data(vec);
+  auto const size = std::ranges::size(vec);
+  auto const count = chunks(pl, size);
+  std::vector<std::optional<T>> part(count);
+  pl.parallel_for(count, [&](std::size_t ch) {
+    auto const * first = data + bound(size, ch, count);
+    auto const * const last = data + bound(size, ch + 1, count);
+    if (first != last) {
+      T acc = *first;
+      while (++first != last) {
+        acc = op(std::move(acc), *first);
+      }
+      part[ch] = std::move(acc);
+    }
+  });
+  for (auto & pt : part) {
+    if (pt) {
+      init = op(std::move(init), std::move(*pt));
+    }
+  }
+  return init;
+}
+
+//  out is resized to in.size(); it may be the same vector as in.
+template <class Vec, class Out, class Op = std::plus<>>
+void inclusive_scan(pool & pl, Vec const & in, Out & out, Op op = {}) {
+  using T = typename Out::value_type;
+  auto const size = std::ranges::size(in);
+  out.resize(size);
+  if (size == 0) {
+    return;
+  }
+  auto const * const src = std::ranges::data(in);
+  auto * const dst = std::ranges::data(out);
+  auto const count = chunks(pl, size);
+  std::vector<T> carry(count);
+  pl.parallel_for(count, [&](std::size_t ch) {
+    carry[ch] = std::reduce(src + bound(size, ch, count) + 1, src + bound(size, ch + 1, count),
+                            T(src[bound(size, ch, count)]), op);
+  });
+  for (auto ch = 1ul; ch < count; ++ch) {
+    carry[ch] = op(carry[ch - 1], carry[ch]);
+  }
+  pl.parallel_for(count, [&](std::size_t ch) {
+    auto const first = bound(size, ch, count);
+    auto const last = bound(size, ch + 1, count);
+    if (ch == 0) {
+      std::inclusive_scan(src + first, src + last, dst + first, op);
+    }
+    else {
+      std::inclusive_scan(src + first, src + last, dst + first, op, carry[ch - 1]);
+    }
+  });
+}
+
+template <class Vec, class Out, class T, class Op = std::plus<>>
+void exclusive_scan(pool & pl, Vec const & in, Out & out, T init, Op op = {}) {
+  auto const size = std::ranges::size(in);
+  out.resize(size);
+  if (size == 0) {
+    return;
+  }
+  auto const * const src = std::ranges::data(in);
+  auto * const dst = std::ranges::data(out);
+  auto const count = chunks(pl, size);
+  std::vector<T> carry(count + 1);
+  carry[0] = init;
+  pl.parallel_for(count, [&](std::size_t ch) {
+    carry[ch + 1] = std::reduce(src + bound(size, ch, count) + 1, src + bound(size, ch + 1, count),
+                                T(src[bound(size, ch, count)]), op);
+  });
+  for (auto ch = 1ul; ch <= count; ++ch) {
+    carry[ch] = op(carry[ch - 1], carry[ch]);
+  }
+  pl.parallel_for(count, [&](std::size_t ch) {
+    auto const first = bound(size, ch, count);
+    std::exclusive_scan(src + first, src + bound(size, ch + 1, count), dst + first, carry[ch], op);
+  });
+}
+
+//  how many of the first k merged elements of a[0, na) and b[0, nb) come
+//  from a; ties go to a first, as with std::merge.
+template <class T, class Cmp>
+std::size_t corank(std::size_t k, T const * a, std::size_t na, T const * b, std::size_t nb,
+                   Cmp & cmp) {
+  auto lo = k > nb ? k - nb : 0ul;
+  auto hi = std::min(k, na);
+  while (lo < hi) {
+    auto const mid = lo + (hi - lo) / 2;
+    if (cmp(b[k - mid - 1], a[mid])) {
+      hi = mid;
+    }
+    else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+
+template <class Vec, class Cmp = std::less<>>
+void sort(pool & pl, Vec & vec, Cmp cmp = {}) {
+  using T = typename Vec::value_type;
+  auto * const data = std::ranges::data(vec);
+  auto const size = std::ranges::size(vec);
+  if (pl.size() == 1 || size < 2 * serial_cutoff) {
+    std::sort(data, data + size, cmp);
+    return;
+  }
+
+  auto const runs = std::bit_ceil(std::min(pl.size(), size / serial_cutoff));
+  pl.parallel_for(runs, [&](std::size_t rn) {
+    std::sort(data + bound(size, rn, runs), data + bound(size, rn + 1, runs), cmp);
+  });
+
+  //  raw scratch from the vector's allocator, not a value-initialised
+  //  vector.  The merges overwrite a trivially copyable T as it is; any
+  //  other T is move-constructed into the scratch chunk by chunk first, and
+  //  the merges then start from the scratch and go back into data.
+  using alloc_traits = typename std::allocator_traits<typename Vec::allocator_type>
+                         ::template rebind_traits<T>;
+  struct buffer {
+    typename alloc_traits::allocator_type al;
+    T * first;
+    std::size_t size;
+    std::vector<std::uint8_t> built {};   //  per chunk, when T isn't trivial
+
+    ~buffer() {
+      for (auto ch = 0ul; ch < built.size(); ++ch) {
+        if (built[ch] != 0) {
+          std::destroy(first + bound(size, ch, built.size()),
+                       first + bound(size, ch + 1, built.size()));
+        }
+      }
+      alloc_traits::deallocate(al, first, size);
+    }
+  };
+  typename alloc_traits::allocator_type al(vec.get_allocator());
+  buffer scratch { al, alloc_traits::allocate(al, size), size, };
+  T * src = data;
+  T * dst = scratch.first;
+  if constexpr (!std::is_trivially_copyable_v<T>) {
+    auto const count = chunks(pl, size);
+    scratch.built.resize(count);
+    pl.parallel_for(count, [&](std::size_t ch) {
+      std::uninitialized_move(data + bound(size, ch, count), data + bound(size, ch + 1, count),
+                              scratch.first + bound(size, ch, count));
+      scratch.built[ch] = 1;
+    });
+    std::swap(src, dst);
+  }
+  auto const pieces = 4 * pl.size();
+  std::vector<std::size_t> split;
+  for (auto width = 1ul; width < runs; width *= 2) {
+    auto const pairs = runs / (2 * width);
+    auto const per_pair = std::max(std::size_t(1), pieces / pairs);
+    auto const run = [&](std::size_t pr, std::size_t rn) {
+      return bound(size, 2 * width * pr + rn * width, runs);
+    };
+    auto const piece = [&](std::size_t pr, std::size_t pc) {
+      return bound(run(pr, 2) - run(pr, 0), pc, per_pair);
+    };
+    //  all the cuts are found before any element is moved from.
+    split.resize(pairs * (per_pair + 1));
+    pl.parallel_for(split.size(), [&](std::size_t tk) {
+      auto const pr = tk / (per_pair + 1);
+      auto const base = run(pr, 0);
+      auto const mid = run(pr, 1);
+      split[tk] = corank(piece(pr, tk % (per_pair + 1)), src + base, mid - base,
+                         src + mid, run(pr, 2) - mid, cmp);
+    });
+    pl.parallel_for(pairs * per_pair, [&](std::size_t tk) {
+      auto const pr = tk / per_pair;
+      auto const pc = tk % per_pair;
+      auto const base = run(pr, 0);
+      auto const mid = run(pr, 1);
+      auto const k0 = piece(pr, pc);
+      auto const k1 = piece(pr, pc + 1);
+      auto const i0 = split[pr * (per_pair + 1) + pc];
+      auto const i1 = split[pr * (per_pair + 1) + pc + 1];
+      std::merge(std::make_move_iterator(src + base + i0), std::make_move_iterator(src + base + i1),
+                 std::make_move_iterator(src + mid + (k0 - i0)),
+                 std::make_move_iterator(src + mid + (k1 - i1)), dst + base + k0, cmp);
+    });
+    std::swap(src, dst);
+  }
+  if (src != data) {
+    auto const count = chunks(pl, size);
+    pl.parallel_for(count, [&](std::size_t ch) {
+      std::move(src + bound(size, ch, count), src + bound(size, ch + 1, count),
+                data + bound(size, ch, count));
+    });
+  }
+}
+
+} /* namespace vecpar */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace veccmp
+/*
+ *  Lexicographic comparison of contiguous vectors of integral type.  Two
+ *  such elements are equal exactly when their bytes are, so equality and
+ *  the first mismatch are found by a byte compare kernel (SSE2/AVX2 on
+ *  x86, word at a time elsewhere); only the one mismatching pair is then
+ *  compared as values, which gives signed results for signed types where
+ *  memcmp would not.
+ *
+ *  compare returns std::strong_ordering; three_way, less and equal_to are
+ *  transparent function objects for std::sort, std::map, std::unique and
+ *  the like.  Other element types use std::lexicographical_compare_three_way.
+ */
+namespace veccmp {
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VECCMP_X86 1
+#define VECCMP_AVX2 __attribute__((target("avx2,bmi")))
+#endif  /* defined(__x86_64__) || defined(__i386__) */
+
+enum class isa : int { portable, sse2, avx2, };
+
+inline isa detect() noexcept {
+#if defined(VECCMP_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return isa::avx2;
+  }
+#if defined(__SSE2__)
+  return isa::sse2;
+#endif  /* defined(__SSE2__) */
+#endif  /* defined(VECCMP_X86) */
+  return isa::portable;
+}
+
+inline isa const active = detect();
+
+inline char const * name(isa is = active) noexcept {
+  static char const * const names[] = { "portable", "sse2", "avx2", };
+  return names[static_cast<int>(is)];
+}
+
+//  the kernels return the offset of the first differing byte, or count.
+inline std::size_t portable_mismatch(unsigned char const * lhs, unsigned char const * rhs,
+                                     std::size_t count) noexcept {
+  auto ix = 0ul;
+  for (; ix + 8 <= count; ix += 8) {
+    std::uint64_t lw, rw;
+    std::memcpy(&lw, lhs + ix, 8);
+    std::memcpy(&rw, rhs + ix, 8);
+    if (lw != rw) {
+      auto const bit = std::endian::native == std::endian::little
+        ? std::countr_zero(lw ^ rw) : std::countl_zero(lw ^ rw);
+      return ix + static_cast<std::size_t>(bit) / 8;
+    }
+  }
+  for (; ix < count && lhs[ix] == rhs[ix]; ++ix) {}
+  return ix;
+}
+
+#if defined(VECCMP_X86)
+#if defined(__SSE2__)
+inline std::size_t sse2_mismatch(unsigned char const * lhs, unsigned char const * rhs,
+                                 std::size_t count) noexcept {
+  auto ix = 0ul;
+  for (; ix + 16 <= count; ix += 16) {
+    auto const lb = _mm_loadu_si128(reinterpret_cast<__m128i const *>(lhs + ix));
+    auto const rb = _mm_loadu_si128(reinterpret_cast<__m128i const *>(rhs + ix));
+    auto const same = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(lb, rb)));
+    if (same != 0xffff) {
+      return ix + static_cast<std::size_t>(std::countr_zero(~same));
+    }
+  }
+  return ix + portable_mismatch(lhs + ix, rhs + ix, count - ix);
+}
+#endif  /* defined(__SSE2__) */
+
+//  64 bytes a step; the two halves are and-ed so the loop has one branch.
+VECCMP_AVX2
+inline std::size_t avx2_mismatch(unsigned char const * lhs, unsigned char const * rhs,
+                                 std::size_t count) noexcept {
+  auto ix = 0ul;
+  for (; ix + 64 <= count; ix += 64) {
+    auto const lo = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(lhs + ix)),
+                                      _mm256_loadu_si256(reinterpret_cast<__m256i const *>(rhs + ix)));
+    auto const hi = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(lhs + ix + 32)),
+                                      _mm256_loadu_si256(reinterpret_cast<__m256i const *>(rhs + ix + 32)));
+    if (static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(lo, hi))) != ~0u) {
+      auto const same = static_cast<std::uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(lo)))
+                      | static_cast<std::uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(hi))) << 32;
+      return ix + static_cast<std::size_t>(std::countr_zero(~same));
+    }
+  }
+  for (; ix + 32 <= count; ix += 32) {
+    auto const eq = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(lhs + ix)),
+                                      _mm256_loadu_si256(reinterpret_cast<__m256i const *>(rhs + ix)));
+    auto const same = static_cast<unsigned>(_mm256_movemask_epi8(eq));
+    if (same != ~0u) {
+      return ix + static_cast<std::size_t>(std::countr_zero(~same));
+    }
+  }
+  return ix + portable_mismatch(lhs + ix, rhs + ix, count - ix);
+}
+#endif  /* defined(VECCMP_X86) */
+
+inline std::size_t mismatch_bytes(void const * lhs, void const * rhs, std::size_t count) noexcept {
+  auto const * const lb = static_cast<unsigned char const *>(lhs);
+  auto const * const rb = static_cast<unsigned char const *>(rhs);
+#if defined(VECCMP_X86)
+  if (active == isa::avx2) {
+    return avx2_mismatch(lb, rb, count);
+  }
+#if defined(__SSE2__)
+  return sse2_mismatch(lb, rb, count);
+#endif  /* defined(__SSE2__) */
+#endif  /* defined(VECCMP_X86) */
+  return portable_mismatch(lb, rb, count);
+}
+
+template <class T>
+concept bytewise = std::is_integral_v<T>;
+
+//  index of the first element where lhs and rhs differ, or count.
+template <bytewise T>
+std::size_t mismatch(T const * lhs, T const * rhs, std::size_t count) noexcept {
+  return mismatch_bytes(lhs, rhs, count * sizeof(T)) / sizeof(T);
+}
+
+template <std::ranges::contiguous_range Lhs, std::ranges::contiguous_range Rhs>
+bool equal(Lhs const & lhs, Rhs const & rhs) {
+  using T = std::ranges::range_value_t<Lhs>;
+  auto const size = std::ranges::size(lhs);
+  if (size != std::ranges::size(rhs)) {
+    return false;
+  }
+  if constexpr (bytewise<T> && std::is_same_v<T, std::ranges::range_value_t<Rhs>>) {
+    return mismatch(std::ranges::data(lhs), std::ranges::data(rhs), size) == size;
+  }
+  else {
+    return std::equal(std::ranges::begin(lhs), std::ranges::end(lhs), std::ranges::begin(rhs));
+  }
+}
+
+template <std::ranges::contiguous_range Lhs, std::ranges::contiguous_range Rhs>
+auto compare(Lhs const & lhs, Rhs const & rhs) {
+  using T = std::ranges::range_value_t<Lhs>;
+  if constexpr (bytewise<T> && std::is_same_v<T, std::ranges::range_value_t<Rhs>>) {
+    auto const nl = std::ranges::size(lhs);
+    auto const nr = std::ranges::size(rhs);
+    auto const * const ld = std::ranges::data(lhs);
+    auto const * const rd = std::ranges::data(rhs);
+    auto const count = std::min(nl, nr);
+    auto const ix = mismatch(ld, rd, count);
+    return ix < count ? std::strong_ordering(ld[ix] <=> rd[ix]) : nl <=> nr;
+  }
+  else {
+    return std::lexicographical_compare_three_way(std::ranges::begin(lhs), std::ranges::end(lhs),
+                                                  std::ranges::begin(rhs), std::ranges::end(rhs));
+  }
+}
+
+struct three_way {
+  using is_transparent = void;
+  template <class Lhs, class Rhs>
+  auto operator()(Lhs const & lhs, Rhs const & rhs) const { return compare(lhs, rhs); }
+};
+
+struct less {
+  using is_transparent = void;
+  template <class Lhs, class Rhs>
+  bool operator()(Lhs const & lhs, Rhs const & rhs) const { return compare(lhs, rhs) < 0; }
+};
+
+struct equal_to {
+  using is_transparent = void;
+  template <class Lhs, class Rhs>
+  bool operator()(Lhs const & lhs, Rhs const & rhs) const { return equal(lhs, rhs); }
+};
+
+} /* namespace veccmp */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecsnap
+/*
+ *  Binary snapshots of std::vector<T> for trivially copyable T, and of
+ *  std::vector<bool> packed 64 bits to a word, least significant bit first.
+ *
+ *  A file is a 64-byte header followed by the raw elements:
+ *
+ *    magic "VECSNAP", version, endianness tag, type tag (kind, size and
+ *    alignment of T), element count, payload bytes, payload checksum
+ *
+ *  view<T> maps a file read-only and serves the elements in place, so
+ *  opening costs a few system calls whatever the size; pages are read on
+ *  first touch.  The header is always checked; the checksum, which has to
+ *  read the whole payload, only when asked for.  to_vector copies the
+ *  elements into a vector with any allocator.  Files written on a machine
+ *  of the other byte order are rejected, not swapped.
+ *
+ *  Errors throw: std::system_error for the OS, std::runtime_error for the
+ *  file format.
+ */
+namespace vecsnap {
+
+#if defined(__unix__) || defined(__APPLE__)
+#define VECSNAP_MMAP 1
+#endif  /* defined(__unix__) || defined(__APPLE__) */
+
+enum class check : int { header, checksum, };
+
+struct header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t endian;
+  std::uint64_t type;
+  std::uint64_t size;
+  std::uint64_t bytes;
+  std::uint64_t checksum;
+  std::uint8_t reserved[16];
+};
+static_assert(sizeof(header) == 64);
+
+static constexpr char magic[8] = "VECSNAP";
+static constexpr std::uint32_t version = 1;
+static constexpr std::uint32_t endian_tag = 0x01020304;
+
+//  kind in the top byte, then alignment and size.
+template <class T>
+constexpr std::uint64_t type_tag() noexcept {
+  std::uint64_t kind = std::is_same_v<T, bool> ? 'b'
+                     : std::is_floating_point_v<T> ? 'f'
+                     : std::is_signed_v<T> ? 'i'
+                     : std::is_unsigned_v<T> ? 'u' : 'r';
+  return kind << 56 | std::uint64_t(alignof(T)) << 32 | sizeof(T);
+}
+
+//  four independent xxh64-style lanes over 32-byte stripes, then the tail.
+inline std::uint64_t checksum(void const * data, std::size_t bytes) noexcept {
+  auto constexpr p1 = 0x9e3779b185ebca87ull;
+  auto constexpr p2 = 0xc2b2ae3d27d4eb4full;
+  auto const * const src = static_cast<unsigned char const *>(data);
+  std::uint64_t lane[4] = { p1 + p2, p2, 0, 0 - p1, };
+  auto ix = 0ul;
+  for (; ix + 32 <= bytes; ix += 32) {
+    for (auto ln = 0; ln < 4; ++ln) {
+      std::uint64_t wd;
+      std::memcpy(&wd, src + ix + 8 * ln, 8);
+      lane[ln] = std::rotl(lane[ln] + wd * p2, 31) * p1;
+    }
+  }
+  auto acc = std::rotl(lane[0], 1) + std::rotl(lane[1], 7) + std::rotl(lane[2], 12)
+           + std::rotl(lane[3], 18) + bytes;
+  for (; ix < bytes; ++ix) {
+    acc = std::rotl(acc ^ (src[ix] * p1), 11) * p2;
+  }
+  acc ^= acc >> 33;
+  acc *= p2;
+  acc ^= acc >> 29;
+  return acc ^ acc >> 32;
+}
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  write
+inline void write(std::string const & path, std::uint64_t type, std::uint64_t size,
+                  void const * data, std::size_t bytes) {
+  header hd {};
+  std::memcpy(hd.magic, magic, sizeof magic);
+  hd.version = version;
+  hd.endian = endian_tag;
+  hd.type = type;
+  hd.size = size;
+  hd.bytes = bytes;
+  hd.checksum = checksum(data, bytes);
+
+  std::unique_ptr<std::FILE, int (*)(std::FILE *)> fp(std::fopen(path.c_str(), "wb"), &std::fclose);
+  if (!fp) {
+    throw std::system_error(errno, std::generic_category(), "vecsnap: cannot create " + path);
+  }
+  if (std::fwrite(&hd, sizeof hd, 1, fp.get()) != 1
+      || (bytes != 0 && std::fwrite(data, bytes, 1, fp.get()) != 1)
+      || std::fclose(fp.release()) != 0) {
+    throw std::system_error(errno, std::generic_category(), "vecsnap: cannot write " + path);
+  }
+}
+
+template <class T, class Alloc>
+void save(std::string const & path, std::vector<T, Alloc> const & vec) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  write(path, type_tag<T>(), vec.size(), vec.data(), vec.size() * sizeof(T));
+}
+
+template <class Alloc>
+void save(std::string const & path, std::vector<bool, Alloc> const & vec) {
+  std::vector<std::uint64_t> words((vec.size() + 63) / 64);
+  auto it = vec.begin();
+  for (auto & wd : words) {
+    auto const count = std::min<std::size_t>(64, static_cast<std::size_t>(vec.end() - it));
+    for (auto bt = 0ul; bt < count; ++bt, ++it) {
+      wd |= std::uint64_t(*it) << bt;
+    }
+  }
+  write(path, type_tag<bool>(), vec.size(), words.data(), words.size() * sizeof(std::uint64_t));
+}
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  read
+//  the whole file, mapped read-only (or read into memory without mmap).
+class mapping {
+public:
+  mapping() = default;
+
+  explicit mapping(std::string const & path) {
+#if defined(VECSNAP_MMAP)
+    auto const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "vecsnap: cannot open " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+      auto const err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(), "vecsnap: cannot stat " + path);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ != 0) {
+      auto * const base = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (base == MAP_FAILED) {
+        auto const err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), "vecsnap: cannot map " + path);
+      }
+      base_ = static_cast<unsigned char const *>(base);
+    }
+    ::close(fd);
+#else
+    std::unique_ptr<std::FILE, int (*)(std::FILE *)> fp(std::fopen(path.c_str(), "rb"), &std::fclose);
+    if (!fp) {
+      throw std::system_error(errno, std::generic_category(), "vecsnap: cannot open " + path);
+    }
+    std::string buf;
+    std::array<char, 64 * 1024> block;
+    for (std::size_t got; (got = std::fread(block.data(), 1, block.size(), fp.get())) != 0; ) {
+      buf.append(block.data(), got);
+    }
+    size_ = buf.size();
+    owned_ = std::make_unique<std::uint64_t[]>((size_ + 7) / 8);
+    std::memcpy(owned_.get(), buf.data(), size_);
+    base_ = reinterpret_cast<unsigned char const *>(owned_.get());
+#endif  /* defined(VECSNAP_MMAP) */
+  }
+
+  mapping(mapping && other) noexcept
+    : base_(std::exchange(other.base_, nullptr)), size_(std::exchange(other.size_, 0)) {
+#if !defined(VECSNAP_MMAP)
+    owned_ = std::move(other.owned_);
+#endif  /* !defined(VECSNAP_MMAP) */
+  }
+
+  mapping & operator=(mapping && other) noexcept {
+    if (this != &other) {
+      unmap();
+      base_ = std::exchange(other.base_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+#if !defined(VECSNAP_MMAP)
+      owned_ = std::move(other.owned_);
+#endif  /* !defined(VECSNAP_MMAP) */
+    }
+    return *this;
+  }
+
+  ~mapping() { unmap(); }
+
+  unsigned char const * data() const noexcept { return base_; }
+  std::size_t size() const noexcept { return size_; }
+
+private:
+  void unmap() noexcept {
+#if defined(VECSNAP_MMAP)
+    if (base_ != nullptr) {
+      ::munmap(const_cast<unsigned char *>(base_), size_);
+    }
+#endif  /* defined(VECSNAP_MMAP) */
+    base_ = nullptr;
+    size_ = 0;
+  }
+
+  unsigned char const * base_ = nullptr;
+  std::size_t size_ = 0;
+#if !defined(VECSNAP_MMAP)
+  std::unique_ptr<std::uint64_t[]> owned_;
+#endif  /* !defined(VECSNAP_MMAP) */
+};
+
+//  checks the header against the expected type and returns it.
+inline header validate(mapping const & map, std::uint64_t type, std::uint64_t elem_bytes,
+                       check chk, std::string const & path) {
+  auto fail = [&path](char const * why) {
+    throw std::runtime_error("vecsnap: "s + path + ": "s + why);
+  };
+  header hd;
+  if (map.size() < sizeof hd) {
+    fail("too short for a header");
+  }
+  std::memcpy(&hd, map.data(), sizeof hd);
+  if (std::memcmp(hd.magic, magic, sizeof magic) != 0) {
+    fail("not a snapshot");
+  }
+  if (hd.endian != endian_tag) {
+    fail("written with the other byte order");
+  }
+  if (hd.version != version) {
+    fail("unsupported version");
+  }
+  if (hd.type != type) {
+    fail("element type does not match");
+  }
+  //  the count is untrusted: bound it by the payload before multiplying, so
+  //  a crafted header cannot wrap the byte count round to a small value.
+  auto const room = map.size() - sizeof hd;
+  auto const most = elem_bytes != 0 ? room / elem_bytes : room / 8 * 64;
+  if (hd.size > most) {
+    fail("size does not match the payload");
+  }
+  auto const want = elem_bytes != 0 ? hd.size * elem_bytes : (hd.size + 63) / 64 * 8;
+  if (hd.bytes != want) {
+    fail("size does not match the payload");
+  }
+  if (chk == check::checksum && checksum(map.data() + sizeof hd, hd.bytes) != hd.checksum) {
+    fail("checksum mismatch");
+  }
+  return hd;
+}
+
+template <class T>
+class view {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using const_iterator = T const *;
+
+  explicit view(std::string const & path, check chk = check::header)
+    : map_(path) {
+    auto const hd = validate(map_, type_tag<T>(), sizeof(T), chk, path);
+    data_ = { reinterpret_cast<T const *>(map_.data() + sizeof(header)),
+              static_cast<std::size_t>(hd.size), };
+  }
+
+  std::span<T const> span() const noexcept { return data_; }
+  T const * data() const noexcept { return data_.data(); }
+  size_type size() const noexcept { return data_.size(); }
+  bool empty() const noexcept { return data_.empty(); }
+  T const & operator[](size_type ix) const noexcept { return data_[ix]; }
+  const_iterator begin() const noexcept { return data_.data(); }
+  const_iterator end() const noexcept { return data_.data() + data_.size(); }
+
+  template <class Alloc = std::allocator<T>>
+  std::vector<T, Alloc> to_vector(Alloc const & al = Alloc()) const {
+    return std::vector<T, Alloc>(begin(), end(), al);
+  }
+
+private:
+  mapping map_;
+  std::span<T const> data_;
+};
+
+//  packed bits, read in place.
+template <>
+class view<bool> {
+public:
+  using value_type = bool;
+  using size_type = std::size_t;
+
+  explicit view(std::string const & path, check chk = check::header)
+    : map_(path) {
+    auto const hd = validate(map_, type_tag<bool>(), 0, chk, path);
+    words_ = reinterpret_cast<std::uint64_t const *>(map_.data() + sizeof(header));
+    size_ = static_cast<std::size_t>(hd.size);
+  }
+
+  size_type size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  bool operator[](size_type ix) const noexcept { return (words_[ix / 64] >> (ix % 64)) & 1; }
+  std::span<std::uint64_t const> words() const noexcept { return { words_, (size_ + 63) / 64, }; }
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = bool;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = bool;
+
+    const_iterator() = default;
+    const_iterator(view const * vw, size_type ix) noexcept : vw_(vw), ix_(ix) {}
+    bool operator*() const noexcept { return (*vw_)[ix_]; }
+    const_iterator & operator++() noexcept { ++ix_; return *this; }
+    const_iterator operator++(int) noexcept { auto tmp = *this; ++ix_; return tmp; }
+    difference_type operator-(const_iterator const & other) const noexcept {
+      return static_cast<difference_type>(ix_) - static_cast<difference_type>(other.ix_);
+    }
+    bool operator==(const_iterator const & other) const noexcept { return ix_ == other.ix_; }
+
+  private:
+    view const * vw_ = nullptr;
+    size_type ix_ = 0;
+  };
+
+  const_iterator begin() const noexcept { return { this, 0, }; }
+  const_iterator end() const noexcept { return { this, size_, }; }
+
+  template <class Alloc = std::allocator<bool>>
+  std::vector<bool, Alloc> to_vector(Alloc const & al = Alloc()) const {
+    std::vector<bool, Alloc> vec(al);
+    vec.reserve(size_);
+    for (auto ix = 0ul; ix < size_; ++ix) {
+      vec.push_back((*this)[ix]);
+    }
+    return vec;
+  }
+
+private:
+  mapping map_;
+  std::uint64_t const * words_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+} /* namespace vecsnap */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecpack
+/*
+ *  packed_vector<T>: a vector of integers stored in blocks of 128 values,
+ *  each block bit-packed at the width its largest code needs, for
+ *  memory-bound scans over values much smaller than T.  A block's codes
+ *  depend on the codec chosen at construction:
+ *
+ *    packed  the value itself (zigzag-coded for signed T)
+ *    frame   value - the block minimum (frame of reference)
+ *    delta   value - the value four places earlier, zigzag-coded; the
+ *            first four are taken from the last value of the block before
+ *
+ *  The layout is SIMD-BP128 (Lemire, Boytsov 2015): the codes go to four
+ *  32-bit lanes in turn, and each lane packs its 32 codes end to end, so a
+ *  block at width b is exactly 4 * b 32-bit words and one call of the SSE2
+ *  kernel (unrolled per width) unpacks all 128 codes.  A code wider than
+ *  32 bits makes the block raw: its 128 values stored as 64-bit words.
+ *
+ *  operator[] is O(1) for packed and frame: one code is pulled from its
+ *  lane.  Under delta it adds up the codes of its lane to that point, at
+ *  most 32 of them, instead of decoding the block.  push_back fills an
+ *  unpacked tail of up to 127 values and packs it when it reaches 128.
+ *  Values are immutable once pushed.  The iterators and for_each_block
+ *  decode a block at a time; decode_block is the bulk entry point.  Each
+ *  block costs a 16-byte header (one bit per value).
+ */
+namespace vecpack {
+
+enum class codec : std::uint8_t { packed, frame, delta, };
+
+inline char const * name(codec cd) noexcept {
+  static char const * const names[] = { "packed", "frame", "delta", };
+  return names[static_cast<int>(cd)];
+}
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecpack::kernel
+/*
+ *  pack/unpack of one block of 128 32-bit codes at width B, which the
+ *  caller guarantees the codes fit.  Instantiated for every width 0..32
+ *  and picked through a table.  SSE2 is the x86-64 baseline, so there is
+ *  no run-time dispatch; other targets use the lane-by-lane loops, which
+ *  produce the same layout.
+ */
+namespace kernel {
+
+inline constexpr std::size_t block = 128;
+inline constexpr std::size_t lanes = 4;
+inline constexpr unsigned raw = 64;   //  width of a block that is not packed
+
+template <unsigned B>
+inline void portable_pack(std::uint32_t const * in, std::uint32_t * out) noexcept {
+  for (auto ln = 0ul; ln < lanes; ++ln) {
+    std::uint32_t acc = 0;
+    auto shift = 0u;
+    auto dst = out + ln;
+    for (auto ix = ln; ix < block; ix += lanes) {
+      acc |= in[ix] << shift;
+      shift += B;
+      if (shift >= 32) {
+        *dst = acc;
+        dst += lanes;
+        shift -= 32;
+        acc = shift != 0 ? in[ix] >> (B - shift) : 0;
+      }
+    }
+  }
+}
+
+template <unsigned B>
+inline void portable_unpack(std::uint32_t const * in, std::uint32_t * out) noexcept {
+  constexpr auto mask = B == 32 ? ~0u : (1u << B) - 1;
+  for (auto ln = 0ul; ln < lanes; ++ln) {
+    auto src = in + ln;
+    auto cur = *src;
+    auto shift = 0u;
+    for (auto ix = ln; ix < block; ix += lanes) {
+      auto val = cur >> shift;
+      shift += B;
+      if (shift > 32) {
+        src += lanes;
+        cur = *src;
+        shift -= 32;
+        val |= cur << (B - shift);
+      }
+      else if (shift == 32 && ix + lanes < block) {
+        src += lanes;
+        cur = *src;
+        shift = 0;
+      }
+      out[ix] = val & mask;
+    }
+  }
+}
+
+#if defined(__SSE2__)
+template <unsigned B>
+inline void sse2_pack(std::uint32_t const * in, std::uint32_t * out) noexcept {
+  auto src = reinterpret_cast<__m128i const *>(in);
+  auto dst = reinterpret_cast<__m128i *>(out);
+  auto acc = _mm_setzero_si128();
+  auto shift = 0u;
+#pragma GCC unroll 32
+  for (auto ix = 0u; ix < block / lanes; ++ix) {
+    auto const val = _mm_loadu_si128(src + ix);
+    acc = _mm_or_si128(acc, _mm_slli_epi32(val, static_cast<int>(shift)));
+    shift += B;
+    if (shift >= 32) {
+      _mm_storeu_si128(dst++, acc);
+      shift -= 32;
+      acc = shift != 0 ? _mm_srli_epi32(val, static_cast<int>(B - shift)) : _mm_setzero_si128();
+    }
+  }
+}
+
+//  hands the codes to sink(ix, v), v holding codes 4 * ix .. 4 * ix + 3,
+//  so callers can finish them in registers.
+template <unsigned B, class Sink>
+inline void sse2_unpack(std::uint32_t const * in, Sink & sink) noexcept {
+  if constexpr (B == 0) {
+    for (auto ix = 0u; ix < block / lanes; ++ix) {
+      sink(ix, _mm_setzero_si128());
+    }
+  }
+  else {
+    auto src = reinterpret_cast<__m128i const *>(in);
+    auto const mask = _mm_set1_epi32(static_cast<int>(B == 32 ? ~0u : (1u << B) - 1));
+    auto cur = _mm_loadu_si128(src);
+    auto shift = 0u;
+#pragma GCC unroll 32
+    for (auto ix = 0u; ix < block / lanes; ++ix) {
+      auto val = _mm_srli_epi32(cur, static_cast<int>(shift));
+      shift += B;
+      if (shift > 32) {
+        cur = _mm_loadu_si128(++src);
+        shift -= 32;
+        val = _mm_or_si128(val, _mm_slli_epi32(cur, static_cast<int>(B - shift)));
+      }
+      else if (shift == 32 && ix + 1 < block / lanes) {
+        cur = _mm_loadu_si128(++src);
+        shift = 0;
+      }
+      sink(ix, _mm_and_si128(val, mask));
+    }
+  }
+}
+
+struct sse2_codes {
+  void operator()(std::size_t ix, __m128i val) noexcept {
+    _mm_storeu_si128(dst + ix, val);
+  }
+
+  __m128i * dst;
+};
+
+inline __m128i sse2_unzigzag(__m128i code) noexcept {
+  return _mm_xor_si128(_mm_srli_epi32(code, 1),
+                       _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(code, _mm_set1_epi32(1))));
+}
+
+//  codes to Bytes-wide values (4 or 8): zigzag, frame base or the four-lane
+//  prefix sum of delta.  Wider values are formed in 64-bit lanes, the
+//  zigzag-decoded codes sign-extended.
+template <codec Cd, bool Signed, std::size_t Bytes>
+struct sse2_values {
+  static constexpr bool zigzag = Cd == codec::delta || (Cd == codec::packed && Signed);
+
+  sse2_values(std::uint64_t base, void * out) noexcept
+    : dst(static_cast<__m128i *>(out)),
+      bv(Bytes == 4 ? _mm_set1_epi32(static_cast<int>(base))
+                    : _mm_set1_epi64x(static_cast<long long>(base))),
+      lo_acc(bv), hi_acc(bv) {}
+
+  void operator()(std::size_t ix, __m128i val) noexcept {
+    if constexpr (zigzag) {
+      val = sse2_unzigzag(val);
+    }
+    if constexpr (Bytes == 4) {
+      if constexpr (Cd == codec::frame) { val = _mm_add_epi32(val, bv); }
+      if constexpr (Cd == codec::delta) { val = lo_acc = _mm_add_epi32(lo_acc, val); }
+      _mm_storeu_si128(dst + ix, val);
+    }
+    else {
+      auto const ext = zigzag ? _mm_srai_epi32(val, 31) : _mm_setzero_si128();
+      auto lo = _mm_unpacklo_epi32(val, ext);
+      auto hi = _mm_unpackhi_epi32(val, ext);
+      if constexpr (Cd == codec::frame) {
+        lo = _mm_add_epi64(lo, bv);
+        hi = _mm_add_epi64(hi, bv);
+      }
+      if constexpr (Cd == codec::delta) {
+        lo = lo_acc = _mm_add_epi64(lo_acc, lo);
+        hi = hi_acc = _mm_add_epi64(hi_acc, hi);
+      }
+      _mm_storeu_si128(dst + 2 * ix, lo);
+      _mm_storeu_si128(dst + 2 * ix + 1, hi);
+    }
+  }
+
+  __m128i * dst;
+  __m128i bv, lo_acc, hi_acc;
+};
+#endif  /* defined(__SSE2__) */
+
+template <unsigned B>
+inline void pack(std::uint32_t const * in, std::uint32_t * out) noexcept {
+  if constexpr (B != 0) {
+#if defined(__SSE2__)
+    sse2_pack<B>(in, out);
+#else
+    portable_pack<B>(in, out);
+#endif  /* defined(__SSE2__) */
+  }
+}
+
+template <unsigned B>
+inline void unpack(std::uint32_t const * in, std::uint32_t * out) noexcept {
+#if defined(__SSE2__)
+  sse2_codes sink { reinterpret_cast<__m128i *>(out), };
+  sse2_unpack<B>(in, sink);
+#else
+  if constexpr (B == 0) {
+    std::fill_n(out, block, 0u);
+  }
+  else {
+    portable_unpack<B>(in, out);
+  }
+#endif  /* defined(__SSE2__) */
+}
+
+using block_fn = void (*)(std::uint32_t const *, std::uint32_t *) noexcept;
+
+template <std::size_t... Bs>
+constexpr std::array<block_fn, sizeof...(Bs)> packers(std::index_sequence<Bs...>) {
+  return { &pack<Bs>..., };
+}
+
+template <std::size_t... Bs>
+constexpr std::array<block_fn, sizeof...(Bs)> unpackers(std::index_sequence<Bs...>) {
+  return { &unpack<Bs>..., };
+}
+
+inline constexpr auto pack_at = packers(std::make_index_sequence<33>());
+inline constexpr auto unpack_at = unpackers(std::make_index_sequence<33>());
+
+#if defined(__SSE2__)
+//  unpack and finish in one pass: a block of codes to 128 values.
+template <codec Cd, bool Signed, std::size_t Bytes, unsigned B>
+inline void decode(std::uint32_t const * in, std::uint64_t base, void * out) noexcept {
+  sse2_values<Cd, Signed, Bytes> sink(base, out);
+  sse2_unpack<B>(in, sink);
+}
+
+using decode_fn = void (*)(std::uint32_t const *, std::uint64_t, void *) noexcept;
+
+template <codec Cd, bool Signed, std::size_t Bytes, std::size_t... Bs>
+constexpr std::array<decode_fn, sizeof...(Bs)> decoders(std::index_sequence<Bs...>) {
+  return { &decode<Cd, Signed, Bytes, Bs>..., };
+}
+
+template <codec Cd, bool Signed, std::size_t Bytes>
+inline constexpr auto decode_at = decoders<Cd, Signed, Bytes>(std::make_index_sequence<33>());
+#endif  /* defined(__SSE2__) */
+
+//  code ix of a block at width bw, without unpacking the rest.
+inline std::uint32_t extract(std::uint32_t const * in, unsigned bw, std::size_t ix) noexcept {
+  if (bw == 0) {
+    return 0;
+  }
+  auto const bit = ix / lanes * bw;
+  auto const wp = in + bit / 32 * lanes + ix % lanes;
+  auto const shift = bit % 32;
+  auto val = std::uint64_t(wp[0]) >> shift;
+  if (shift + bw > 32) {
+    val |= std::uint64_t(wp[lanes]) << (32 - shift);
+  }
+  return static_cast<std::uint32_t>(val & (~std::uint64_t(0) >> (64 - bw)));
+}
+
+//  the zigzag-decoded codes ix % lanes, ix % lanes + lanes, ... ix of a
+//  delta block at width bw (at most 32 of them) summed, reading each lane
+//  word once.
+inline std::uint64_t lane_sum(std::uint32_t const * in, unsigned bw, std::size_t ix) noexcept {
+  if (bw == 0) {
+    return 0;
+  }
+  auto src = in + ix % lanes;
+  auto const mask = ~std::uint64_t(0) >> (64 - bw);
+  auto bits = std::uint64_t(*src);
+  auto have = 32u;
+  std::uint64_t sum = 0;
+  for (auto left = ix / lanes + 1; left != 0; --left) {
+    if (have < bw) {
+      src += lanes;
+      bits |= std::uint64_t(*src) << have;
+      have += 32;
+    }
+    auto const code = bits & mask;
+    sum += (code >> 1) ^ (0 - (code & 1));
+    bits >>= bw;
+    have -= bw;
+  }
+  return sum;
+}
+
+} /* namespace kernel */
+
+template <std::integral T>
+class packed_vector {
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  static constexpr size_type block = kernel::block;
+
+  //  input iterator that decodes a block at a time into its own buffer.
+  class const_iterator {
+  public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = T;
+
+    const_iterator() = default;
+
+    T operator*() const noexcept { return buf_[ix_ % block]; }
+
+    const_iterator & operator++() noexcept {
+      if (++ix_ % block == 0) {
+        fetch();
+      }
+      return *this;
+    }
+
+    const_iterator operator++(int) noexcept {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(const_iterator const & lhs, const_iterator const & rhs) noexcept {
+      return lhs.ix_ == rhs.ix_;
+    }
+
+  private:
+    friend class packed_vector;
+    const_iterator(packed_vector const * pv, size_type ix) noexcept : pv_(pv), ix_(ix) {
+      if (ix_ % block == 0) {
+        fetch();
+      }
+    }
+
+    void fetch() noexcept {
+      if (ix_ < pv_->size()) {
+        pv_->decode_block(ix_ / block, buf_.data());
+      }
+    }
+
+    packed_vector const * pv_ = nullptr;
+    size_type ix_ = 0;
+    std::array<T, block> buf_;
+  };
+
+  explicit packed_vector(codec cd = codec::frame) : codec_(cd) {}
+
+  packed_vector(std::initializer_list<T> il, codec cd = codec::frame)
+    : packed_vector(il.begin(), il.end(), cd) {}
+
+  template <std::input_iterator It>
+  packed_vector(It first, It last, codec cd = codec::frame) : codec_(cd) {
+    for (; first != last; ++first) {
+      push_back(static_cast<T>(*first));
+    }
+  }
+
+  codec mode() const noexcept { return codec_; }
+
+  /// Element access
+  T operator[](size_type pos) const noexcept {
+    auto const bx = pos / block;
+    if (bx == heads_.size()) {
+      return tail_[pos % block];
+    }
+    auto const & hd = heads_[bx];
+    auto const wp = data_.data() + hd.offset * kernel::lanes;
+    if (hd.width == kernel::raw) {
+      return from_u64(std::uint64_t(wp[2 * (pos % block)])
+                      | std::uint64_t(wp[2 * (pos % block) + 1]) << 32);
+    }
+    auto const ix = pos % block;
+    switch (codec_) {
+    case codec::packed:
+      return unpacked(kernel::extract(wp, hd.width, ix));
+    case codec::frame:
+      return from_u64(hd.base + kernel::extract(wp, hd.width, ix));
+    case codec::delta:
+      return from_u64(hd.base + kernel::lane_sum(wp, hd.width, ix));
+    }
+    return T();
+  }
+
+  T at(size_type pos) const {
+    if (pos >= size()) {
+      throw std::out_of_range("vecpack::packed_vector::at");
+    }
+    return (*this)[pos];
+  }
+
+  T front() const noexcept { return (*this)[0]; }
+  T back() const noexcept { return (*this)[size() - 1]; }
+
+  /// Iterators
+  const_iterator begin() const noexcept { return { this, 0, }; }
+  const_iterator end() const noexcept { return { this, size(), }; }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+  /// Capacity
+  bool empty() const noexcept { return size() == 0; }
+  size_type size() const noexcept { return heads_.size() * block + tail_.size(); }
+  size_type blocks() const noexcept { return heads_.size() + !tail_.empty(); }
+
+  //  heap and object bytes.
+  size_type bytes() const noexcept {
+    return sizeof *this + heads_.capacity() * sizeof(head)
+         + data_.capacity() * sizeof(std::uint32_t) + tail_.capacity() * sizeof(T);
+  }
+
+  //  room for nv values whose codes take up to bits each (a raw block counts
+  //  as 64); shrink_to_fit() returns what the blocks did not use.
+  void reserve(size_type nv, unsigned bits = 32) {
+    heads_.reserve(nv / block);
+    data_.reserve(nv / block * kernel::lanes * std::min(bits, kernel::raw));
+  }
+
+  void shrink_to_fit() {
+    heads_.shrink_to_fit();
+    data_.shrink_to_fit();
+    tail_.shrink_to_fit();
+  }
+
+  /// Modifiers
+  void clear() noexcept {
+    heads_.clear();
+    data_.clear();
+    tail_.clear();
+    last_ = 0;
+  }
+
+  void push_back(T val) {
+    if (tail_.empty()) {
+      tail_.reserve(block);
+    }
+    tail_.push_back(val);
+    if (tail_.size() == block) {
+      seal();
+    }
+  }
+
+  /// Bulk decode
+  //  the values of block bx (the last may be partial) into out; returns
+  //  how many.
+  size_type decode_block(size_type bx, T * out) const noexcept {
+    if (bx == heads_.size()) {
+      std::copy(tail_.begin(), tail_.end(), out);
+      return tail_.size();
+    }
+    auto const & hd = heads_[bx];
+    auto const wp = data_.data() + hd.offset * kernel::lanes;
+    if (hd.width == kernel::raw) {
+      for (auto ix = 0ul; ix < block; ++ix) {
+        out[ix] = from_u64(std::uint64_t(wp[2 * ix]) | std::uint64_t(wp[2 * ix + 1]) << 32);
+      }
+      return block;
+    }
+#if defined(__SSE2__)
+    if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+      constexpr bool sg = std::is_signed_v<T>;
+      switch (codec_) {
+      case codec::packed:
+        kernel::decode_at<codec::packed, sg, sizeof(T)>[hd.width](wp, hd.base, out);
+        break;
+      case codec::frame:
+        kernel::decode_at<codec::frame, sg, sizeof(T)>[hd.width](wp, hd.base, out);
+        break;
+      case codec::delta:
+        kernel::decode_at<codec::delta, sg, sizeof(T)>[hd.width](wp, hd.base, out);
+        break;
+      }
+      return block;
+    }
+#endif  /* defined(__SSE2__) */
+    alignas(16) std::uint32_t codes[block];
+    kernel::unpack_at[hd.width](wp, codes);
+    switch (codec_) {
+    case codec::packed:
+      for (auto ix = 0ul; ix < block; ++ix) {
+        out[ix] = unpacked(codes[ix]);
+      }
+      break;
+    case codec::frame:
+      for (auto ix = 0ul; ix < block; ++ix) {
+        out[ix] = from_u64(hd.base + codes[ix]);
+      }
+      break;
+    case codec::delta: {
+      std::uint64_t acc[kernel::lanes] = { hd.base, hd.base, hd.base, hd.base, };
+      for (auto ix = 0ul; ix < block; ix += kernel::lanes) {
+        for (auto ln = 0ul; ln < kernel::lanes; ++ln) {
+          acc[ln] += unzigzag(codes[ix + ln]);
+          out[ix + ln] = from_u64(acc[ln]);
+        }
+      }
+      break;
+    }
+    }
+    return block;
+  }
+
+  //  calls fn(std::span<T const>) with each decoded block in order.
+  template <class Fn>
+  void for_each_block(Fn fn) const {
+    std::array<T, block> buf;
+    for (auto bx = 0ul; bx < blocks(); ++bx) {
+      fn(std::span<T const>(buf.data(), decode_block(bx, buf.data())));
+    }
+  }
+
+  template <class Alloc = std::allocator<T>>
+  std::vector<T, Alloc> to_vector(Alloc const & al = Alloc()) const {
+    std::vector<T, Alloc> vec(al);
+    vec.reserve(size());
+    for_each_block([&vec](std::span<T const> vals) {
+      vec.insert(vec.end(), vals.begin(), vals.end());
+    });
+    return vec;
+  }
+
+private:
+  //  16 bytes per block: data offsets count groups of four words, which
+  //  every block fills exactly.
+  struct head {
+    std::uint64_t base;     //  frame: the minimum; delta: the value before the block
+    std::uint32_t offset;   //  in units of 4 words
+    std::uint8_t width;     //  0..32, or kernel::raw
+  };
+
+  //  wrapping two's-complement views of T.
+  static std::uint64_t to_u64(T val) noexcept {
+    if constexpr (std::is_signed_v<T>) {
+      return static_cast<std::uint64_t>(static_cast<std::int64_t>(val));
+    }
+    else {
+      return static_cast<std::uint64_t>(val);
+    }
+  }
+
+  static T from_u64(std::uint64_t val) noexcept { return static_cast<T>(val); }
+
+  static std::uint64_t zigzag(std::uint64_t val) noexcept {
+    return val << 1 ^ (0 - (val >> 63));
+  }
+
+  static std::uint64_t unzigzag(std::uint32_t code) noexcept {
+    return std::uint64_t(code >> 1) ^ (0 - std::uint64_t(code & 1));
+  }
+
+  static T unpacked(std::uint32_t code) noexcept {
+    return std::is_signed_v<T> ? from_u64(unzigzag(code)) : static_cast<T>(code);
+  }
+
+  //  pack the 128 values of the tail into a new block.
+  void seal() {
+    std::uint64_t codes[block];
+    head hd { 0, static_cast<std::uint32_t>(data_.size() / kernel::lanes), 0, };
+    switch (codec_) {
+    case codec::packed:
+      for (auto ix = 0ul; ix < block; ++ix) {
+        codes[ix] = std::is_signed_v<T> ? zigzag(to_u64(tail_[ix])) : to_u64(tail_[ix]);
+      }
+      break;
+    case codec::frame:
+      hd.base = to_u64(*std::min_element(tail_.begin(), tail_.end()));
+      for (auto ix = 0ul; ix < block; ++ix) {
+        codes[ix] = to_u64(tail_[ix]) - hd.base;
+      }
+      break;
+    case codec::delta:
+      hd.base = last_;
+      for (auto ix = 0ul; ix < block; ++ix) {
+        auto const prev = ix < kernel::lanes ? last_ : to_u64(tail_[ix - kernel::lanes]);
+        codes[ix] = zigzag(to_u64(tail_[ix]) - prev);
+      }
+      last_ = to_u64(tail_.back());
+      break;
+    }
+    auto const top = *std::max_element(codes, codes + block);
+    if (top > std::numeric_limits<std::uint32_t>::max()) {
+      hd.width = kernel::raw;
+      data_.resize(data_.size() + 2 * block);
+      auto const wp = data_.data() + hd.offset * kernel::lanes;
+      for (auto ix = 0ul; ix < block; ++ix) {
+        auto const val = to_u64(tail_[ix]);
+        wp[2 * ix] = static_cast<std::uint32_t>(val);
+        wp[2 * ix + 1] = static_cast<std::uint32_t>(val >> 32);
+      }
+    }
+    else {
+      hd.width = static_cast<std::uint8_t>(std::bit_width(top));
+      alignas(16) std::uint32_t narrow[block];
+      std::copy_n(codes, block, narrow);
+      data_.resize(data_.size() + hd.width * kernel::lanes);
+      kernel::pack_at[hd.width](narrow, data_.data() + hd.offset * kernel::lanes);
+    }
+    heads_.push_back(hd);
+    tail_.clear();
+  }
+
+  std::vector<head> heads_;
+  std::vector<std::uint32_t> data_;
+  std::vector<T> tail_;
+  std::uint64_t last_ { 0 };   //  delta: the last value sealed
+  codec codec_;
+};
+
+} /* namespace vecpack */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecsoa
+/*
+ *  soa_vector<field<"name", T>...>: a structure-of-arrays vector.  Each
+ *  field lives in its own std::vector, so a scan over one member reads only
+ *  that member's bytes and runs over a plain span the compiler can
+ *  vectorise.  The fields are named by string literals in the type, which
+ *  is all the reflection it needs:
+ *
+ *    using presidents = soa_vector<field<"name", std::string>,
+ *                                  field<"country", std::string>,
+ *                                  field<"year", int>>;
+ *    pres.emplace_back("Nelson Mandela"s, "South Africa"s, 1994);
+ *    std::span<int const> years = pres.column<"year">();
+ *
+ *  A row is a proxy, the vector and an index: row.get<"year">() is a
+ *  reference into the column.  It converts to value_type, a std::tuple of
+ *  the fields, and assigning a tuple or another row to it copies the values.
+ *
+ *  Every modifier keeps the columns the same length.  emplace_back pops the
+ *  columns it has grown if a later one throws.  erase, erase_if and sort
+ *  move every column the same way; sort orders an index permutation with
+ *  the row comparator, reserves the new columns, then moves each one
+ *  through the permutation once.  A bool field is rejected, since its column
+ *  would be a std::vector<bool>.
+ */
+namespace vecsoa {
+
+//  a string literal as a template argument.
+template <std::size_t N>
+struct label {
+  constexpr label(char const (&str)[N]) noexcept { std::copy_n(str, N, chars); }
+  constexpr std::string_view view() const noexcept { return { chars, N - 1, }; }
+  char chars[N] {};
+};
+
+template <label Name, typename T>
+struct field {
+  using type = T;
+  static constexpr std::string_view name = Name.view();
+};
+
+template <typename... Fields>
+class soa_vector {
+  static_assert(sizeof...(Fields) > 0, "vecsoa::soa_vector needs a field");
+  static_assert((!std::is_same_v<typename Fields::type, bool> && ...),
+                "vecsoa::soa_vector: use char for a bool field");
+
+  static constexpr std::array<std::string_view, sizeof...(Fields)> names_ { Fields::name..., };
+
+public:
+  using value_type = std::tuple<typename Fields::type...>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  static constexpr size_type columns = sizeof...(Fields);
+
+  template <label Name>
+  static constexpr size_type index_of() noexcept {
+    constexpr auto ix = size_type(std::find(names_.begin(), names_.end(), Name.view()) - names_.begin());
+    static_assert(ix < columns, "vecsoa::soa_vector: no such field");
+    return ix;
+  }
+
+  template <size_type Ix>
+  using type_at = std::tuple_element_t<Ix, value_type>;
+
+  template <bool Const>
+  class row {
+    using owner = std::conditional_t<Const, soa_vector const, soa_vector>;
+
+  public:
+    row(row const &) = default;
+
+    operator row<true>() const noexcept requires (!Const) { return { sv_, ix_, }; }
+
+    template <label Name>
+    auto & get() const noexcept { return get<index_of<Name>()>(); }
+
+    template <size_type Ix>
+    auto & get() const noexcept { return std::get<Ix>(sv_->cols_)[ix_]; }
+
+    size_type index() const noexcept { return ix_; }
+
+    operator value_type() const {
+      return [this]<size_type... Ix>(std::index_sequence<Ix...>) {
+        return value_type(get<Ix>()...);
+      }(std::make_index_sequence<columns>());
+    }
+
+    //  assignment copies the values, never the position.
+    row const & operator=(row const & other) const requires (!Const) {
+      return *this = value_type(other);
+    }
+
+    template <bool C>
+      requires (!Const && C)
+    row const & operator=(row<C> const & other) const {
+      return *this = value_type(other);
+    }
+
+    row const & operator=(value_type val) const requires (!Const) {
+      [&]<size_type... Ix>(std::index_sequence<Ix...>) {
+        ((get<Ix>() = std::move(std::get<Ix>(val))), ...);
+      }(std::make_index_sequence<columns>());
+      return *this;
+    }
+
+    friend void swap(row const & lhs, row const & rhs) requires (!Const) {
+      [&]<size_type... Ix>(std::index_sequence<Ix...>) {
+        using std::swap;
+        (swap(lhs.template get<Ix>(), rhs.template get<Ix>()), ...);
+      }(std::make_index_sequence<columns>());
+    }
+
+    friend bool operator==(row const & lhs, row const & rhs) {
+      return [&]<size_type... Ix>(std::index_sequence<Ix...>) {
+        return ((lhs.template get<Ix>() == rhs.template get<Ix>()) && ...);
+      }(std::make_index_sequence<columns>());
+    }
+
+  private:
+    friend class soa_vector;
+    row(owner * sv, size_type ix) noexcept : sv_(sv), ix_(ix) {}
+
+    owner * sv_;
+    size_type ix_;
+  };
+
+  using reference = row<false>;
+  using const_reference = row<true>;
+
+  template <bool Const>
+  class basic_iterator {
+    using owner = std::conditional_t<Const, soa_vector const, soa_vector>;
+
+  public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = soa_vector::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = row<Const>;
+
+    basic_iterator() = default;
+
+    operator basic_iterator<true>() const noexcept requires (!Const) { return { sv_, ix_, }; }
+
+    reference operator*() const noexcept { return { sv_, ix_, }; }
+    reference operator[](difference_type dn) const noexcept { return { sv_, ix_ + dn, }; }
+
+    basic_iterator & operator++() noexcept { ++ix_; return *this; }
+    basic_iterator & operator--() noexcept { --ix_; return *this; }
+    basic_iterator operator++(int) noexcept { auto tmp = *this; ++ix_; return tmp; }
+    basic_iterator operator--(int) noexcept { auto tmp = *this; --ix_; return tmp; }
+    basic_iterator & operator+=(difference_type dn) noexcept { ix_ += dn; return *this; }
+    basic_iterator & operator-=(difference_type dn) noexcept { ix_ -= dn; return *this; }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type dn) noexcept { return it += dn; }
+    friend basic_iterator operator+(difference_type dn, basic_iterator it) noexcept { return it += dn; }
+    friend basic_iterator operator-(basic_iterator it, difference_type dn) noexcept { return it -= dn; }
+
+    friend difference_type operator-(basic_iterator const & lhs, basic_iterator const & rhs) noexcept {
+      return difference_type(lhs.ix_) - difference_type(rhs.ix_);
+    }
+
+    friend bool operator==(basic_iterator const & lhs, basic_iterator const & rhs) noexcept {
+      return lhs.ix_ == rhs.ix_;
+    }
+
+    friend auto operator<=>(basic_iterator const & lhs, basic_iterator const & rhs) noexcept {
+      return lhs.ix_ <=> rhs.ix_;
+    }
+
+  private:
+    friend class soa_vector;
+    basic_iterator(owner * sv, size_type ix) noexcept : sv_(sv), ix_(ix) {}
+
+    owner * sv_ = nullptr;
+    size_type ix_ = 0;
+  };
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  soa_vector() = default;
+
+  soa_vector(std::initializer_list<value_type> il) {
+    reserve(il.size());
+    for (auto const & val : il) {
+      push_back(val);
+    }
+  }
+
+  /// Element access
+  reference operator[](size_type pos) noexcept { return { this, pos, }; }
+  const_reference operator[](size_type pos) const noexcept { return { this, pos, }; }
+
+  reference at(size_type pos) {
+    if (pos >= size()) {
+      throw std::out_of_range("vecsoa::soa_vector::at");
+    }
+    return (*this)[pos];
+  }
+
+  const_reference at(size_type pos) const {
+    if (pos >= size()) {
+      throw std::out_of_range("vecsoa::soa_vector::at");
+    }
+    return (*this)[pos];
+  }
+
+  reference front() noexcept { return (*this)[0]; }
+  const_reference front() const noexcept { return (*this)[0]; }
+  reference back() noexcept { return (*this)[size() - 1]; }
+  const_reference back() const noexcept { return (*this)[size() - 1]; }
+
+  //  one field's values, contiguous.
+  template <label Name>
+  std::span<type_at<index_of<Name>()>> column() noexcept {
+    return std::get<index_of<Name>()>(cols_);
+  }
+
+  template <label Name>
+  std::span<type_at<index_of<Name>()> const> column() const noexcept {
+    return std::get<index_of<Name>()>(cols_);
+  }
+
+  /// Iterators
+  iterator begin() noexcept { return { this, 0, }; }
+  iterator end() noexcept { return { this, size(), }; }
+  const_iterator begin() const noexcept { return { this, 0, }; }
+  const_iterator end() const noexcept { return { this, size(), }; }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+  /// Capacity
+  bool empty() const noexcept { return size() == 0; }
+  size_type size() const noexcept { return std::get<0>(cols_).size(); }
+
+  //  rows every column holds without reallocating.
+  size_type capacity() const noexcept {
+    auto cap = std::numeric_limits<size_type>::max();
+    each_column([&cap](auto const & col) { cap = std::min(cap, col.capacity()); });
+    return cap;
+  }
+
+  void reserve(size_type nv) {
+    each_column([nv](auto & col) { col.reserve(nv); });
+  }
+
+  void shrink_to_fit() {
+    each_column([](auto & col) { col.shrink_to_fit(); });
+  }
+
+  /// Modifiers
+  void clear() noexcept {
+    each_column([](auto & col) { col.clear(); });
+  }
+
+  //  one argument per field, in field order.
+  template <typename... Args>
+    requires (sizeof...(Args) == columns)
+  reference emplace_back(Args &&... args) {
+    auto const nv = size();
+    try {
+      [&]<size_type... Ix>(std::index_sequence<Ix...>) {
+        (std::get<Ix>(cols_).emplace_back(std::forward<Args>(args)), ...);
+      }(std::index_sequence_for<Args...>());
+    }
+    catch (...) {
+      each_column([nv](auto & col) {
+        if (col.size() > nv) {
+          col.pop_back();
+        }
+      });
+      throw;
+    }
+    return back();
+  }
+
+  void push_back(value_type const & val) {
+    std::apply([this](auto const &... vals) { emplace_back(vals...); }, val);
+  }
+
+  void push_back(value_type && val) {
+    std::apply([this](auto &... vals) { emplace_back(std::move(vals)...); }, val);
+  }
+
+  void pop_back() noexcept {
+    each_column([](auto & col) { col.pop_back(); });
+  }
+
+  iterator erase(const_iterator pos) {
+    return erase(pos, pos + 1);
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    each_column([first, last](auto & col) {
+      col.erase(col.begin() + first.ix_, col.begin() + last.ix_);
+    });
+    return { this, first.ix_, };
+  }
+
+  //  std::erase_if for the rows: pred sees a const_reference.  The rows
+  //  kept are listed first, so each column is compacted without a branch.
+  template <typename Pred>
+  friend size_type erase_if(soa_vector & sv, Pred pred) {
+    auto const nv = sv.size();
+    auto first = 0ul;
+    while (first < nv && !pred(std::as_const(sv)[first])) {
+      ++first;
+    }
+    if (first == nv) {
+      return 0;
+    }
+    std::vector<size_type> kept(nv - first - 1);
+    auto nk = 0ul;
+    for (auto ix = first + 1; ix < nv; ++ix) {
+      kept[nk] = ix;
+      nk += !pred(std::as_const(sv)[ix]);
+    }
+    kept.resize(nk);
+    sv.each_column([&kept, first](auto & col) {
+      auto out = first;
+      for (auto ix : kept) {
+        col[out++] = std::move(col[ix]);
+      }
+      col.erase(col.begin() + out, col.end());
+    });
+    return nv - first - kept.size();
+  }
+
+  //  comp(const_reference, const_reference) orders the rows.
+  template <typename Compare>
+  void sort(Compare comp) {
+    std::vector<size_type> order(size());
+    std::iota(order.begin(), order.end(), size_type(0));
+    std::sort(order.begin(), order.end(), [this, &comp](size_type lhs, size_type rhs) {
+      return comp(std::as_const(*this)[lhs], std::as_const(*this)[rhs]);
+    });
+    permute(order);
+  }
+
+  //  ascending by one field.
+  template <label Name, typename Compare = std::less<>>
+  void sort_by(Compare comp = Compare()) {
+    auto const & col = std::get<index_of<Name>()>(cols_);
+    std::vector<size_type> order(size());
+    std::iota(order.begin(), order.end(), size_type(0));
+    std::sort(order.begin(), order.end(), [&col, &comp](size_type lhs, size_type rhs) {
+      return comp(col[lhs], col[rhs]);
+    });
+    permute(order);
+  }
+
+  void swap(soa_vector & other) noexcept { cols_.swap(other.cols_); }
+
+  friend bool operator==(soa_vector const & lhs, soa_vector const & rhs) {
+    return lhs.cols_ == rhs.cols_;
+  }
+
+private:
+  template <typename Fn>
+  void each_column(Fn && fn) {
+    std::apply([&fn](auto &... col) { (fn(col), ...); }, cols_);
+  }
+
+  template <typename Fn>
+  void each_column(Fn && fn) const {
+    std::apply([&fn](auto const &... col) { (fn(col), ...); }, cols_);
+  }
+
+  //  row ix of the result is row order[ix] now.  The new columns are all
+  //  reserved before anything moves, so an allocation failure leaves the
+  //  rows as they were.
+  void permute(std::vector<size_type> const & order) {
+    decltype(cols_) out;
+    std::apply([&order](auto &... col) { (col.reserve(order.size()), ...); }, out);
+    [&]<size_type... Ix>(std::index_sequence<Ix...>) {
+      (gather(std::get<Ix>(out), std::get<Ix>(cols_), order), ...);
+    }(std::make_index_sequence<columns>());
+    cols_.swap(out);
+  }
+
+  template <typename T>
+  static void gather(std::vector<T> & dst, std::vector<T> & src, std::vector<size_type> const & order) {
+    for (auto ix : order) {
+      dst.push_back(std::move(src[ix]));
+    }
+  }
+
+  std::tuple<std::vector<typename Fields::type>...> cols_;
+};
+
+} /* namespace vecsoa */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+/*
+ *  MARK: C_vector()
+ */
+int C_vector(int argc, const char * argv[]) {
+  std::cout << "In "s << __func__ << std::endl;
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector"s << '\n';
+  {
+    perf::section const sect("std::vector"s);
+    // Create a vector containing integers
+    std::vector<int> vnr = { 7, 5, 16, 8, };
+
+    // Add two more integers to vector
+    vnr.push_back(25);
+    vnr.push_back(13);
+
+    // Print out the vector
+    std::cout << "v = { "s;
+    for (int nr : vnr) {
+      std::cout << nr << ", "s;
+    }
+    std::cout << "}; \n"s;
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  /// Constructors
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - constructor"s << '\n';
+  {
+    perf::section const sect("std::vector - constructor"s);
+    using namespace vec;
+
+    // c++11 initializer list syntax:
+    std::vector<std::string> words1 { "the"s, "frogurt"s, "is"s, "also"s, "cursed"s, };
+    std::cout << "words1: "s << words1 << '\n';
+
+    // words2 == words1
+    std::vector<std::string> words2(words1.begin(), words1.end());
+    std::cout << "words2: "s << words2 << '\n';
+
+    // words3 == words1
+    std::vector<std::string> words3(words1);
+    std::cout << "words3: "s << words3 << '\n';
+
+    // words4 is {"Mo", "Mo", "Mo", "Mo", "Mo"}
+    std::vector<std::string> words4(5, "Mo");
+    std::cout << "words4: "s << words4 << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "vecfmt - buffered printers"s << '\n';
+  {
+    perf::section const sect("vecfmt - buffered printers"s);
+    std::vector<std::string> words { "the"s, "frogurt"s, "is"s, "also"s, "cursed"s, };
+    std::vector<int> vnr { 7, 5, 16, 8, 25, 13, };
+    std::vector<bool> vbl { true, false, true, };
+
+    std::cout << "style::vec:    "s;
+    vecfmt::print(std::cout, words);
+    std::cout << ' ';
+    vecfmt::print(std::cout, vnr);
+    std::cout << '\n';
+
+    std::cout << "style::vecpop: "s;
+    vecfmt::print(std::cout, vnr, vecfmt::style::vecpop);
+
+    std::cout << "style::vecswp: "s;
+    vecfmt::print(std::cout, vnr, vecfmt::style::vecswp);
+    std::cout << std::boolalpha;
+    vecfmt::print(std::cout, vbl, vecfmt::style::vecswp);
+    std::cout << std::noboolalpha << '\n';
+
+    //  one writer for several containers: a single write at the end.
+    {
+      vecfmt::writer out(stdout);
+      std::cout.flush();
+      out << std::string_view("fwrite:        ");
+      vecfmt::print(out, std::vector<double> { 0.5, 1.0 / 3.0, 1e20, }) << '\n';
+    }
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - constructor, custom allocator"s << '\n';
+  {
+    perf::section const sect("std::vector - constructor, custom allocator"s);
+    auto cc(0ul);
+    auto constexpr cc_max(10ul);
+    auto sp(4);
+    auto prtnumeric = [&cc, &sp](auto el) {
+      std::cout << std::setw(sp) << el
+      << (++cc % cc_max == 0 ? "\n"s : ""s);
+    };
+
+    std::vector<int, valc::Mallocator<int>> vnr(8);
+    std::cout << "initial size: "s << std::setw(4) << vnr.size()
+              << ", capacity: "s << std::setw(6) << vnr.capacity()
+              << '\n';
+
+    if (!vnr.empty()) {
+      std::cout << vnr.data() << '\n';
+      cc = 0ul;
+      sp = 4ul;
+      std::for_each(vnr.cbegin(), vnr.cend(), prtnumeric);
+      std::cout << '\n';
+    }
+    std::cout << "add a value.\n"s;
+    vnr.push_back(42);
+
+    std::cout << "add a value.\n"s;
+    for (auto nr : { -42, 21, 77, -0, -1, 0, 666, 33, -99, 3, }) {
+      std::cout << "adding "s << std::setw(4) << nr << '\n';
+      vnr.push_back(nr);
+    }
+
+    std::cout << vnr.data() << '\n';
+    std::cout << "new size: "s << std::setw(4) << vnr.size()
+              << ", capacity: "s << std::setw(6) << vnr.capacity()
+              << '\n';
+    cc = 0ul;
+    sp = 4ul;
+    std::for_each(vnr.cbegin(), vnr.cend(), prtnumeric);
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - custom allocator, ring trace"s << '\n';
+  {
+    perf::section const sect("std::vector - custom allocator, ring trace"s);
+    //  same growth as above, but the allocator events go to the
+    //  per-thread trace rings and are printed in one batch.
+    {
+      valc::trace::mode_scope const traced(valc::trace::mode::ring);
+      std::vector<int, valc::Mallocator<int>> vnr(8);
+      for (auto nr : { 42, -42, 21, 77, -0, -1, 0, 666, 33, -99, 3, }) {
+        vnr.push_back(nr);
+      }
+      std::cout << "new size: "s << std::setw(4) << vnr.size()
+                << ", capacity: "s << std::setw(6) << vnr.capacity()
+                << '\n';
+    }
+
+    auto & tc = valc::trace::collector::instance();
+    auto const drained = tc.drain(std::cout);
+    std::cout << "drained "s << drained << " events, dropped "s
+              << tc.dropped() << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - custom allocator, arena"s << '\n';
+  {
+    perf::section const sect("std::vector - custom allocator, arena"s);
+    auto & ar = valc::arena::local();
+    {
+      valc::arena::scope outer;
+      std::vector<int, valc::ArenaAllocator<int>> vnr { 7, 5, 16, 8, };
+      for (auto nr : { 42, -42, 21, 77, -0, -1, 0, 666, 33, -99, 3, }) {
+        vnr.push_back(nr);
+      }
+      std::cout << "outer size: "s << std::setw(4) << vnr.size()
+                << ", capacity: "s << std::setw(6) << vnr.capacity()
+                << '\n';
+      ar.report();
+      {
+        //  nested scope: released on exit, outer vnr is untouched.
+        valc::arena::scope inner;
+        std::vector<long, valc::ArenaAllocator<long>> vlg(100);
+        std::iota(vlg.begin(), vlg.end(), 0l);
+        std::cout << "inner size: "s << std::setw(4) << vlg.size() << '\n';
+        ar.report();
+      }
+      ar.report();
+    }
+    ar.report();
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - custom allocator, bulk append"s << '\n';
+  {
+    perf::section const sect("std::vector - custom allocator, bulk append"s);
+    //  each append grows the storage once: one Mallocator allocate per call
+    //  instead of one per capacity doubling.
+    std::array const values { 42, -42, 21, 77, -0, -1, 0, 666, 33, -99, 3, };
+
+    vecgrw::growth_vector<int, valc::Mallocator<int>> vnr;
+    std::cout << "append "s << values.size() << " values.\n"s;
+    vecapp::append(vnr, values);
+    vecpop::print(vnr);
+
+    std::cout << "append 5 squares.\n"s;
+    vecapp::append_n(vnr, 5, [](std::size_t ix) { return static_cast<int>(ix * ix); });
+    vecpop::print(vnr);
+
+    std::istringstream is("7 5 16 8 25 13\n100 200 300 400 500 600 700"s);
+    std::cout << "append from a stream.\n"s;
+    auto const count = vecapp::append_from(vnr, is);
+    std::cout << "read "s << count << " values.\n"s;
+    vecpop::print(vnr);
+
+    std::vector<int, valc::Mallocator<int>> vstd;
+    std::cout << "std::vector, append "s << values.size() << " values.\n"s;
+    vecapp::append(vstd, values);
+    vecpop::print(vstd);
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  /// Container functions
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - operator="s << '\n';
+  {
+    perf::section const sect("std::vector - operator="s);
+    auto display_sizes = [](std::string comment,
+                            std::vector<int> const & nums1,
+                            std::vector<int> const & nums2,
+                            std::vector<int> const & nums3) {
+      std::cout << comment
+                << " nums1: "s << nums1.size() << ','
+                << " nums2: "s << nums2.size() << ','
+                << " nums3: "s << nums3.size() << '\n';
+    };
+
+    auto display = [](std::string comment, std::vector<int> const & vec) {
+      std::cout << comment << "{ "s;
+      for (int el : vec) {
+        std::cout << el << ' ';
+      }
+      std::cout << "}\n"s;
+    };
+
+    std::vector<int> nums1 { 3, 1, 4, 6, 5, 9, };
+    std::vector<int> nums2;
+    std::vector<int> nums3;
+
+    display_sizes("Initially:\n"s, nums1, nums2, nums3);
+//    display_sizes(co, nums1, nums2, nums3);
+
+    // copy assignment copies data from nums1 to nums2
+    nums2 = nums1;
+
+    display_sizes("After assignment:\n"s, nums1, nums2, nums3);
+
+    // move assignment moves data from nums1 to nums3,
+    // modifying both nums1 and nums3
+    nums3 = std::move(nums1);
+
+    display_sizes("After move assignment:\n"s, nums1, nums2, nums3);
+
+    display("Now nums3 = "s, nums3);
+
+    // copy assignment of an initializer_list copies data to nums3
+    nums3 = { 1, 2, 3, };
+
+    display("After assignment of initializer_list \n nums3 = "s, nums3);
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - assign"s << '\n';
+  {
+    perf::section const sect("std::vector - assign"s);
+    std::vector<char> characters;
+
+    auto print_vector = [&](){
+      for (char ch : characters) {
+        std::cout << ch << ' ';
+      }
+      std::cout << '\n';
+    };
+
+    characters.assign(5, 'a');
+    print_vector();
+
+    const std::string extra(6, 'b');
+    characters.assign(extra.begin(), extra.end());
+    print_vector();
+
+    characters.assign({ 'C', '+', '+', '1', '1', });
+    print_vector();
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - get_allocator"s << '\n';
+  {
+    perf::section const sect("std::vector - get_allocator"s);
+    std::vector<long> vb1(8);
+    std::vector<long, valc::Mallocator<long>> vb2(8);
+    std::vector<long, valc::Mallocator<long>> vb3(8);
+    std::vector<uint8_t, valc::Mallocator<uint8_t>> vb4(8);
+
+    [[maybe_unused]]
+    auto vb1_al = vb1.get_allocator();
+    auto vb2_al = vb2.get_allocator();
+    auto vb3_al = vb3.get_allocator();
+    auto vb4_al = vb4.get_allocator();
+
+    std::cout << std::boolalpha;
+    auto vb2_al_eq_vb2_al  = vb2_al == vb2_al;
+    auto vb2_al_neq_vb2_al = vb2_al != vb2_al;
+    std::cout << "vb2_al == vb2_al: "s << vb2_al_eq_vb2_al  << '\n';
+    std::cout << "vb2_al != vb2_al: "s << vb2_al_neq_vb2_al << '\n';
+
+    auto vb2_al_eq_vb3_al  = vb2_al == vb3_al;
+    auto vb2_al_neq_vb3_al = vb2_al != vb3_al;
+    std::cout << "vb2_al == vb3_al: "s << vb2_al_eq_vb3_al  << '\n';
+    std::cout << "vb2_al != vb3_al: "s << vb2_al_neq_vb3_al << '\n';
+
+    auto vb2_al_eq_vb4_al  = vb2_al == vb4_al;
+    auto vb2_al_neq_vb4_al = vb2_al != vb4_al;
+    std::cout << "vb2_al == vb4_al: "s << vb2_al_eq_vb4_al  << '\n';
+    std::cout << "vb2_al != vb4_al: "s << vb2_al_neq_vb4_al << '\n';
+    std::cout << std::noboolalpha;
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "vecpack::packed_vector - bit-packed, frame-of-reference, delta"s << '\n';
+  {
+    perf::section const sect("vecpack::packed_vector - bit-packed, frame-of-reference, delta"s);
+    using vecpack::codec;
+
+    //  vb1 above: std::vector<long>(8) spends 64 bits on each zero.
+    vecpack::packed_vector<long> zeros;
+    for (auto ix = 0; ix < 1024; ++ix) {
+      zeros.push_back(0);
+    }
+    zeros.shrink_to_fit();
+    std::cout << "1024 zero longs: std::vector<long> "s << 1024 * sizeof(long)
+              << " bytes, packed_vector<long> "s << zeros.bytes() << " bytes\n"s;
+
+    std::mt19937_64 rng(42);
+    std::vector<int> small, sorted, signs;
+    for (auto ix = 0, stamp = 1'000'000; ix < 4096; ++ix) {
+      small.push_back(static_cast<int>(rng() % 1000));
+      sorted.push_back(stamp += static_cast<int>(rng() % 16));
+      signs.push_back(static_cast<int>(rng() % 201) - 100);
+    }
+    std::cout << "bytes per value (std::vector<int>: 4):\n"s << std::fixed << std::setprecision(2);
+    for (auto const & [name, vals] : { std::pair { "0..999"s, &small, },
+                                       std::pair { "sorted, gaps 0..15"s, &sorted, },
+                                       std::pair { "-100..100"s, &signs, }, }) {
+      std::cout << std::setw(20) << name << ':';
+      for (auto cd : { codec::packed, codec::frame, codec::delta, }) {
+        vecpack::packed_vector<int> pv(vals->begin(), vals->end(), cd);
+        pv.shrink_to_fit();
+        std::cout << "  "s << vecpack::name(cd) << ' '
+                  << static_cast<double>(pv.bytes()) / static_cast<double>(pv.size());
+      }
+      std::cout << '\n';
+    }
+    std::cout << std::defaultfloat;
+
+    vecpack::packed_vector<int> pv(sorted.begin(), sorted.end(), codec::delta);
+    pv.push_back(-5);
+    std::cout << "delta: size "s << pv.size() << ", blocks "s << pv.blocks()
+              << ", pv[0] "s << pv[0] << ", pv[1000] "s << pv[1000] << " (sorted[1000] "s
+              << sorted[1000] << "), back "s << pv.back() << ", first values:"s;
+    auto it = pv.begin();
+    for (auto ix = 0; ix < 6; ++ix, ++it) {
+      std::cout << ' ' << *it;
+    }
+    std::cout << '\n';
+    try {
+      static_cast<void>(pv.at(pv.size()));
+    }
+    catch (std::out_of_range const & ex) {
+      std::cout << "at(size()): std::out_of_range: "s << ex.what() << '\n';
+    }
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  /// Element access
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - at"s << '\n';
+  {
+    perf::section const sect("std::vector - at"s);
+    std::vector<int> data = { 1, 2, 4, 5, 5, 6, };
+
+    // Set element 1
+    data.at(1) = 88;
+
+    // Read element 2
+    std::cout << "Element at index 2 has value "s << data.at(2) << '\n';
+
+    std::cout << "data size = "s << data.size() << '\n';
+
+    try {
+      // Set element 6
+      data.at(6) = 666;
+    }
+    catch (std::out_of_range const & exc) {
+      std::cout << exc.what() << '\n';
+    }
+
+    // Print final values
+    std::cout << "data:"s;
+    std::for_each(data.cbegin(), data.cend(), [](auto elem) {
+      std::cout << ' ' << elem;
+    });
+    std::cout << '\n';
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - operator[]"s << '\n';
+  {
+    perf::section const sect("std::vector - operator[]"s);
+    std::vector<int> numbers { 2, 4, 6, 8, };
+
+    std::cout << "Second element: "s << numbers[1] << '\n';
+
+    numbers[0] = 5;
+
+    std::cout << "All numbers:"s;
+    std::for_each(numbers.cbegin(), numbers.cend(), [](auto elem) {
+      std::cout << ' ' << elem;
+    });
+    std::cout << '\n';
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - front, back"s << '\n';
+  {
+    perf::section const sect("std::vector - front, back"s);
+    {
+      std::vector<char> letters { 'o', 'm', 'g', 'w', 't', 'f', };
+
+      if (!letters.empty()) {
+        std::cout << "The first character is '"s << letters.front() << "'.\n"s;
+      }
+    }
+    std::cout << '\n';
+
+    {
+      std::vector<char> letters { 'a', 'b', 'c', 'd', 'e', 'f', };
+
+      if (!letters.empty()) {
+        std::cout << "The last character is '"s << letters.back() << "'.\n"s;
+      }
+    }
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - data"s << '\n';
+  {
+    perf::section const sect("std::vector - data"s);
+    auto pointer_func = [](const int* p, std::size_t size) {
+      std::cout << "data = "s;
+      for (std::size_t i_ = 0; i_ < size; ++i_) {
+        std::cout << p[i_] << ' ';
+      }
+      std::cout << '\n';
+    };
+     
+    auto span_func = [](std::span<const int> data) {  // since C++20
+      std::cout << "data = "s;
+      for (const int e_ : data) {
+        std::cout << e_ << ' ';
+      }
+      std::cout << '\n';
+    };
+
+    std::vector<int> container { 1, 2, 3, 4, };
+
+    // Prefer container.data() over &container[0]
+    pointer_func(container.data(), container.size());
+
+    // std::span (C++20) is a safer alternative to separated pointer/size.
+    span_func({container.data(), container.size()});
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  /// Iterators
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - begin, end, etc."s << '\n';
+  {
+    perf::section const sect("std::vector - begin, end, etc."s);
+    std::cout << "std::vector - begin, end"s << '\n';
+    {
+      std::vector<int> nums { 1, 2, 4, 8, 16, };
+      std::vector<std::string> fruits { "orange"s, "apple"s, "raspberry"s, };
+      std::vector<char> empty;
+
+      // Print vector.
+      std::for_each(nums.begin(), nums.end(), [](const int n_) {
+        std::cout << n_ << ' ';
+      });
+      std::cout << '\n';
+
+      // Sums all integers in the vector nums (if any), printing only the result.
+      std::cout << "Sum of nums: "s
+                << std::accumulate(nums.begin(), nums.end(), 0) << '\n';
+
+      // Prints the first fruit in the vector fruits, checking if there is any.
+      if (!fruits.empty()) {
+        std::cout << "First fruit: "s << *fruits.begin() << '\n';
+      }
+
+      if (empty.begin() == empty.end()) {
+        std::cout << "vector 'empty' is indeed empty.\n"s;
+      }
+    }
+    std::cout << '\n';
+
+    std::cout << "std::vector - rbegin, rend"s << '\n';
+    {
+      std::vector<int> nums { 1, 2, 4, 8, 16, };
+      std::vector<std::string> fruits { "orange"s, "apple"s, "raspberry"s, };
+      std::vector<char> empty;
+
+      // Print vector.
+      std::for_each(nums.rbegin(), nums.rend(), [](const int n_) {
+        std::cout << n_ << ' ';
+      });
+      std::cout << '\n';
+
+      // Sums all integers in the vector nums (if any), printing only the result.
+      std::cout << "Sum of nums: "s
+                << std::accumulate(nums.rbegin(), nums.rend(), 0) << '\n';
+
+      // Prints the first fruit in the vector fruits, checking if there is any.
+      if (!fruits.empty()) {
+        std::cout << "First fruit: "s << *fruits.rbegin() << '\n';
+      }
+
+      if (empty.rbegin() == empty.rend()) {
+        std::cout << "vector 'empty' is indeed empty.\n"s;
+      }
+    }
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  /// Capaciity
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - empty"s << '\n';
+  {
+    perf::section const sect("std::vector - empty"s);
+    std::cout << std::boolalpha;
+    std::vector<int> numbers;
+    std::cout << "Initially, numbers.empty(): "s
+              << numbers.empty() << '\n';
+
+    numbers.push_back(42);
+    std::cout << "After adding elements, numbers.empty(): "s
+              << numbers.empty() << '\n';
+    std::cout << std::noboolalpha;
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - size"s << '\n';
+  {
+    perf::section const sect("std::vector - size"s);
+    std::vector<int> nums { 1, 3, 5, 7, };
+
+    std::cout << "nums contains "s << nums.size() << " elements.\n"s;
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - max_size"s << '\n';
+  {
+    perf::section const sect("std::vector - max_size"s);
+    std::vector<char> svec;
+    std::cout << "Maximum size of a 'vector' is "s << svec.max_size() << "\n"s;
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - reserve"s << '\n';
+  {
+    perf::section const sect("std::vector - reserve"s);
+    int sz = 100;
+    std::cout << "using reserve: \n"s;
+    {
+      perf::section const path("std::vector - reserve: using reserve"s);
+      std::vector<int, vecrsv::NAlloc<int>> v1;
+      v1.reserve(sz);
+      for (int n_ = 0; n_ < sz; ++n_) {
+        v1.push_back(n_);
+      }
+    }
+    std::cout << "not using reserve: \n"s;
+    {
+      perf::section const path("std::vector - reserve: not using reserve"s);
+      std::vector<int, vecrsv::NAlloc<int>> v1;
+        for (int n_ = 0; n_ < sz; ++n_) {
+          v1.push_back(n_);
+        }
+    }
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - reserve, allocation statistics"s << '\n';
+  {
+    perf::section const sect("std::vector - reserve, allocation statistics"s);
+    //  the same two loops with the per-call output off (until the end of
+    //  the block, so kept is freed quietly): the registry shows where the
+    //  allocations and the growth copies come from.
+    int sz = 100;
+    auto const was_enabled = valc::stats::enabled();
+    valc::stats::enable();
+    valc::trace::mode_scope const quiet(valc::trace::mode::off);
+    {
+      valc::stats::site here("reserve");
+      std::vector<int, vecrsv::NAlloc<int>> v1;
+      v1.reserve(sz);
+      for (int n_ = 0; n_ < sz; ++n_) {
+        v1.push_back(n_);
+      }
+    }
+    {
+      valc::stats::site here("no reserve");
+      std::vector<int, vecrsv::NAlloc<int>> v1;
+      for (int n_ = 0; n_ < sz; ++n_) {
+        v1.push_back(n_);
+      }
+    }
+    std::vector<double, valc::Mallocator<double>> kept;
+    {
+      valc::stats::site here("kept");
+      for (int n_ = 0; n_ < sz; ++n_) {
+        kept.push_back(n_ * 0.5);
+      }
+    }
+    valc::stats::enable(was_enabled);
+
+    auto rcs = valc::stats::snapshot();
+    std::erase_if(rcs, [](valc::stats::record const & rc) {
+      return rc.site != "reserve"s && rc.site != "no reserve"s && rc.site != "kept"s;
+    });
+    valc::stats::report(rcs);
+    std::cout << '\n';
+    valc::stats::json(rcs, std::cout);
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - reserve, pool allocator"s << '\n';
+  {
+    perf::section const sect("std::vector - reserve, pool allocator"s);
+    //  the same unreserved growth cascade, repeated: after the first
+    //  round every growth buffer comes back out of the pool.
+    int sz = 100;
+    for (int rn = 1; rn <= 3; ++rn) {
+      valc::pool::reset_stats();
+      {
+        std::vector<int, valc::PoolAllocator<int>> v1;
+        for (int n_ = 0; n_ < sz; ++n_) {
+          v1.push_back(n_);
+        }
+      }
+      std::cout << "round "s << rn << ":\n"s;
+      valc::pool::report();
+    }
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - capacity"s << '\n';
+  {
+    perf::section const sect("std::vector - capacity"s);
+    int sz = 200;
+    std::vector<int> v1;
+
+    auto cap = v1.capacity();
+    std::cout << "initial capacity=" << cap << '\n';
+
+    for (int n_ = 0; n_ < sz; ++n_) {
+      v1.push_back(n_);
+      if (cap != v1.capacity()) {
+        cap = v1.capacity();
+        std::cout << "new capacity="s << cap << '\n';
+      }
+    }
+
+    std::cout << "final size="s << v1.size() << '\n';
+    std::cout << "final capacity="s << v1.capacity() << '\n';
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "vecgrw::growth_vector - capacity, growth policy"s << '\n';
+  {
+    perf::section const sect("vecgrw::growth_vector - capacity, growth policy"s);
+    //  same loop as above with a 1.5x policy on valc::Mallocator; int is
+    //  trivially copyable so every growth step is a realloc.
+    auto capacities = [](auto & v1, int sz) {
+      auto cap = v1.capacity();
+      auto moved(0ul);
+      for (int n_ = 0; n_ < sz; ++n_) {
+        auto const before = v1.data();
+        v1.push_back(n_);
+        if (cap != v1.capacity()) {
+          cap = v1.capacity();
+          moved += before != nullptr && before != v1.data();
+          std::cout << ' ' << cap;
+        }
+      }
+      std::cout << "\nfinal size="s << v1.size()
+                << ", final capacity="s << v1.capacity()
+                << ", buffer moved "s << moved << " times\n"s;
+    };
+
+    {
+      valc::trace::mode_scope const quiet(valc::trace::mode::off);
+      std::cout << "2x:  "s;
+      vecgrw::growth_vector<int, valc::Mallocator<int>> v2x;
+      capacities(v2x, 200);
+
+      std::cout << "1.5x:"s;
+      vecgrw::growth_vector<int, valc::Mallocator<int>, vecgrw::growth_1_5x> v15x;
+      capacities(v15x, 200);
+
+      v15x.resize(50);
+      v15x.shrink_to_fit();
+      std::cout << "Capacity after resize(50), shrink_to_fit() is "s
+                << v15x.capacity() << '\n';
+    }
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - shrink_to_fit"s << '\n';
+  {
+    perf::section const sect("std::vector - shrink_to_fit"s);
+    std::vector<int> vec;
+    std::cout << "Default-constructed capacity is "s << vec.capacity() << '\n';
+    vec.resize(100);
+    std::cout << "Capacity of a 100-element vector is "s << vec.capacity() << '\n';
+    vec.resize(50);
+    std::cout << "Capacity after resize(50) is " << vec.capacity() << '\n';
+    vec.shrink_to_fit();
+    std::cout << "Capacity after shrink_to_fit() is "s << vec.capacity() << '\n';
+    vec.clear();
+    std::cout << "Capacity after clear() is "s << vec.capacity() << '\n';
+    vec.shrink_to_fit();
+    std::cout << "Capacity after shrink_to_fit() is "s << vec.capacity() << '\n';
+    for (int i_ = 1000; i_ < 1300; ++i_) {
+      vec.push_back(i_);
+    }
+    std::cout << "Capacity after adding 300 elements is "s << vec.capacity() << '\n';
+    vec.shrink_to_fit();
+    std::cout << "Capacity after shrink_to_fit() is "s << vec.capacity() << '\n';
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+#if defined(VALC_MAPPED)
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "valc::MappedAllocator - file-backed storage"s << '\n';
+  {
+    perf::section const sect("valc::MappedAllocator - file-backed storage"s);
+    //  the push_back, reserve, resize and shrink_to_fit sections again, on
+    //  file-backed storage.
+    auto sections = [](auto vec, char const * name) {
+      std::cout << name << '\n';
+      vec.push_back(5);
+      vec.push_back(3);
+      vec.push_back(4);
+      std::cout << "push_back 5, 3, 4: "s;
+      vecpop::print(vec);
+      vec.reserve(100);
+      std::cout << "Capacity after reserve(100) is "s << vec.capacity()
+                << ", size is "s << vec.size() << '\n';
+      vec.resize(5);
+      std::cout << "resize(5): "s;
+      vecpop::print(vec);
+      vec.resize(2);
+      std::cout << "resize(2): "s;
+      vecpop::print(vec);
+      vec.resize(6, 4);
+      std::cout << "resize(6, 4): "s;
+      vecpop::print(vec);
+      vec.clear();
+      vec.shrink_to_fit();
+      std::cout << "Capacity after clear(), shrink_to_fit() is "s << vec.capacity() << '\n';
+      for (int i_ = 1000; i_ < 1300; ++i_) {
+        vec.push_back(i_);
+      }
+      vec.resize(250);
+      vec.shrink_to_fit();
+      std::cout << "Capacity after adding 300 elements, resize(250), shrink_to_fit() is "s
+                << vec.capacity() << ", back() is "s << vec.back() << '\n';
+    };
+    sections(std::vector<int, valc::MappedAllocator<int>>(), "std::vector<int, MappedAllocator>");
+    sections(vecgrw::growth_vector<int, valc::MappedAllocator<int>>(),
+             "growth_vector<int, MappedAllocator> (grows with ftruncate + mremap)");
+
+    //  persistence: std::vector grows by allocate, copy, free, and the
+    //  named file follows the newest block; sync() fixes the file's length.
+    auto const path = (std::filesystem::temp_directory_path() / "vectors_mapped.bin").string();
+    std::filesystem::remove(path);
+    {
+      using alloc = valc::DefaultInitAllocator<valc::MappedAllocator<int>>;
+      std::vector<int, alloc> vnr(alloc(valc::MappedAllocator<int>(
+        valc::mapped::store::persistent(path, valc::mapped::advice::sequential))));
+      for (int nr = 0; nr < 1000; ++nr) {
+        vnr.push_back(nr * nr);
+      }
+      vnr.get_allocator().sync(vnr.data(), vnr.size());
+    }
+    std::cout << "\nstd::vector wrote "s << std::filesystem::file_size(path)
+              << " bytes to "s << path << '\n';
+
+    //  reopen: claim the persisted elements first, then carry on.
+    {
+      auto const st = valc::mapped::store::persistent(path);
+      vecgrw::growth_vector<int, valc::MappedAllocator<int>> vnr { valc::MappedAllocator<int>(st) };
+      vnr.resize_for_overwrite(st->persisted() / sizeof(int));
+      std::cout << "reopened "s << vnr.size() << " elements, vnr[999] is "s << vnr[999] << '\n';
+      vnr.push_back(-1);
+      vnr.get_allocator().sync(vnr.data(), vnr.size());
+    }
+    std::ifstream is(path, std::ios::binary);
+    std::array<int, 10> back {};
+    is.read(reinterpret_cast<char *>(back.data()), sizeof back);
+    std::cout << "file is "s << std::filesystem::file_size(path) << " bytes, it starts "s;
+    vecpop::print(back);
+    std::filesystem::remove(path);
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+#endif  /* defined(VALC_MAPPED) */
+
+#if defined(VALC_HUGE)
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "valc::HugePageAllocator - large pages, NUMA placement"s << '\n';
+  {
+    perf::section const sect("valc::HugePageAllocator - large pages, NUMA placement"s);
+    //  small blocks come from malloc; from 2 MiB up the block is mapped.
+    std::vector<int, valc::HugePageAllocator<int>> vnr;
+    vnr.reserve(1'000);
+    vnr.reserve(1'000'000);
+
+    valc::huge::policy interleave;
+    interleave.placement = valc::huge::numa::interleave;
+    std::vector<int, valc::HugePageAllocator<int>> spread(valc::HugePageAllocator<int> { interleave });
+    spread.reserve(1'000'000);
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+#endif  /* defined(VALC_HUGE) */
+
+  /// Modifiers
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - clear"s << '\n';
+  {
+    perf::section const sect("std::vector - clear"s);
+    std::vector<int> container { 1, 2, 3, };
+     
+    auto print = [](const int& n) { std::cout << " " << n; };
+
+    std::cout << "Before clear:";
+    std::for_each(container.begin(), container.end(), print);
+    std::cout << "\nSize=" << container.size()
+              << ", Capacity=" << container.capacity() << '\n';
+
+    std::cout << "Clear\n";
+    container.clear();
+
+    std::cout << "After clear:";
+    std::for_each(container.begin(), container.end(), print);
+    std::cout << "\nSize=" << container.size()
+              << ", Capacity=" << container.capacity() << '\n';
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - insert"s << '\n';
+  {
+    perf::section const sect("std::vector - insert"s);
+    auto print_vec = [](const std::vector<int>& vec) {
+        for (auto x_ : vec) {
+             std::cout << ' ' << x_ ;
+        }
+        std::cout << '\n';
+    };
+
+    std::vector<int> vec(3, 100);
+    print_vec(vec);
+
+    auto it = vec.begin();
+    it = vec.insert(it, 200);
+    print_vec(vec);
+
+    vec.insert(it, 2, 300);
+    print_vec(vec);
+
+    // "it" no longer valid, get a new one:
+    it = vec.begin();
+
+    std::vector<int> vec2(2, 400);
+    vec.insert(it + 2, vec2.begin(), vec2.end());
+    print_vec(vec);
+
+    int arr[] = { 501, 502, 503, };
+    vec.insert(vec.begin(), arr, arr + 3);
+    print_vec(vec);
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - emplace"s << '\n';
+  {
+    perf::section const sect("std::vector - emplace"s);
+    struct Aempl {
+      std::string str;
+
+      Aempl(std::string str) : str(std::move(str))  {
+        std::cout << " constructed\n"s;
+      }
+
+      Aempl(const Aempl & other) : str(other.str) {
+        std::cout << " copy constructed\n"s;
+      }
+
+      Aempl(Aempl && other) : str(std::move(other.str)) {
+        std::cout << " move constructed\n"s;
+      }
+
+      Aempl & operator=(const Aempl & other) {
+        str = other.str;
+        std::cout << " copy assigned\n"s;
+        return *this;
+      }
+
+      Aempl & operator=(Aempl && other) {
+        str = std::move(other.str);
+        std::cout << " move assigned\n"s;
+        return *this;
+      }
+    };
+
+    std::vector<Aempl> container;
+    // reserve enough place so vector does not have to resize
+    container.reserve(10);
+    std::cout << "construct 2 times Aempl:\n"s;
+    Aempl two { "two"s };
+    Aempl three { "three"s };
+
+    std::cout << "emplace:\n"s;
+    container.emplace(container.end(), "one"s);
+
+    std::cout << "emplace with Aempl &:\n"s;
+    container.emplace(container.end(), two);
+
+    std::cout << "emplace with Aempl &&:\n"s;
+    container.emplace(container.end(), std::move(three));
+
+    std::cout << "content:\n"s;
+    for (const auto & obj : container)
+      std::cout << ' ' << obj.str;
+    std::cout << '\n';
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - emplace"s << '\n';
+  {
+    perf::section const sect("std::vector - emplace"s);
+    auto print_container = [](std::vector<int> const & ctr) {
+      for (auto & nr : ctr) {
+        std::cout << nr << ' ';
+      }
+      std::cout << '\n';
+    };
+
+    std::vector<int> container { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, };
+    print_container(container);
+
+    container.erase(container.begin());
+    print_container(container);
+
+    container.erase(container.begin() + 2, container.begin() + 5);
+    print_container(container);
+
+    // Erase all even numbers in one compacting pass
+    vecers::erase_if(container, [](int nr) { return nr % 2 == 0; });
+    print_container(container);
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - push_back"s << '\n';
+  {
+    perf::section const sect("std::vector - push_back"s);
+    std::vector<std::string> letters;
+
+    letters.push_back("abc"s);
+    std::string str = "def"s;
+    letters.push_back(std::move(str));
+
+    std::cout << "vector holds: "s;
+    for (auto && im : letters) {
+      std::cout << std::quoted(im) << ' ';
+    }
+    std::cout << "\nMoved-from string holds "s << std::quoted(str) << '\n';
+    std::cout << '\n';
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - emplace_back"s << '\n';
+  {
+    perf::section const sect("std::vector - emplace_back"s);
+    struct President {
+      std::string name;
+      std::string country;
+      int year;
+
+      President(std::string p_name, std::string p_country, int p_year)
+        : name(std::move(p_name)),
+          country(std::move(p_country)),
+          year(p_year) {
+        std::cout << "I am being constructed.\n"s;
+      }
+
+      President(President && other)
+        : name(std::move(other.name)),
+          country(std::move(other.country)),
+          year(other.year) {
+        std::cout << "I am being moved.\n"s;
+      }
+
+      President & operator=(const President & other) = default;
+    };
+
+    std::vector<President> elections;
+    std::cout << "emplace_back:\n"s;
+    auto& ref = elections.emplace_back("Nelson Mandela"s, "South Africa"s, 1994);
+    assert(ref.year != 1984 && "uses a reference to the created object (C++17)");
+
+    std::vector<President> reElections;
+    std::cout << "\npush_back:\n"s;
+    reElections.push_back(President("Franklin Delano Roosevelt"s, "the USA"s, 1936));
+
+    std::cout << "\nContents:\n"s;
+    for (President const& president: elections) {
+      std::cout << president.name << " was elected president of "s
+                << president.country << " in "s << president.year << ".\n"s;
+    }
+
+    for (President const& president: reElections) {
+      std::cout << president.name << " was re-elected president of "s
+                << president.country << " in "s << president.year << ".\n"s;
+    }
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "vecsoa::soa_vector - President as a structure of arrays"s << '\n';
+  {
+    perf::section const sect("vecsoa::soa_vector - President as a structure of arrays"s);
+    using presidents = vecsoa::soa_vector<vecsoa::field<"name", std::string>,
+                                          vecsoa::field<"country", std::string>,
+                                          vecsoa::field<"year", int>>;
+    presidents elections;
+    elections.emplace_back("Nelson Mandela"s, "South Africa"s, 1994);
+    elections.emplace_back("Franklin Delano Roosevelt"s, "the USA"s, 1932);
+    elections.emplace_back("Franklin Delano Roosevelt"s, "the USA"s, 1936);
+    elections.emplace_back("Lula da Silva"s, "Brazil"s, 2002);
+    elections.emplace_back("Abraham Lincoln"s, "the USA"s, 1860);
+    elections.push_back({ "Mary Robinson"s, "Ireland"s, 1990, });
+
+    auto print = [](presidents const & pres) {
+      for (auto row : pres) {
+        std::cout << "  "s << row.get<"year">() << ' ' << row.get<"name">()
+                  << ", "s << row.get<"country">() << '\n';
+      }
+    };
+    print(elections);
+
+    //  the scan reads the ints and nothing else.
+    auto const years = elections.column<"year">();
+    auto const modern = std::count_if(years.begin(), years.end(), [](int yr) { return yr >= 1950; });
+    std::cout << "columns: "s << presidents::columns
+              << ", elected since 1950: "s << modern << '\n';
+
+    std::cout << "\nsort_by<\"year\">:\n"s;
+    elections.sort_by<"year">();
+    print(elections);
+
+    std::cout << "\nerase_if the USA:\n"s;
+    auto const erased = erase_if(elections, [](presidents::const_reference row) {
+      return row.get<"country">() == "the USA"s;
+    });
+    print(elections);
+    std::cout << "erased "s << erased << ", size "s << elections.size() << '\n';
+
+    auto [name, country, year] = presidents::value_type(elections.front());
+    std::cout << "front as a tuple: "s << name << ", "s << country << ", "s << year << '\n';
+
+    try {
+      elections.at(elections.size());
+    }
+    catch (std::out_of_range const & ex) {
+      std::cout << "at("s << elections.size() << ") throws std::out_of_range: "s << ex.what() << '\n';
+    }
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - pop_back"s << '\n';
+  {
+    perf::section const sect("std::vector - pop_back"s);
+    std::vector<int> numbers;
+
+    vecpop::print(numbers);
+
+    numbers.push_back(5);
+    numbers.push_back(3);
+    numbers.push_back(4);
+
+    vecpop::print(numbers);
+
+    numbers.pop_back();
+
+    vecpop::print(numbers);
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - resize"s << '\n';
+  {
+    perf::section const sect("std::vector - resize"s);
+    auto print_element = [](auto & el) {
+      std::cout << el << ' ';
+    };
+    auto print = [&](auto & container) {
+      std::for_each(container.cbegin(), container.cend(), print_element);
+    };
+
+    std::vector<int> container = { 1, 2, 3, };
+    std::cout << "The vector holds: "s;
+    print(container);
+    std::cout << '\n';
+
+    container.resize(5);
+    std::cout << "After resize up to 5: "s;
+    print(container);
+    std::cout << '\n';
+
+    container.resize(2);
+    std::cout << "After resize down to 2: "s;
+    print(container);
+    std::cout << '\n';
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - resize for overwrite, valc::DefaultInitAllocator"s << '\n';
+  {
+    perf::section const sect("std::vector - resize for overwrite, valc::DefaultInitAllocator"s);
+    //  the new elements are unwritten after these resizes: fill before reading.
+    {
+      valc::trace::mode_scope const quiet(valc::trace::mode::off);
+      std::vector<int, valc::DefaultInitAllocator<valc::Mallocator<int>>> container = { 1, 2, 3, };
+      container.resize(8);
+      std::iota(container.begin() + 3, container.end(), 4);
+      std::cout << "DefaultInitAllocator, resize up to 8 then iota: "s;
+      vecpop::print(container);
+
+      vecgrw::growth_vector<int, valc::Mallocator<int>> gvec = { 1, 2, 3, };
+      gvec.resize_for_overwrite(8);
+      std::iota(gvec.begin() + 3, gvec.end(), 4);
+      std::cout << "growth_vector resize_for_overwrite(8) then iota: "s;
+      vecpop::print(gvec);
+
+      container.resize(2);
+      gvec.resize_for_overwrite(2);
+      std::cout << "After resize down to 2: "s;
+      vecpop::print(container);
+      vecpop::print(gvec);
+    }
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - swap"s << '\n';
+  {
+    perf::section const sect("std::vector - swap"s);
+    using namespace vecswp;
+
+    std::vector<int> a1{ 1, 2, 3, }, a2{ 4, 5, };
+
+    auto it1 = std::next(a1.begin());
+    auto it2 = std::next(a2.begin());
+
+    int& ref1 = a1.front();
+    int& ref2 = a2.front();
+
+    std::cout << a1 << a2 << *it1 << ' ' << *it2 << ' ' << ref1 << ' ' << ref2 << '\n';
+    a1.swap(a2);
+    std::cout << a1 << a2 << *it1 << ' ' << *it2 << ' ' << ref1 << ' ' << ref2 << '\n';
+
+    // Note that after swap the iterators and references stay associated with their
+    // original elements, e.g. it1 that pointed to an element in 'a1' with value 2
+    // still points to the same element, though this element was moved into 'a2'.
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  /// Non-member functions
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - std::operator== etc."s << '\n';
+  {
+    perf::section const sect("std::vector - std::operator== etc."s);
+    std::vector<int> alice{1, 2, 3};
+    std::vector<int> bob{7, 8, 9, 10};
+    std::vector<int> eve{1, 2, 3};
+
+    std::cout << std::boolalpha;
+
+    // Compare non equal containers
+    std::cout << "alice == bob returns "s << (alice == bob) << '\n';
+    std::cout << "alice != bob returns "s << (alice != bob) << '\n';
+    std::cout << "alice <  bob returns "s << (alice < bob) << '\n';
+    std::cout << "alice <= bob returns "s << (alice <= bob) << '\n';
+    std::cout << "alice >  bob returns "s << (alice > bob) << '\n';
+    std::cout << "alice >= bob returns "s << (alice >= bob) << '\n';
+
+    std::cout << '\n';
+
+    // Compare equal containers
+    std::cout << "alice == eve returns "s << (alice == eve) << '\n';
+    std::cout << "alice != eve returns "s << (alice != eve) << '\n';
+    std::cout << "alice <  eve returns "s << (alice < eve) << '\n';
+    std::cout << "alice <= eve returns "s << (alice <= eve) << '\n';
+    std::cout << "alice >  eve returns "s << (alice > eve) << '\n';
+    std::cout << "alice >= eve returns "s << (alice >= eve) << '\n';
+
+#if (__cplusplus > 201707L)
+    std::cout << '\n';
+
+    // Three-way comparison
+    auto eq = std::is_eq(alice <=> eve);
+    auto ne = std::is_neq(alice <=> eve);
+    auto lt = std::is_lt(alice <=> eve);
+    auto le = std::is_lteq(alice <=> eve);
+    auto gt = std::is_gt(alice <=> eve);
+    auto ge = std::is_gteq(alice <=> eve);
+    std::cout << "alice <=> eve: is_eq "s << eq << ", is_neq "s << ne << ", is_lt "s << lt
+              << ", is_lteq "s << le << ", is_gt "s << gt << ", is_gteq "s << ge << '\n';
+
+    // The same through veccmp, which finds the first mismatch with SIMD
+    auto order = veccmp::compare(alice, bob);
+    std::cout << "veccmp::compare(alice, bob) ("s << veccmp::name() << "): is_lt "s
+              << std::is_lt(order) << ", veccmp::equal(alice, eve) "s
+              << veccmp::equal(alice, eve) << '\n';
+
+    // Signed elements order as values, not as bytes
+    std::vector<char> minus { 'a', -1, }, plus { 'a', 1, };
+    std::cout << "veccmp::less{}({ 'a', -1 }, { 'a', 1 }) returns "s
+              << veccmp::less {}(minus, plus) << '\n';
+
+    // A drop-in comparator for ordered containers
+    std::map<std::vector<int>, std::string, veccmp::less> owners {
+      { alice, "alice"s, }, { bob, "bob"s, }, { { 1, 2, }, "carol"s, },
+    };
+    std::cout << "std::map<std::vector<int>, std::string, veccmp::less>:"s;
+    for (auto const & [key, owner] : owners) {
+      std::cout << ' ' << owner << '(' << key.size() << ')';
+    }
+    std::cout << '\n';
+#endif  /* (__cplusplus > 201707L) */
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  /// Non-member functions
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - std::swap"s << '\n';
+  {
+    perf::section const sect("std::vector - std::swap"s);
+    std::vector<int> alice{ 1, 2, 3, };
+    std::vector<int> bob{ 7, 8, 9, 10, };
+
+    auto print = [](const int & n) {
+      std::cout << ' ' << n;
+    };
+
+    // Print state before swap
+    std::cout << "alice:"s;
+    std::for_each(alice.begin(), alice.end(), print);
+    std::cout << "\n" "bob  :"s;
+    std::for_each(bob.begin(), bob.end(), print);
+    std::cout << '\n';
+
+    std::cout << "-- SWAP\n"s;
+    std::swap(alice, bob);
+
+    // Print state after swap
+    std::cout << "alice:"s;
+    std::for_each(alice.begin(), alice.end(), print);
+    std::cout << "\n" "bob  :"s;
+    std::for_each(bob.begin(), bob.end(), print);
+    std::cout << '\n';
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  /// Non-member functions
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector - std::erase, std::erase_if"s << '\n';
+  {
+    perf::section const sect("std::vector - std::erase, std::erase_if"s);
+    auto print_container = [](std::string_view comment,
+                              std::vector<char> const & ctr) {
+      std::cout << comment;
+      for (auto xv : ctr) {
+        std::cout << xv << ' ';
+      }
+      std::cout << '\n';
+    };
+
+    std::vector<char> cnt(10);
+    std::iota(cnt.begin(), cnt.end(), '0');
+    print_container("Init:\n"s, cnt);
+
+    std::erase(cnt, '3');
+    print_container("Erase '3':\n"s, cnt);
+
+#if (__cplusplus > 201707L)
+    auto erased = std::erase_if(cnt, [](char x_) {
+      return (x_ - '0') % 2 == 0;
+    });
+
+    print_container("Erase all even numbers:\n"s, cnt);
+    std::cout << "In all "s << erased << " even numbers were erased.\n"s;
+#else
+    int erased = 0;
+    std::erase_if(cnt, [&erased](char x_) {
+      auto ok = (x_ - '0') % 2 == 0;
+      if (ok) {
+        ++erased;
+      }
+      return ok;
+    });
+
+    print_container("Erase all even numbers:\n"s, cnt);
+    std::cout << "In all "s << erased << " even numbers were erased.\n"s;
+#endif  /* (__cplusplus > 201707L) */
+
+    cnt.resize(10);
+    std::iota(cnt.begin(), cnt.end(), '0');
+    auto const odd = vecers::erase_if(cnt, [](char x_) {
+      return (x_ - '0') % 2 != 0;
+    });
+    print_container("vecers::erase_if, all odd numbers ("s + vecers::name() + "):\n"s, cnt);
+    std::cout << "In all "s << odd << " odd numbers were erased.\n"s;
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "vecpar - parallel sort, for_each, reduce, scan"s << '\n';
+  {
+    perf::section const sect("vecpar - parallel sort, for_each, reduce, scan"s);
+    vecpar::pool pl(4);
+    std::cout << "pool of "s << pl.size() << " threads\n"s;
+
+    //  valc::Mallocator shows the vector and the sort's merge scratch.
+    std::vector<int, valc::Mallocator<int>> vnr(100'000);
+    std::iota(vnr.begin(), vnr.end(), 0);
+    std::shuffle(vnr.begin(), vnr.end(), std::mt19937 { 42 });
+    vecpar::sort(pl, vnr);
+    std::cout << "sorted: "s << std::boolalpha << std::is_sorted(vnr.begin(), vnr.end())
+              << std::noboolalpha << ", front "s << vnr.front() << ", back "s << vnr.back() << '\n';
+
+    vecpar::for_each(pl, vnr, [](int & nr) { nr %= 10; });
+    std::cout << "sum of digits: "s << vecpar::reduce(pl, vnr, 0ll) << '\n';
+
+    std::vector<long long> sums;
+    vecpar::inclusive_scan(pl, vnr, sums);
+    std::cout << "inclusive scan: "s;
+    std::for_each(sums.begin(), sums.begin() + 12, [](auto sm) { std::cout << sm << ' '; });
+    std::cout << "... "s << sums.back() << '\n';
+    vecpar::exclusive_scan(pl, vnr, sums, 0ll);
+    std::cout << "exclusive scan: "s;
+    std::for_each(sums.begin(), sums.begin() + 12, [](auto sm) { std::cout << sm << ' '; });
+    std::cout << "... "s << sums.back() << '\n';
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - operator="s << '\n';
+  std::cout << "vecsnap - binary snapshot, mapped view"s << '\n';
   {
-    auto display_sizes = [](std::string comment,
-                            std::vector<int> const & nums1,
-                            std::vector<int> const & nums2,
-                            std::vector<int> const & nums3) {
-      std::cout << comment
-                << " nums1: "s << nums1.size() << ','
-                << " nums2: "s << nums2.size() << ','
-                << " nums3: "s << nums3.size() << '\n';
+    perf::section const sect("vecsnap - binary snapshot, mapped view"s);
+    auto const dir = std::filesystem::temp_directory_path();
+    auto const ints_path = (dir / "vectors_snap_ints.bin").string();
+    auto const bits_path = (dir / "vectors_snap_bits.bin").string();
+
+    std::vector<int> vnr(12);
+    std::iota(vnr.begin(), vnr.end(), -5);
+    vecsnap::save(ints_path, vnr);
+    std::vector<bool> vbl { true, false, true, true, false, false, true, };
+    vecsnap::save(bits_path, vbl);
+
+    {
+      vecsnap::view<int> ints(ints_path, vecsnap::check::checksum);
+      std::cout << "view<int>, "s << ints.size() << " elements: "s;
+      vecpop::print(ints);
+
+      vecsnap::view<bool> bits(bits_path);
+      std::cout << "view<bool>, "s << bits.size() << " bits: "s;
+      vecpop::print(bits);
+
+      //  a copy that owns its storage, from valc::Mallocator.
+      auto copy = ints.to_vector(valc::Mallocator<int>());
+      std::cout << "to_vector: "s;
+      vecpop::print(copy);
+    }
+
+    try {
+      vecsnap::view<double> wrong(ints_path);
+    }
+    catch (std::runtime_error const & ex) {
+      std::cout << "view<double>: "s << ex.what() << '\n';
+    }
+
+    //  a crafted count: times sizeof(int) it wraps round to the real
+    //  payload size, so only the bound on the count itself catches it.
+    {
+      std::fstream fs(ints_path, std::ios::in | std::ios::out | std::ios::binary);
+      auto const forged = std::uint64_t(vnr.size()) + (std::uint64_t(1) << 62);
+      fs.seekp(offsetof(vecsnap::header, size));
+      fs.write(reinterpret_cast<char const *>(&forged), sizeof forged);
+    }
+    try {
+      vecsnap::view<int> forged(ints_path);
+      std::cout << "forged count accepted, "s << forged.size() << " elements\n"s;
+    }
+    catch (std::runtime_error const & ex) {
+      std::cout << "forged count: "s << ex.what() << '\n';
+    }
+
+    std::filesystem::remove(ints_path);
+    std::filesystem::remove(bits_path);
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "vecsbo::small_vector"s << '\n';
+  {
+    perf::section const sect("vecsbo::small_vector"s);
+    using namespace vecswp;
+
+    //  valc::Mallocator prints every heap allocation: none until the
+    //  vector grows past its 8 inline elements.
+    vecsbo::small_vector<int, 8, valc::Mallocator<int>> vnr { 7, 5, 16, 8, };
+    vnr.push_back(25);
+    vnr.push_back(13);
+    std::cout << "v = "s << vnr << "inline: "s << std::boolalpha
+              << vnr.is_inline() << '\n';
+
+    vnr.insert(vnr.begin(), { 1, 2, 3, });
+    vnr.emplace(vnr.begin() + 1, 42);
+    std::cout << "v = "s << vnr << "inline: "s << vnr.is_inline() << '\n';
+
+    auto erased = erase_if(vnr, [](int nr) { return nr % 2 == 0; });
+    vnr.shrink_to_fit();
+    std::cout << "erased "s << erased << " even numbers, v = "s << vnr
+              << "inline: "s << vnr.is_inline() << '\n';
+
+    vecsbo::small_vector<int, 4> a1 { 1, 2, 3, }, a2 { 4, 5, };
+    a1.swap(a2);
+    std::cout << a1 << a2 << '\n';
+    std::cout << "a1 <  a2 returns "s << (a1 < a2) << '\n';
+    std::cout << "a1 == a2 returns "s << (a1 == a2) << '\n';
+
+    vecsbo::small_vector<char, 10> characters;
+    characters.assign(5, 'a');
+    std::cout << characters << '\n';
+    characters.assign({ 'C', '+', '+', '1', '1', });
+    std::cout << characters << "inline: "s << characters.is_inline()
+              << std::noboolalpha << '\n';
+
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  return 0;
+}
+
+//  MARK: - C_vector_bool
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  ================================================================================
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecbit
+/*
+ *  bit_vector<Alloc>: a packed bit container with the std::vector<bool>
+ *  operations the C_vector_bool sections use (push_back, reserve,
+ *  operator[] proxies, flip, swap of two references, iteration), plus
+ *  word-level bulk operations: &=, |=, ^=, ~, count, find_first/find_next
+ *  and range fill.
+ *
+ *  Bits live in 64-bit words held in a std::vector rebound from Alloc.  Bits
+ *  past size() in the last word are always zero, so the word kernels never
+ *  need a tail mask except where noted.
+ */
+namespace vecbit {
+
+using word = std::uint64_t;
+static constexpr std::size_t word_bits = 64;
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecbit::kernel
+/*
+ *  Word kernels.  On x86 the AVX2 versions are compiled with a target
+ *  attribute and picked at run time; SSE2 is the x86-64 baseline.  Other
+ *  targets use the portable loops, which compilers vectorise well enough.
+ */
+namespace kernel {
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VECBIT_X86 1
+#define VECBIT_AVX2 __attribute__((target("avx2")))
+#endif  /* defined(__x86_64__) || defined(__i386__) */
+
+enum class isa : int { portable, sse2, avx2, };
+
+//  not_ ignores src.
+enum class bitop : int { and_, or_, xor_, andnot, not_, };
+
+inline isa detect() noexcept {
+#if defined(VECBIT_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return isa::avx2;
+  }
+#if defined(__SSE2__)
+  return isa::sse2;
+#endif  /* defined(__SSE2__) */
+#endif  /* defined(VECBIT_X86) */
+  return isa::portable;
+}
+
+inline isa const active = detect();
+
+inline char const * name(isa is = active) noexcept {
+  static char const * const names[] = { "portable", "sse2", "avx2", };
+  return names[static_cast<int>(is)];
+}
+
+template <bitop Op>
+inline word apply(word lhs, word rhs) noexcept {
+  if constexpr (Op == bitop::and_) { return lhs & rhs; }
+  if constexpr (Op == bitop::or_) { return lhs | rhs; }
+  if constexpr (Op == bitop::xor_) { return lhs ^ rhs; }
+  if constexpr (Op == bitop::andnot) { return lhs & ~rhs; }
+  if constexpr (Op == bitop::not_) { return ~lhs; }
+}
+
+template <bitop Op>
+inline void portable_binary(word * dst, word const * src, std::size_t nw) noexcept {
+  for (auto ix = 0ul; ix < nw; ++ix) {
+    dst[ix] = apply<Op>(dst[ix], src[ix]);
+  }
+}
+
+inline std::size_t portable_popcount(word const * src, std::size_t nw) noexcept {
+  auto count = 0ul;
+  for (auto ix = 0ul; ix < nw; ++ix) {
+    count += static_cast<std::size_t>(std::popcount(src[ix]));
+  }
+  return count;
+}
+
+//  index of the first non-zero word at or after from, or nw.
+inline std::size_t portable_find(word const * src, std::size_t from, std::size_t nw) noexcept {
+  for (; from < nw && src[from] == 0; ++from) {}
+  return from;
+}
+
+#if defined(VECBIT_X86)
+#if defined(__SSE2__)
+template <bitop Op>
+inline void sse2_binary(word * dst, word const * src, std::size_t nw) noexcept {
+  auto ix = 0ul;
+  for (; ix + 2 <= nw; ix += 2) {
+    auto lhs = _mm_loadu_si128(reinterpret_cast<__m128i const *>(dst + ix));
+    auto const rhs = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + ix));
+    if constexpr (Op == bitop::and_) { lhs = _mm_and_si128(lhs, rhs); }
+    if constexpr (Op == bitop::or_) { lhs = _mm_or_si128(lhs, rhs); }
+    if constexpr (Op == bitop::xor_) { lhs = _mm_xor_si128(lhs, rhs); }
+    if constexpr (Op == bitop::andnot) { lhs = _mm_andnot_si128(rhs, lhs); }
+    if constexpr (Op == bitop::not_) { lhs = _mm_xor_si128(lhs, _mm_set1_epi32(-1)); }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + ix), lhs);
+  }
+  portable_binary<Op>(dst + ix, src + ix, nw - ix);
+}
+
+inline std::size_t sse2_find(word const * src, std::size_t from, std::size_t nw) noexcept {
+  auto const zero = _mm_setzero_si128();
+  for (; from + 2 <= nw; from += 2) {
+    auto const blk = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + from));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(blk, zero)) != 0xffff) {
+      break;
+    }
+  }
+  return portable_find(src, from, nw);
+}
+#endif  /* defined(__SSE2__) */
+
+template <bitop Op>
+VECBIT_AVX2
+inline void avx2_binary(word * dst, word const * src, std::size_t nw) noexcept {
+  auto ix = 0ul;
+  for (; ix + 4 <= nw; ix += 4) {
+    auto lhs = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(dst + ix));
+    auto const rhs = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(src + ix));
+    if constexpr (Op == bitop::and_) { lhs = _mm256_and_si256(lhs, rhs); }
+    if constexpr (Op == bitop::or_) { lhs = _mm256_or_si256(lhs, rhs); }
+    if constexpr (Op == bitop::xor_) { lhs = _mm256_xor_si256(lhs, rhs); }
+    if constexpr (Op == bitop::andnot) { lhs = _mm256_andnot_si256(rhs, lhs); }
+    if constexpr (Op == bitop::not_) { lhs = _mm256_xor_si256(lhs, _mm256_set1_epi32(-1)); }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + ix), lhs);
+  }
+  for (; ix < nw; ++ix) {
+    dst[ix] = apply<Op>(dst[ix], src[ix]);
+  }
+}
+
+//  nibble-table popcount (Mula); byte counts are summed with vpsadbw.
+VECBIT_AVX2
+inline std::size_t avx2_popcount(word const * src, std::size_t nw) noexcept {
+  auto const table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  auto const low = _mm256_set1_epi8(0x0f);
+  auto acc = _mm256_setzero_si256();
+  auto ix = 0ul;
+  for (; ix + 4 <= nw; ix += 4) {
+    auto const blk = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(src + ix));
+    auto const lo = _mm256_shuffle_epi8(table, _mm256_and_si256(blk, low));
+    auto const hi = _mm256_shuffle_epi8(table,
+                                        _mm256_and_si256(_mm256_srli_epi16(blk, 4), low));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi),
+                                                _mm256_setzero_si256()));
+  }
+  auto count = static_cast<std::size_t>(_mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1)
+                                      + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3));
+  for (; ix < nw; ++ix) {
+    count += static_cast<std::size_t>(std::popcount(src[ix]));
+  }
+  return count;
+}
+
+VECBIT_AVX2
+inline std::size_t avx2_find(word const * src, std::size_t from, std::size_t nw) noexcept {
+  for (; from + 4 <= nw; from += 4) {
+    auto const blk = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(src + from));
+    if (!_mm256_testz_si256(blk, blk)) {
+      break;
+    }
+  }
+  for (; from < nw && src[from] == 0; ++from) {}
+  return from;
+}
+#endif  /* defined(VECBIT_X86) */
+
+template <bitop Op>
+inline void binary(word * dst, word const * src, std::size_t nw) noexcept {
+#if defined(VECBIT_X86)
+  if (active == isa::avx2) {
+    return avx2_binary<Op>(dst, src, nw);
+  }
+#if defined(__SSE2__)
+  return sse2_binary<Op>(dst, src, nw);
+#endif  /* defined(__SSE2__) */
+#endif  /* defined(VECBIT_X86) */
+  portable_binary<Op>(dst, src, nw);
+}
+
+//  dst = ~dst
+inline void invert(word * dst, std::size_t nw) noexcept {
+  binary<bitop::not_>(dst, dst, nw);
+}
+
+inline std::size_t popcount(word const * src, std::size_t nw) noexcept {
+#if defined(VECBIT_X86)
+  if (active == isa::avx2) {
+    return avx2_popcount(src, nw);
+  }
+#endif  /* defined(VECBIT_X86) */
+  return portable_popcount(src, nw);
+}
+
+inline std::size_t find(word const * src, std::size_t from, std::size_t nw) noexcept {
+#if defined(VECBIT_X86)
+  if (active == isa::avx2) {
+    return avx2_find(src, from, nw);
+  }
+#if defined(__SSE2__)
+  return sse2_find(src, from, nw);
+#endif  /* defined(__SSE2__) */
+#endif  /* defined(VECBIT_X86) */
+  return portable_find(src, from, nw);
+}
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+/*
+ *  64-bit hash of a packed bit vector, in the style of xxh3: stripes of
+ *  four words are accumulated into four independent lanes with a 32x32->64
+ *  multiply of (word ^ key) against itself, the keys advancing with each
+ *  stripe so that stripe order matters.  The lanes and the tail words are
+ *  folded together with a 128-bit multiply-xor (wyhash's mum) and a final
+ *  avalanche.  The portable and AVX2 versions give identical results.
+ */
+namespace hashing {
+
+inline constexpr word secret[4] = {
+  0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+  0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull,
+};
+inline constexpr word step = 0x9e3779b97f4a7c15ull;
+
+inline word mum(word lhs, word rhs) noexcept {
+  auto const rs = static_cast<unsigned __int128>(lhs) * rhs;
+  return static_cast<word>(rs) ^ static_cast<word>(rs >> 64);
+}
+
+inline word avalanche(word hv) noexcept {
+  hv ^= hv >> 33;
+  hv *= 0xff51afd7ed558ccdull;
+  hv ^= hv >> 33;
+  hv *= 0xc4ceb9fe1a85ec53ull;
+  return hv ^ (hv >> 33);
+}
+
+inline word finish(word const (&acc)[4], word const * tail, std::size_t nt,
+                   std::size_t nbits, word seed) noexcept {
+  auto hv = seed ^ (nbits * step);
+  hv ^= mum(acc[0] ^ secret[0], acc[1] ^ secret[1]);
+  hv ^= mum(acc[2] ^ secret[2], acc[3] ^ secret[3]);
+  for (auto ix = 0ul; ix < nt; ++ix) {
+    hv = mum(hv ^ tail[ix], secret[ix] ^ step);
+  }
+  return avalanche(hv);
+}
+
+//  the stripe loop as a resumable state, for callers (roaring) that hold
+//  the words in pieces: feed whole stripes, then finish() with the tail.
+struct lanes {
+  word acc[4] = { secret[0], secret[1], secret[2], secret[3], };
+  word key[4] = { secret[0], secret[1], secret[2], secret[3], };
+
+  //  nw is a multiple of 4.
+  void stripes(word const * src, std::size_t nw) noexcept {
+    for (auto ix = 0ul; ix + 4 <= nw; ix += 4) {
+      for (auto ln = 0; ln < 4; ++ln) {
+        auto const dv = src[ix + ln] ^ key[ln];
+        acc[ln] += (dv & 0xffffffffull) * (dv >> 32) + src[ix + ln];
+        key[ln] += step;
+      }
+    }
+  }
+};
+
+inline word portable(word const * src, std::size_t nw, std::size_t nbits,
+                     word seed) noexcept {
+  lanes st;
+  auto const ix = nw / 4 * 4;
+  st.stripes(src, ix);
+  return finish(st.acc, src + ix, nw - ix, nbits, seed);
+}
+
+#if defined(VECBIT_X86)
+VECBIT_AVX2
+inline word avx2(word const * src, std::size_t nw, std::size_t nbits,
+                 word seed) noexcept {
+  auto const inc = _mm256_set1_epi64x(static_cast<long long>(step));
+  auto key = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(secret));
+  auto acc = key;
+  auto ix = 0ul;
+  for (; ix + 4 <= nw; ix += 4) {
+    auto const blk = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(src + ix));
+    auto const dv = _mm256_xor_si256(blk, key);
+    auto const pr = _mm256_mul_epu32(dv, _mm256_srli_epi64(dv, 32));
+    acc = _mm256_add_epi64(acc, _mm256_add_epi64(pr, blk));
+    key = _mm256_add_epi64(key, inc);
+  }
+  word lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), acc);
+  return finish(lanes, src + ix, nw - ix, nbits, seed);
+}
+#endif  /* defined(VECBIT_X86) */
+
+} /* namespace hashing */
+
+inline word hash(word const * src, std::size_t nw, std::size_t nbits,
+                 word seed = 0) noexcept {
+#if defined(VECBIT_X86)
+  if (active == isa::avx2) {
+    return hashing::avx2(src, nw, nbits, seed);
+  }
+#endif  /* defined(VECBIT_X86) */
+  return hashing::portable(src, nw, nbits, seed);
+}
+
+} /* namespace kernel */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecbit::bit_vector
+template <class Alloc = std::allocator<word>>
+class bit_vector {
+  using word_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<word>;
+
+public:
+  using value_type = bool;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using allocator_type = Alloc;
+  using const_reference = bool;
+
+  static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+  //  a write through the proxy drops the owner's cached hash, even when
+  //  hash() ran after the proxy was taken.
+  class reference {
+  public:
+    operator bool() const noexcept { return (*wp_ & mask_) != 0; }
+
+    reference & operator=(bool val) noexcept {
+      *hashed_ = false;
+      *wp_ = val ? (*wp_ | mask_) : (*wp_ & ~mask_);
+      return *this;
+    }
+
+    reference & operator=(reference const & other) noexcept {
+      return *this = static_cast<bool>(other);
+    }
+
+    reference(reference const &) = default;
+
+    void flip() noexcept {
+      *hashed_ = false;
+      *wp_ ^= mask_;
+    }
+
+  private:
+    friend class bit_vector;
+    reference(word * wp, word mask, bool * hashed) noexcept
+      : wp_(wp), mask_(mask), hashed_(hashed) {}
+
+    word * wp_;
+    word mask_;
+    bool * hashed_;
+  };
+
+  template <bool Const>
+  class basic_iterator {
+    using owner = std::conditional_t<Const, bit_vector const, bit_vector>;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = bool;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::conditional_t<Const, bool, typename bit_vector::reference>;
+
+    basic_iterator() noexcept = default;
+    basic_iterator(owner * bv, size_type pos) noexcept : bv_(bv), pos_(pos) {}
+
+    reference operator*() const noexcept { return (*bv_)[pos_]; }
+    basic_iterator & operator++() noexcept { ++pos_; return *this; }
+    basic_iterator operator++(int) noexcept { auto tmp = *this; ++pos_; return tmp; }
+
+    friend bool operator==(basic_iterator const & lhs, basic_iterator const & rhs) noexcept {
+      return lhs.pos_ == rhs.pos_;
+    }
+
+    friend difference_type operator-(basic_iterator const & lhs, basic_iterator const & rhs) noexcept {
+      return static_cast<difference_type>(lhs.pos_ - rhs.pos_);
+    }
+
+  private:
+    owner * bv_ { nullptr };
+    size_type pos_ { 0 };
+  };
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  bit_vector() = default;
+  explicit bit_vector(Alloc const & al) : words_(word_alloc(al)) {}
+
+  bit_vector(bit_vector const &) = default;
+  bit_vector & operator=(bit_vector const &) = default;
+
+  bit_vector(bit_vector && other) noexcept
+    : words_(std::move(other.words_)),
+      size_(std::exchange(other.size_, 0)),
+      hash_(other.hash_),
+      hashed_(std::exchange(other.hashed_, false)) {}
+
+  bit_vector & operator=(bit_vector && other) noexcept {
+    words_ = std::move(other.words_);
+    size_ = std::exchange(other.size_, 0);
+    hash_ = other.hash_;
+    hashed_ = std::exchange(other.hashed_, false);
+    return *this;
+  }
+
+  explicit bit_vector(size_type nb, bool val = false, Alloc const & al = Alloc())
+    : words_(word_alloc(al)) {
+    resize(nb, val);
+  }
+
+  bit_vector(std::initializer_list<bool> il, Alloc const & al = Alloc())
+    : bit_vector(il.begin(), il.end(), al) {}
+
+  template <std::input_iterator It>
+  bit_vector(It first, It last, Alloc const & al = Alloc()) : words_(word_alloc(al)) {
+    for (; first != last; ++first) {
+      push_back(static_cast<bool>(*first));
+    }
+  }
+
+  allocator_type get_allocator() const { return allocator_type(words_.get_allocator()); }
+
+  /// Element access
+  reference operator[](size_type pos) noexcept {
+    touch();
+    return reference(&words_[pos / word_bits], bit(pos), &hashed_);
+  }
+
+  bool operator[](size_type pos) const noexcept { return test(pos); }
+
+  reference at(size_type pos) {
+    check(pos);
+    return (*this)[pos];
+  }
+
+  bool at(size_type pos) const {
+    check(pos);
+    return test(pos);
+  }
+
+  bool test(size_type pos) const noexcept {
+    return (words_[pos / word_bits] & bit(pos)) != 0;
+  }
+
+  reference front() noexcept { return (*this)[0]; }
+  bool front() const noexcept { return test(0); }
+  reference back() noexcept { return (*this)[size_ - 1]; }
+  bool back() const noexcept { return test(size_ - 1); }
+
+  std::span<word const> words() const noexcept { return { words_.data(), words_.size(), }; }
+
+  /// Iterators
+  iterator begin() noexcept { touch(); return { this, 0, }; }
+  iterator end() noexcept { touch(); return { this, size_, }; }
+  const_iterator begin() const noexcept { return { this, 0, }; }
+  const_iterator end() const noexcept { return { this, size_, }; }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+  /// Capacity
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  size_type capacity() const noexcept { return words_.capacity() * word_bits; }
+  size_type max_size() const noexcept { return words_.max_size() * word_bits; }
+
+  void reserve(size_type nb) { words_.reserve(words_for(nb)); }
+  void shrink_to_fit() { words_.shrink_to_fit(); }
+
+  /// Modifiers
+  void clear() noexcept {
+    touch();
+    words_.clear();
+    size_ = 0;
+  }
+
+  void push_back(bool val) {
+    touch();
+    if (size_ % word_bits == 0) {
+      words_.push_back(0);
+    }
+    if (val) {
+      words_.back() |= bit(size_);
+    }
+    ++size_;
+  }
+
+  void pop_back() noexcept {
+    touch();
+    --size_;
+    if (size_ % word_bits == 0) {
+      words_.pop_back();
+    }
+    else {
+      words_.back() &= ~bit(size_);
+    }
+  }
+
+  void resize(size_type nb, bool val = false) {
+    touch();
+    auto const old = size_;
+    words_.resize(words_for(nb), 0);
+    size_ = nb;
+    if (nb > old && val) {
+      fill(old, nb, true);
+    }
+    trim();
+  }
+
+  void swap(bit_vector & other) noexcept {
+    words_.swap(other.words_);
+    std::swap(size_, other.size_);
+    std::swap(hash_, other.hash_);
+    std::swap(hashed_, other.hashed_);
+  }
+
+  static void swap(reference lhs, reference rhs) noexcept {
+    bool const tmp = lhs;
+    lhs = static_cast<bool>(rhs);
+    rhs = tmp;
+  }
+
+  bit_vector & set(size_type pos, bool val = true) noexcept {
+    (*this)[pos] = val;
+    return *this;
+  }
+
+  bit_vector & reset(size_type pos) noexcept { return set(pos, false); }
+
+  bit_vector & flip(size_type pos) noexcept {
+    touch();
+    words_[pos / word_bits] ^= bit(pos);
+    return *this;
+  }
+
+  bit_vector & flip() noexcept {
+    touch();
+    kernel::invert(words_.data(), words_.size());
+    trim();
+    return *this;
+  }
+
+  //  set bits [first, last) to val.
+  bit_vector & fill(size_type first, size_type last, bool val = true) noexcept {
+    if (first >= last) {
+      return *this;
+    }
+    touch();
+    auto const fw = first / word_bits;
+    auto const lw = (last - 1) / word_bits;
+    auto const head = ~word(0) << (first % word_bits);
+    auto const tail = ~word(0) >> (word_bits - 1 - (last - 1) % word_bits);
+    auto const paint = [val](word & wd, word mask) {
+      wd = val ? (wd | mask) : (wd & ~mask);
+    };
+    if (fw == lw) {
+      paint(words_[fw], head & tail);
+      return *this;
+    }
+    paint(words_[fw], head);
+    std::fill(words_.data() + fw + 1, words_.data() + lw, val ? ~word(0) : word(0));
+    paint(words_[lw], tail);
+    return *this;
+  }
+
+  /// Bulk operations; operands must have the same size.
+  bit_vector & operator&=(bit_vector const & other) noexcept {
+    touch();
+    kernel::binary<kernel::bitop::and_>(words_.data(), other.words_.data(), words_.size());
+    return *this;
+  }
+
+  bit_vector & operator|=(bit_vector const & other) noexcept {
+    touch();
+    kernel::binary<kernel::bitop::or_>(words_.data(), other.words_.data(), words_.size());
+    return *this;
+  }
+
+  bit_vector & operator^=(bit_vector const & other) noexcept {
+    touch();
+    kernel::binary<kernel::bitop::xor_>(words_.data(), other.words_.data(), words_.size());
+    return *this;
+  }
+
+  bit_vector & and_not(bit_vector const & other) noexcept {
+    touch();
+    kernel::binary<kernel::bitop::andnot>(words_.data(), other.words_.data(), words_.size());
+    return *this;
+  }
+
+  bit_vector operator~() const {
+    auto tmp = *this;
+    return tmp.flip();
+  }
+
+  friend bit_vector operator&(bit_vector lhs, bit_vector const & rhs) noexcept { return lhs &= rhs; }
+  friend bit_vector operator|(bit_vector lhs, bit_vector const & rhs) noexcept { return lhs |= rhs; }
+  friend bit_vector operator^(bit_vector lhs, bit_vector const & rhs) noexcept { return lhs ^= rhs; }
+
+  /// Queries
+  size_type count() const noexcept {
+    return kernel::popcount(words_.data(), words_.size());
+  }
+
+  bool any() const noexcept { return find_first() != npos; }
+  bool none() const noexcept { return !any(); }
+  bool all() const noexcept { return count() == size_; }
+
+  size_type find_first() const noexcept { return find_from(0); }
+
+  //  first set bit after pos, or npos.
+  size_type find_next(size_type pos) const noexcept {
+    if (++pos >= size_) {
+      return npos;
+    }
+    auto const rest = words_[pos / word_bits] & (~word(0) << (pos % word_bits));
+    if (rest != 0) {
+      return pos / word_bits * word_bits + static_cast<size_type>(std::countr_zero(rest));
+    }
+    return find_from(pos / word_bits + 1);
+  }
+
+  //  cached until the next mutation; like any lazily cached value this is
+  //  not safe to call concurrently on the same object.
+  std::size_t hash() const noexcept {
+    if (!hashed_) {
+      hash_ = kernel::hash(words_.data(), words_.size(), size_);
+      hashed_ = true;
+    }
+    return static_cast<std::size_t>(hash_);
+  }
+
+  friend bool operator==(bit_vector const & lhs, bit_vector const & rhs) noexcept {
+    return lhs.size_ == rhs.size_ && lhs.words_ == rhs.words_;
+  }
+
+private:
+  static constexpr size_type words_for(size_type nb) noexcept {
+    return (nb + word_bits - 1) / word_bits;
+  }
+
+  static constexpr word bit(size_type pos) noexcept {
+    return word(1) << (pos % word_bits);
+  }
+
+  //  every mutating member calls this; it drops the cached hash.
+  void touch() noexcept { hashed_ = false; }
+
+  void check(size_type pos) const {
+    if (pos >= size_) {
+      throw std::out_of_range("vecbit::bit_vector::at");
+    }
+  }
+
+  //  clear the bits past size_ in the last word.
+  void trim() noexcept {
+    if (size_ % word_bits != 0) {
+      words_.back() &= ~word(0) >> (word_bits - size_ % word_bits);
+    }
+  }
+
+  size_type find_from(size_type wx) const noexcept {
+    auto const nw = words_.size();
+    wx = kernel::find(words_.data(), wx, nw);
+    if (wx == nw) {
+      return npos;
+    }
+    return wx * word_bits + static_cast<size_type>(std::countr_zero(words_[wx]));
+  }
+
+  std::vector<word, word_alloc> words_;
+  size_type size_ { 0 };
+  mutable word hash_ { 0 };
+  mutable bool hashed_ { false };
+};
+
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecbit::bit_view
+/*
+ *  A non-owning view of packed bits: words plus a bit count, with the same
+ *  zero-past-the-end rule as bit_vector.  bit_hash and bit_equal accept
+ *  either, so hash containers keyed on bit_vector can be probed with a
+ *  span of words without building a bit_vector.
+ */
+struct bit_view {
+  std::span<word const> words;
+  std::size_t size;
+
+  friend bool operator==(bit_view const & lhs, bit_view const & rhs) noexcept {
+    return lhs.size == rhs.size
+        && std::equal(lhs.words.begin(), lhs.words.end(),
+                      rhs.words.begin(), rhs.words.end());
+  }
+};
+
+template <class Alloc>
+inline bit_view as_view(bit_vector<Alloc> const & bv) noexcept {
+  return { bv.words(), bv.size(), };
+}
+
+inline bit_view as_view(bit_view const & bv) noexcept {
+  return bv;
+}
+
+struct bit_hash {
+  using is_transparent = void;
+
+  template <class Alloc>
+  std::size_t operator()(bit_vector<Alloc> const & bv) const noexcept {
+    return bv.hash();
+  }
+
+  std::size_t operator()(bit_view const & bv) const noexcept {
+    return static_cast<std::size_t>(kernel::hash(bv.words.data(), bv.words.size(), bv.size));
+  }
+};
+
+struct bit_equal {
+  using is_transparent = void;
+
+  template <class Lhs, class Rhs>
+  bool operator()(Lhs const & lhs, Rhs const & rhs) const noexcept {
+    return as_view(lhs) == as_view(rhs);
+  }
+};
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecbit::atomic_bitset
+/*
+ *  atomic_bitset: a fixed-size bitset that any number of threads may update
+ *  at once, which std::vector<bool> does not allow because neighbouring
+ *  bits share a word.
+ *
+ *  Single-bit set/clear are one fetch_or/fetch_and on the word (lock or /
+ *  lock and on x86).  test_and_set/test_and_clear return the previous bit
+ *  (lock bts / lock btr), so exactly one caller sees a bit change: the
+ *  dedup primitive.  Range set/clear use fetch_or/fetch_and on the partial edge
+ *  words and plain atomic stores on the words wholly inside the range; the
+ *  range as a whole is not one atomic step.  count() is wait-free: one
+ *  relaxed load per word, exact once writers are quiescent.
+ *
+ *  Words are grouped into 64-byte aligned lines of 512 bits.  partition()
+ *  splits the bits on line boundaries, so threads working their own
+ *  partition never write the same cache line.
+ */
+class atomic_bitset {
+public:
+  using size_type = std::size_t;
+  static constexpr size_type line_bytes = 64;
+  static constexpr size_type line_words = line_bytes / sizeof(word);
+  static constexpr size_type line_bits = line_words * word_bits;
+
+  explicit atomic_bitset(size_type nb = 0)
+    : lines_(std::make_unique<line[]>((nb + line_bits - 1) / line_bits)), size_(nb) {
+  }
+
+  atomic_bitset(atomic_bitset &&) noexcept = default;
+  atomic_bitset & operator=(atomic_bitset &&) noexcept = default;
+
+  size_type size() const noexcept { return size_; }
+
+  bool test(size_type pos, std::memory_order mo = std::memory_order_acquire) const noexcept {
+    return (at(pos).load(mo) & bit(pos)) != 0;
+  }
+
+  void set(size_type pos, std::memory_order mo = std::memory_order_acq_rel) noexcept {
+    at(pos).fetch_or(bit(pos), mo);
+  }
+
+  void clear(size_type pos, std::memory_order mo = std::memory_order_acq_rel) noexcept {
+    at(pos).fetch_and(~bit(pos), mo);
+  }
+
+  //  the previous value of the bit.
+  bool test_and_set(size_type pos, std::memory_order mo = std::memory_order_acq_rel) noexcept {
+    return (at(pos).fetch_or(bit(pos), mo) & bit(pos)) != 0;
+  }
+
+  bool test_and_clear(size_type pos, std::memory_order mo = std::memory_order_acq_rel) noexcept {
+    return (at(pos).fetch_and(~bit(pos), mo) & bit(pos)) != 0;
+  }
+
+  //  bits [first, last).
+  void set(size_type first, size_type last) noexcept {
+    range(first, last, true);
+  }
+
+  void clear(size_type first, size_type last) noexcept {
+    range(first, last, false);
+  }
+
+  size_type count() const noexcept {
+#if defined(VECBIT_X86)
+    //  every AVX2 part has POPCNT; the baseline build would call a
+    //  bit-twiddling fallback per word.
+    if (kernel::active == kernel::isa::avx2) {
+      return popcnt_count();
+    }
+#endif  /* defined(VECBIT_X86) */
+    auto total = 0ul;
+    for (auto wx = 0ul, nw = words(); wx < nw; ++wx) {
+      total += static_cast<size_type>(
+        std::popcount(word_at(wx).load(std::memory_order_relaxed)));
+    }
+    return total;
+  }
+
+  //  bits [first, last) of part of parts, split on line boundaries.
+  std::pair<size_type, size_type> partition(size_type part, size_type parts) const noexcept {
+    auto const nl = (size_ + line_bits - 1) / line_bits;
+    auto const first = std::min(size_, nl * part / parts * line_bits);
+    auto const last = std::min(size_, nl * (part + 1) / parts * line_bits);
+    return { first, last, };
+  }
+
+  //  a plain copy, for a single-threaded reader once the writers are done.
+  template <class Alloc = std::allocator<word>>
+  bit_vector<Alloc> snapshot() const {
+    bit_vector<Alloc> bv(size_);
+    for (auto wx = 0ul, nw = words(); wx < nw; ++wx) {
+      for (auto wd = word_at(wx).load(std::memory_order_acquire); wd != 0; wd &= wd - 1) {
+        bv.set(wx * word_bits + static_cast<size_type>(std::countr_zero(wd)));
+      }
+    }
+    return bv;
+  }
+
+private:
+  struct alignas(line_bytes) line {
+    std::array<std::atomic<word>, line_words> words {};
+  };
+
+  static constexpr word bit(size_type pos) noexcept {
+    return word(1) << (pos % word_bits);
+  }
+
+  size_type words() const noexcept {
+    return (size_ + word_bits - 1) / word_bits;
+  }
+
+  std::atomic<word> & word_at(size_type wx) const noexcept {
+    return lines_[wx / line_words].words[wx % line_words];
+  }
+
+  std::atomic<word> & at(size_type pos) const noexcept {
+    assert(pos < size_);
+    return word_at(pos / word_bits);
+  }
+
+#if defined(VECBIT_X86)
+  __attribute__((target("popcnt")))
+  size_type popcnt_count() const noexcept {
+    auto total = 0ul;
+    for (auto wx = 0ul, nw = words(); wx < nw; ++wx) {
+      total += static_cast<size_type>(
+        __builtin_popcountll(word_at(wx).load(std::memory_order_relaxed)));
+    }
+    return total;
+  }
+#endif  /* defined(VECBIT_X86) */
+
+  void range(size_type first, size_type last, bool val) noexcept {
+    last = std::min(last, size_);
+    if (first >= last) {
+      return;
+    }
+    auto const fw = first / word_bits;
+    auto const lw = (last - 1) / word_bits;
+    auto const head = ~word(0) << (first % word_bits);
+    auto const tail = ~word(0) >> (word_bits - 1 - (last - 1) % word_bits);
+    auto apply = [val](std::atomic<word> & wd, word mask) {
+      if (val) {
+        wd.fetch_or(mask, std::memory_order_acq_rel);
+      }
+      else {
+        wd.fetch_and(~mask, std::memory_order_acq_rel);
+      }
+    };
+    if (fw == lw) {
+      apply(word_at(fw), head & tail);
+      return;
+    }
+    apply(word_at(fw), head);
+    for (auto wx = fw + 1; wx < lw; ++wx) {
+      word_at(wx).store(val ? ~word(0) : word(0), std::memory_order_release);
+    }
+    apply(word_at(lw), tail);
+  }
+
+  std::unique_ptr<line[]> lines_;
+  size_type size_;
+};
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecbit::rank_select
+/*
+ *  rank_select<Alloc>: a bit_vector plus a succinct index answering
+ *  rank1(pos) (ones in [0, pos)) and select1(k) (position of the k-th one,
+ *  counting from 0), and their rank0/select0 duals, without a scan.
+ *
+ *  The layout follows Poppy (Zhou, Andersen, Kaminsky 2013).  Every 2048-bit
+ *  block has one 64-bit entry: 32 bits of ones before the block, counted
+ *  from the start of its 2^32-bit span, then three 10-bit counts for the
+ *  block's first three 512-bit (one cache line) sub-blocks.  One 64-bit
+ *  absolute count per span tops it up.  rank is one entry, up to three
+ *  sub-block adds and at most eight popcounts.  select starts from a
+ *  sampled block (every 8192th one and zero), binary searches the entries
+ *  to the next sample, walks at most three sub-blocks and eight words, and
+ *  finishes in the word with pdep + tzcnt where BMI2 is available.  Entries
+ *  cost 3.125% of the bits, the samples (32 bits per 8192 ones or zeros)
+ *  another 0.4%.
+ *
+ *  The index follows the bits through the mutators here.  push_back marks
+ *  the last block for a lazy rebuild of that block, which is O(1).
+ *  set/flip(pos) fix the block's own sub-block count and add the change to
+ *  a Fenwick tree over the blocks, O(log(n / 2048)); until the tree is
+ *  folded into the entries, rank adds its prefix sum, O(log(n / 2048))
+ *  too.  The next select, build() or rebuild folds it in one pass,
+ *  O(n / 2048) for any number of updates, and select resamples from the
+ *  first changed block.  Every select1/select0 after a set/flip(pos) pays
+ *  that fold, so a workload alternating one update with one select is
+ *  linear per query; batch the updates, or stick to rank between them.
+ *  flip() inverts the bits but keeps the index: queries then read it as
+ *  counting zeros.  Queries bring a lazy rebuild up to date, so like
+ *  bit_vector::hash they must not run concurrently with each other until
+ *  build() has been called after the last mutation.  Block numbers are
+ *  32-bit, so the limit is 2^43 bits.
+ */
+namespace detail {
+
+/*
+ *  The word loops of rank_select.  The bodies are written once and inlined
+ *  into a portable and (on x86) a popcnt+bmi2 flavour; the baseline build
+ *  would otherwise turn every popcount into a bit-twiddling sequence.
+ */
+#if defined(VECBIT_X86)
+inline bool const fast = []() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("popcnt") && __builtin_cpu_supports("bmi2");
+}();
+
+__attribute__((target("bmi2")))
+inline unsigned select_bmi2(word wd, unsigned kth) noexcept {
+  return static_cast<unsigned>(__builtin_ctzll(_pdep_u64(word(1) << kth, wd)));
+}
+#endif  /* defined(VECBIT_X86) */
+
+//  position of the kth (from 0) set bit of wd; kth < popcount(wd).
+inline unsigned select_portable(word wd, unsigned kth) noexcept {
+  auto pos = 0u;
+  for (auto width : { 32u, 16u, 8u, }) {
+    auto const low = static_cast<unsigned>(std::popcount(wd & ((word(1) << width) - 1)));
+    if (kth >= low) {
+      kth -= low;
+      wd >>= width;
+      pos += width;
+    }
+  }
+  for (; kth != 0; --kth) {
+    wd &= wd - 1;
+  }
+  return pos + static_cast<unsigned>(std::countr_zero(wd));
+}
+
+//  ones of (words ^ inv) in words [first, last), plus the low rest bits of
+//  word last.
+template <bool Fast>
+[[gnu::always_inline]]
+inline std::size_t rank_body(word const * wp, std::size_t first, std::size_t last,
+                             unsigned rest, word inv) noexcept {
+  auto ones = 0ul;
+  for (auto wx = first; wx < last; ++wx) {
+    ones += static_cast<std::size_t>(std::popcount(wp[wx] ^ inv));
+  }
+  if (rest != 0) {
+    ones += static_cast<std::size_t>(
+      std::popcount((wp[last] ^ inv) & ((word(1) << rest) - 1)));
+  }
+  return ones;
+}
+
+//  bit position of the kth one of (words ^ inv) from word wx on.
+template <bool Fast>
+[[gnu::always_inline]]
+inline std::size_t select_body(word const * wp, std::size_t wx, std::size_t kth,
+                               word inv) noexcept {
+  for (;; ++wx) {
+    auto const wd = wp[wx] ^ inv;
+    auto const count = static_cast<std::size_t>(std::popcount(wd));
+    if (kth < count) {
+#if defined(VECBIT_X86)
+      if constexpr (Fast) {
+        return wx * word_bits + select_bmi2(wd, static_cast<unsigned>(kth));
+      }
+#endif  /* defined(VECBIT_X86) */
+      return wx * word_bits + select_portable(wd, static_cast<unsigned>(kth));
+    }
+    kth -= count;
+  }
+}
+
+inline std::size_t rank_portable(word const * wp, std::size_t first, std::size_t last,
+                                 unsigned rest, word inv) noexcept {
+  return rank_body<false>(wp, first, last, rest, inv);
+}
+
+inline std::size_t select_portable(word const * wp, std::size_t wx, std::size_t kth,
+                                   word inv) noexcept {
+  return select_body<false>(wp, wx, kth, inv);
+}
+
+#if defined(VECBIT_X86)
+__attribute__((target("popcnt,bmi2")))
+inline std::size_t rank_fast(word const * wp, std::size_t first, std::size_t last,
+                             unsigned rest, word inv) noexcept {
+  return rank_body<true>(wp, first, last, rest, inv);
+}
+
+__attribute__((target("popcnt,bmi2")))
+inline std::size_t select_fast(word const * wp, std::size_t wx, std::size_t kth,
+                               word inv) noexcept {
+  return select_body<true>(wp, wx, kth, inv);
+}
+#endif  /* defined(VECBIT_X86) */
+
+inline std::size_t rank(word const * wp, std::size_t first, std::size_t last,
+                        unsigned rest, word inv) noexcept {
+#if defined(VECBIT_X86)
+  if (fast) {
+    return rank_fast(wp, first, last, rest, inv);
+  }
+#endif  /* defined(VECBIT_X86) */
+  return rank_portable(wp, first, last, rest, inv);
+}
+
+inline std::size_t select(word const * wp, std::size_t wx, std::size_t kth, word inv) noexcept {
+#if defined(VECBIT_X86)
+  if (fast) {
+    return select_fast(wp, wx, kth, inv);
+  }
+#endif  /* defined(VECBIT_X86) */
+  return select_portable(wp, wx, kth, inv);
+}
+
+} /* namespace detail */
+
+template <class Alloc = std::allocator<word>>
+class rank_select {
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type npos = bit_vector<Alloc>::npos;
+  static constexpr size_type block_bits = 2048;
+  static constexpr size_type block_words = block_bits / word_bits;
+  static constexpr size_type sub_bits = 512;
+  static constexpr size_type sub_words = sub_bits / word_bits;
+  static constexpr size_type span_blocks = (size_type(1) << 32) / block_bits;
+  static constexpr size_type sample_rate = 8192;
+
+  rank_select() = default;
+
+  explicit rank_select(bit_vector<Alloc> bits) : bits_(std::move(bits)) {}
+
+  bit_vector<Alloc> const & bits() const noexcept { return bits_; }
+
+  bit_vector<Alloc> release() && noexcept {
+    entries_.clear();
+    spans_.clear();
+    deltas_.clear();
+    pending_ = false;
+    dirty_ = 0;
+    return std::move(bits_);
+  }
+
+  size_type size() const noexcept { return bits_.size(); }
+
+  bool operator[](size_type pos) const noexcept { return bits_.test(pos); }
+
+  size_type count() const {
+    refresh();
+    return inverted_ ? size() - ones_ : ones_;
+  }
+
+  /// Modifiers
+  void reserve(size_type nb) { bits_.reserve(nb); }
+
+  void push_back(bool val) {
+    bits_.push_back(val);
+    dirty_ = std::min(dirty_, (size() - 1) / block_bits);
+  }
+
+  void set(size_type pos, bool val = true) {
+    if (bits_.test(pos) != val) {
+      flip(pos);
+    }
+  }
+
+  void flip(size_type pos) {
+    refresh();
+    bits_.flip(pos);
+    //  the indexed view is bits ^ inverted_.
+    adjust(pos, bits_.test(pos) != inverted_ ? 1 : -1);
+  }
+
+  void flip() {
+    bits_.flip();
+    inverted_ = !inverted_;
+  }
+
+  //  bring the index up to date, after which queries may run concurrently.
+  void build() const { sync(); }
+
+  /// Queries
+  //  ones in [0, pos), pos <= size().
+  size_type rank1(size_type pos) const {
+    refresh();
+    auto const ones = raw_rank(pos);
+    return inverted_ ? pos - ones : ones;
+  }
+
+  size_type rank0(size_type pos) const { return pos - rank1(pos); }
+
+  //  position of the kth one (from 0), or npos.
+  size_type select1(size_type kth) const {
+    return kth < count() ? raw_select(kth, !inverted_) : npos;
+  }
+
+  size_type select0(size_type kth) const {
+    return kth < size() - count() ? raw_select(kth, inverted_) : npos;
+  }
+
+  //  bytes of index on top of the bits.
+  size_type index_bytes() const noexcept {
+    return entries_.size() * sizeof(entries_[0]) + spans_.size() * sizeof(spans_[0])
+         + samples_[0].size() * sizeof(std::uint32_t) + samples_[1].size() * sizeof(std::uint32_t);
+  }
+
+private:
+  size_type blocks() const noexcept { return (size() + block_bits - 1) / block_bits; }
+
+  word inv() const noexcept { return inverted_ ? ~word(0) : word(0); }
+
+  //  ones of the indexed view before block bx.
+  size_type ones_before(size_type bx) const noexcept {
+    auto const ones = spans_[bx / span_blocks] + (entries_[bx] & 0xffff'ffffu);
+    return pending_ ? ones + static_cast<size_type>(pending_before(bx)) : ones;
+  }
+
+  static size_type low_bit(size_type ix) noexcept { return ix & (~ix + 1); }
+
+  //  the Fenwick sum of the changes in blocks [0, bx).
+  std::int64_t pending_before(size_type bx) const noexcept {
+    auto sum = std::int64_t(0);
+    for (auto ix = bx; ix != 0; ix -= low_bit(ix)) {
+      sum += deltas_[ix - 1];
+    }
+    return sum;
+  }
+
+  size_type before(size_type bx, bool one) const noexcept {
+    return one ? ones_before(bx) : bx * block_bits - ones_before(bx);
+  }
+
+  static size_type sub_count(std::uint64_t ent, size_type sx) noexcept {
+    return (ent >> (32 + 10 * sx)) & 0x3ff;
+  }
+
+  //  entries only: enough for rank and for the in-place updates.
+  void refresh() const {
+    if (dirty_ != npos) {
+      fold();
+      rebuild(dirty_);
+      resample_ = std::min(resample_, dirty_);
+      dirty_ = npos;
+    }
+  }
+
+  void sync() const {
+    refresh();
+    fold();
+    if (resample_ != npos) {
+      resample(resample_);
+      resample_ = npos;
+    }
+  }
+
+  //  entries from block from (which is at most the old sentinel) onwards.
+  void rebuild(size_type from) const {
+    auto const nb = blocks();
+    auto running = from == 0 ? size_type(0) : ones_before(from);
+    entries_.resize(nb + 1);
+    spans_.resize(nb / span_blocks + 1);
+    auto const wp = bits_.words().data();
+    for (auto bx = from; bx <= nb; ++bx) {
+      if (bx % span_blocks == 0) {
+        spans_[bx / span_blocks] = running;
+      }
+      std::uint64_t ent = running - spans_[bx / span_blocks];
+      for (auto sx = 0ul; sx < 4 && bx < nb; ++sx) {
+        auto const first = bx * block_bits + sx * sub_bits;
+        auto const last = std::min(first + sub_bits, std::max(first, size()));
+        auto const count = detail::rank(wp, first / word_bits, last / word_bits,
+                                        static_cast<unsigned>(last % word_bits), inv());
+        if (sx < 3) {
+          ent |= std::uint64_t(count) << (32 + 10 * sx);
+        }
+        running += count;
+      }
+      entries_[bx] = ent;
+    }
+    ones_ = running;
+  }
+
+  //  the select samples whose target lies at or after block from.
+  void resample(size_type from) const {
+    auto const nb = blocks();
+    for (auto one : { false, true, }) {
+      auto & samples = samples_[one];
+      auto const keep = (before(from, one) + sample_rate - 1) / sample_rate;
+      samples.resize(std::min(samples.size(), keep));
+      auto target = samples.size() * sample_rate;
+      for (auto bx = from; bx < nb; ++bx) {
+        auto const next = bx + 1 < nb ? before(bx + 1, one)
+                                      : (one ? ones_ : size() - ones_);
+        for (; target < next; target += sample_rate) {
+          samples.push_back(static_cast<std::uint32_t>(bx));
+        }
+      }
+    }
+  }
+
+  //  one bit of the indexed view changed by delta at pos.  deltas_ is all
+  //  zero unless pending_, so it only needs resizing then.
+  void adjust(size_type pos, int delta) {
+    auto const bx = pos / block_bits;
+    auto const sx = pos % block_bits / sub_bits;
+    if (sx < 3) {
+      entries_[bx] += std::uint64_t(std::int64_t(delta)) << (32 + 10 * sx);
+    }
+    if (!pending_) {
+      deltas_.resize(entries_.size());
+      pending_ = true;
+    }
+    for (auto ix = bx + 1; ix <= deltas_.size(); ix += low_bit(ix)) {
+      deltas_[ix - 1] += delta;
+    }
+    ones_ += delta;
+    resample_ = std::min(resample_, bx);
+  }
+
+  //  add the pending changes to spans_ and entries_ and zero deltas_.
+  void fold() const {
+    if (!pending_) {
+      return;
+    }
+    //  Fenwick sums back to per-block changes: a node still holds its
+    //  original sum when its parent (the higher index) subtracts it.
+    auto const nd = deltas_.size();
+    for (auto ix = nd; ix != 0; --ix) {
+      if (auto const up = ix + low_bit(ix); up <= nd) {
+        deltas_[up - 1] -= deltas_[ix - 1];
+      }
+    }
+    auto running = std::int64_t(0);
+    auto span_start = std::int64_t(0);
+    for (auto bx = 0ul; bx < nd; ++bx) {
+      if (bx % span_blocks == 0) {
+        spans_[bx / span_blocks] += running;
+        span_start = running;
+      }
+      entries_[bx] += std::uint64_t(running - span_start);
+      running += std::exchange(deltas_[bx], 0);
+    }
+    pending_ = false;
+  }
+
+  size_type raw_rank(size_type pos) const noexcept {
+    auto const bx = pos / block_bits;
+    auto const ent = entries_[bx];
+    auto ones = ones_before(bx);
+    auto const sx = pos % block_bits / sub_bits;
+    for (auto sb = 0ul; sb < sx; ++sb) {
+      ones += sub_count(ent, sb);
+    }
+    return ones + detail::rank(bits_.words().data(), bx * block_words + sx * sub_words,
+                               pos / word_bits, static_cast<unsigned>(pos % word_bits), inv());
+  }
+
+  //  kth one (one) or zero of the indexed view; kth is in range.
+  size_type raw_select(size_type kth, bool one) const {
+    sync();
+    auto const & samples = samples_[one];
+    auto const sx = kth / sample_rate;
+    auto lo = size_type(samples[sx]);
+    auto hi = sx + 1 < samples.size() ? size_type(samples[sx + 1]) + 1 : blocks();
+    while (hi - lo > 1) {
+      auto const mid = lo + (hi - lo) / 2;
+      if (before(mid, one) <= kth) {
+        lo = mid;
+      }
+      else {
+        hi = mid;
+      }
+    }
+    kth -= before(lo, one);
+    auto const ent = entries_[lo];
+    auto wx = lo * block_words;
+    for (auto sb = 0ul; sb < 3; ++sb) {
+      auto const count = one ? sub_count(ent, sb) : sub_bits - sub_count(ent, sb);
+      if (kth < count) {
+        break;
+      }
+      kth -= count;
+      wx += sub_words;
+    }
+    return detail::select(bits_.words().data(), wx, kth, one ? inv() : ~inv());
+  }
+
+  bit_vector<Alloc> bits_;
+  bool inverted_ { false };
+  mutable std::vector<std::uint64_t> entries_;
+  mutable std::vector<std::uint64_t> spans_;
+  mutable std::vector<std::int64_t> deltas_;                    //  Fenwick, by block
+  mutable std::array<std::vector<std::uint32_t>, 2> samples_;   //  [zero, one]
+  mutable size_type ones_ { 0 };
+  mutable size_type dirty_ { 0 };
+  mutable size_type resample_ { npos };
+  mutable bool pending_ { false };
+};
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecbit::roaring
+/*
+ *  roaring: a compressed bitmap in the style of Roaring (Chambi, Lemire,
+ *  Kaser, Godin 2016; Lemire et al. 2018), for bit sequences too sparse or
+ *  too clustered to pay one bit per position.  Positions are split into
+ *  2^16-bit chunks by their high 16 bits.  Only chunks holding a one are
+ *  stored, each in the smallest of three containers:
+ *
+ *    array   the sorted low 16 bits of each one, at most 4096 (8 KiB)
+ *    bitmap  1024 words, for more than 4096 ones
+ *    run     sorted (start, length - 1) pairs, for clustered ones
+ *
+ *  The interface follows bit_vector: push_back, set/test/flip, &=, |=, ^=,
+ *  and_not, find_first/find_next, count.  The operands of the bulk
+ *  operations may differ in size; the shorter one reads as zero-extended
+ *  and the result takes the larger size.  Positions are 32-bit, so size()
+ *  is at most 2^32.
+ *
+ *  set/flip(pos) cost a binary search over the chunks plus an insert into
+ *  an array or run list.  push_back re-optimizes a chunk (array, bitmap or
+ *  run, whichever is smallest) as it fills it, and the bulk operations
+ *  re-optimize every chunk they produce; optimize() does all of them.  The
+ *  bulk operations go chunk by chunk: array/array by merging, an array
+ *  against anything by probing, the rest on 1024-word bitmaps through the
+ *  kernel:: loops.
+ *
+ *  serialize() writes a 64-bit size followed by the portable Roaring format
+ *  (the one CRoaring, Java and Go Roaring read and write); deserialize()
+ *  checks what it reads.  hash() equals bit_vector::hash() for the same
+ *  bits, and is cached like it: O(size / 64) on the first call after a
+ *  mutation, since zero chunks are hashed too.
+ */
+class roaring {
+public:
+  using size_type = std::size_t;
+
+  enum class kind : std::uint8_t { array, bitmap, run, };
+
+  static constexpr size_type npos = std::numeric_limits<size_type>::max();
+  static constexpr size_type chunk_bits = size_type(1) << 16;
+  static constexpr size_type chunk_words = chunk_bits / word_bits;
+  static constexpr size_type array_max = 4096;
+  static constexpr size_type max_bits = size_type(1) << 32;
+
+  //  containers by kind, and the heap plus object bytes.
+  struct usage {
+    size_type arrays { 0 };
+    size_type bitmaps { 0 };
+    size_type runs { 0 };
+    size_type bytes { 0 };
+  };
+
+private:
+  struct chunk {
+    std::uint16_t key { 0 };
+    kind type { kind::array };
+    std::uint32_t card { 0 };
+    std::vector<std::uint16_t> vals;   //  array: values; run: start, length - 1 pairs
+    std::vector<word> bits;            //  bitmap: chunk_words words
+  };
+
+public:
+  //  forward iterator over the positions of the ones, in order.
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = size_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = size_type;
+
+    const_iterator() = default;
+
+    size_type operator*() const noexcept {
+      return size_type(rb_->chunks_[cx_].key) << 16 | val_;
+    }
+
+    const_iterator & operator++() noexcept {
+      advance();
+      return *this;
+    }
+
+    const_iterator operator++(int) noexcept {
+      auto tmp = *this;
+      advance();
+      return tmp;
+    }
+
+    friend bool operator==(const_iterator const & lhs, const_iterator const & rhs) noexcept {
+      return lhs.cx_ == rhs.cx_ && lhs.val_ == rhs.val_;
+    }
+
+  private:
+    friend class roaring;
+    const_iterator(roaring const * rb, size_type cx) noexcept : rb_(rb), cx_(cx) { enter(); }
+
+    //  the first one of chunk cx_; chunks are never empty.
+    void enter() noexcept {
+      ix_ = 0;
+      val_ = 0;
+      if (cx_ == rb_->chunks_.size()) {
+        return;
+      }
+      auto const & ck = rb_->chunks_[cx_];
+      if (ck.type != kind::bitmap) {
+        val_ = ck.vals[0];
+        return;
+      }
+      for (cur_ = ck.bits[0]; cur_ == 0; cur_ = ck.bits[++ix_]) {}
+      val_ = ix_ * std::uint32_t(word_bits) + static_cast<std::uint32_t>(std::countr_zero(cur_));
+    }
+
+    void advance() noexcept {
+      auto const & ck = rb_->chunks_[cx_];
+      switch (ck.type) {
+      case kind::array:
+        if (++ix_ < ck.card) {
+          val_ = ck.vals[ix_];
+          return;
+        }
+        break;
+      case kind::run:
+        if (val_ < std::uint32_t(ck.vals[ix_]) + ck.vals[ix_ + 1]) {
+          ++val_;
+          return;
+        }
+        if ((ix_ += 2) < ck.vals.size()) {
+          val_ = ck.vals[ix_];
+          return;
+        }
+        break;
+      case kind::bitmap:
+        cur_ &= cur_ - 1;
+        while (cur_ == 0 && ++ix_ < chunk_words) {
+          cur_ = ck.bits[ix_];
+        }
+        if (ix_ < chunk_words) {
+          val_ = ix_ * std::uint32_t(word_bits) + static_cast<std::uint32_t>(std::countr_zero(cur_));
+          return;
+        }
+        break;
+      }
+      ++cx_;
+      enter();
+    }
+
+    roaring const * rb_ = nullptr;
+    size_type cx_ = 0;
+    std::uint32_t ix_ = 0;       //  array index, run pair index or bitmap word
+    std::uint32_t val_ = 0;      //  low 16 bits of the current one
+    word cur_ = 0;               //  bitmap: the bits of word ix_ not yet visited
+  };
+
+  roaring() = default;
+
+  roaring(roaring const &) = default;
+  roaring & operator=(roaring const &) = default;
+
+  //  the source is left empty, with no cached hash.
+  roaring(roaring && other) noexcept
+    : chunks_(std::move(other.chunks_)),
+      size_(std::exchange(other.size_, 0)),
+      hash_(other.hash_),
+      hashed_(std::exchange(other.hashed_, false)) {}
+
+  roaring & operator=(roaring && other) noexcept {
+    chunks_ = std::move(other.chunks_);
+    other.chunks_.clear();
+    size_ = std::exchange(other.size_, 0);
+    hash_ = other.hash_;
+    hashed_ = std::exchange(other.hashed_, false);
+    return *this;
+  }
+
+  explicit roaring(size_type nb, bool val = false) { resize(nb, val); }
+
+  template <class Alloc>
+  explicit roaring(bit_vector<Alloc> const & bv) : size_(bv.size()) {
+    assert(bv.size() <= max_bits);
+    auto const src = bv.words();
+    std::array<word, chunk_words> buf;
+    for (auto wx = 0ul; wx < src.size(); wx += chunk_words) {
+      auto const nw = std::min(chunk_words, src.size() - wx);
+      buf.fill(0);
+      std::copy_n(src.data() + wx, nw, buf.data());
+      chunk ck;
+      ck.key = static_cast<std::uint16_t>(wx / chunk_words);
+      if (load(ck, buf.data())) {
+        chunks_.push_back(std::move(ck));
+      }
+    }
+  }
+
+  /// Element access
+  bool test(size_type pos) const noexcept {
+    auto const cx = locate(pos);
+    return cx != npos && contains(chunks_[cx], low(pos));
+  }
+
+  bool operator[](size_type pos) const noexcept { return test(pos); }
+
+  /// Iterators
+  const_iterator begin() const noexcept { return { this, 0, }; }
+  const_iterator end() const noexcept { return { this, chunks_.size(), }; }
+
+  //  calls fn(pos) for each one, in order; faster than the iterators.
+  template <class Fn>
+  void for_each(Fn fn) const {
+    for (auto const & ck : chunks_) {
+      size_type const base = size_type(ck.key) << 16;
+      switch (ck.type) {
+      case kind::array:
+        for (auto const val : ck.vals) {
+          fn(base | val);
+        }
+        break;
+      case kind::run:
+        for (auto ix = 0ul; ix < ck.vals.size(); ix += 2) {
+          for (size_type val = ck.vals[ix], last = val + ck.vals[ix + 1]; val <= last; ++val) {
+            fn(base | val);
+          }
+        }
+        break;
+      case kind::bitmap:
+        for (auto wx = 0ul; wx < chunk_words; ++wx) {
+          for (auto wd = ck.bits[wx]; wd != 0; wd &= wd - 1) {
+            fn(base | (wx * word_bits + static_cast<size_type>(std::countr_zero(wd))));
+          }
+        }
+        break;
+      }
+    }
+  }
+
+  /// Capacity
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+
+  usage footprint() const noexcept {
+    usage us;
+    us.bytes = sizeof *this + chunks_.capacity() * sizeof(chunk);
+    for (auto const & ck : chunks_) {
+      ++(ck.type == kind::array ? us.arrays : ck.type == kind::bitmap ? us.bitmaps : us.runs);
+      us.bytes += ck.vals.capacity() * sizeof(std::uint16_t) + ck.bits.capacity() * sizeof(word);
+    }
+    return us;
+  }
+
+  /// Modifiers
+  void clear() noexcept {
+    touch();
+    chunks_.clear();
+    size_ = 0;
+  }
+
+  void push_back(bool val) {
+    assert(size_ < max_bits);
+    touch();
+    auto const pos = size_++;
+    //  the chunk before pos is complete: settle its container.
+    if (low(pos) == 0 && !chunks_.empty() && chunks_.back().key + 1u == pos >> 16) {
+      optimize(chunks_.back());
+    }
+    if (!val) {
+      return;
+    }
+    if (chunks_.empty() || chunks_.back().key != pos >> 16) {
+      //  a new chunk starts as a run: a stream of ones extends it in place.
+      chunk ck;
+      ck.key = static_cast<std::uint16_t>(pos >> 16);
+      ck.type = kind::run;
+      ck.card = 1;
+      ck.vals = { low(pos), 0, };
+      chunks_.push_back(std::move(ck));
+      return;
+    }
+    auto & ck = chunks_.back();
+    if (ck.type == kind::run && low(pos) == ck.vals[ck.vals.size() - 2] + ck.vals.back() + 1u) {
+      ++ck.vals.back();
+      ++ck.card;
+      return;
+    }
+    add(ck, low(pos));
+  }
+
+  //  new positions take val; shrinking drops the ones past nb.
+  void resize(size_type nb, bool val = false) {
+    assert(nb <= max_bits);
+    touch();
+    if (nb < size_) {
+      auto const keep = (nb + chunk_bits - 1) >> 16;
+      chunks_.erase(chunks_.begin() + static_cast<std::ptrdiff_t>(lower(keep)), chunks_.end());
+      if (!chunks_.empty() && low(nb) != 0 && chunks_.back().key == nb >> 16) {
+        std::array<word, chunk_words> buf {};
+        paint(chunks_.back(), buf.data());
+        clip(buf.data(), low(nb));
+        if (!load(chunks_.back(), buf.data())) {
+          chunks_.pop_back();
+        }
+      }
+      size_ = nb;
+      return;
+    }
+    auto const old = size_;
+    size_ = nb;
+    if (val) {
+      fill(old, nb);
+    }
+  }
+
+  void swap(roaring & other) noexcept {
+    chunks_.swap(other.chunks_);
+    std::swap(size_, other.size_);
+    std::swap(hash_, other.hash_);
+    std::swap(hashed_, other.hashed_);
+  }
+
+  roaring & set(size_type pos, bool val = true) {
+    assert(pos < size_);
+    touch();
+    auto const key = static_cast<std::uint16_t>(pos >> 16);
+    auto const it = chunks_.begin() + static_cast<std::ptrdiff_t>(lower(key));
+    if (it != chunks_.end() && it->key == key) {
+      if (val) {
+        add(*it, low(pos));
+      }
+      else if (remove(*it, low(pos)) && it->card == 0) {
+        chunks_.erase(it);
+      }
+    }
+    else if (val) {
+      chunk ck;
+      ck.key = key;
+      ck.card = 1;
+      ck.vals = { low(pos), };
+      chunks_.insert(it, std::move(ck));
+    }
+    return *this;
+  }
+
+  roaring & reset(size_type pos) { return set(pos, false); }
+
+  roaring & flip(size_type pos) { return set(pos, !test(pos)); }
+
+  //  complement within [0, size()).
+  roaring & flip() {
+    touch();
+    std::vector<chunk> out;
+    std::array<word, chunk_words> buf;
+    auto cx = 0ul;
+    auto const nchunks = (size_ + chunk_bits - 1) >> 16;
+    for (auto key = 0ul; key < nchunks; ++key) {
+      buf.fill(0);
+      chunk ck;
+      if (cx < chunks_.size() && chunks_[cx].key == key) {
+        ck = std::move(chunks_[cx++]);
+        paint(ck, buf.data());
+      }
+      ck.key = static_cast<std::uint16_t>(key);
+      kernel::invert(buf.data(), chunk_words);
+      clip(buf.data(), std::min(chunk_bits, size_ - (key << 16)));
+      if (load(ck, buf.data())) {
+        out.push_back(std::move(ck));
+      }
+    }
+    chunks_.swap(out);
+    return *this;
+  }
+
+  //  choose the smallest container for every chunk.
+  roaring & optimize() {
+    for (auto & ck : chunks_) {
+      optimize(ck);
+    }
+    chunks_.shrink_to_fit();
+    return *this;
+  }
+
+  /// Bulk operations
+  roaring & operator&=(roaring const & other) { return *this = combine<kernel::bitop::and_>(*this, other); }
+  roaring & operator|=(roaring const & other) { return *this = combine<kernel::bitop::or_>(*this, other); }
+  roaring & operator^=(roaring const & other) { return *this = combine<kernel::bitop::xor_>(*this, other); }
+  roaring & and_not(roaring const & other) { return *this = combine<kernel::bitop::andnot>(*this, other); }
+
+  friend roaring operator&(roaring const & lhs, roaring const & rhs) { return combine<kernel::bitop::and_>(lhs, rhs); }
+  friend roaring operator|(roaring const & lhs, roaring const & rhs) { return combine<kernel::bitop::or_>(lhs, rhs); }
+  friend roaring operator^(roaring const & lhs, roaring const & rhs) { return combine<kernel::bitop::xor_>(lhs, rhs); }
+
+  /// Queries
+  size_type count() const noexcept {
+    auto ones = 0ul;
+    for (auto const & ck : chunks_) {
+      ones += ck.card;
+    }
+    return ones;
+  }
+
+  bool any() const noexcept { return !chunks_.empty(); }
+  bool none() const noexcept { return chunks_.empty(); }
+  bool all() const noexcept { return count() == size_; }
+
+  size_type find_first() const noexcept {
+    return chunks_.empty() ? npos : *begin();
+  }
+
+  //  first set bit after pos, or npos.
+  size_type find_next(size_type pos) const noexcept {
+    if (++pos >= size_) {
+      return npos;
+    }
+    auto const key = static_cast<std::uint16_t>(pos >> 16);
+    auto cx = lower(key);
+    if (cx < chunks_.size() && chunks_[cx].key == key) {
+      auto const val = next(chunks_[cx], low(pos));
+      if (val < chunk_bits) {
+        return size_type(key) << 16 | val;
+      }
+      ++cx;
+    }
+    return cx < chunks_.size() ? *const_iterator(this, cx) : npos;
+  }
+
+  //  the hash of a bit_vector holding the same bits; cached until the next
+  //  mutation, and so not safe to call concurrently on the same object.
+  std::size_t hash() const noexcept {
+    if (hashed_) {
+      return static_cast<std::size_t>(hash_);
+    }
+    auto const nw = (size_ + word_bits - 1) / word_bits;
+    kernel::hashing::lanes st;
+    std::array<word, chunk_words> buf;
+    auto cx = 0ul;
+    auto tail = 0ul;
+    for (auto wx = 0ul; wx < nw; wx += chunk_words) {
+      buf.fill(0);
+      if (cx < chunks_.size() && chunks_[cx].key == wx / chunk_words) {
+        paint(chunks_[cx++], buf.data());
+      }
+      auto const part = std::min(chunk_words, nw - wx);
+      tail = part % 4;
+      st.stripes(buf.data(), part - tail);
+      if (tail != 0) {
+        std::copy_n(buf.data() + part - tail, tail, buf.data());
+      }
+    }
+    hash_ = kernel::hashing::finish(st.acc, buf.data(), tail, size_, 0);
+    hashed_ = true;
+    return static_cast<std::size_t>(hash_);
+  }
+
+  //  the same bits, whatever the containers.
+  friend bool operator==(roaring const & lhs, roaring const & rhs) {
+    if (lhs.size_ != rhs.size_ || lhs.chunks_.size() != rhs.chunks_.size()) {
+      return false;
+    }
+    std::array<word, chunk_words> lbuf, rbuf;
+    for (auto cx = 0ul; cx < lhs.chunks_.size(); ++cx) {
+      auto const & lc = lhs.chunks_[cx];
+      auto const & rc = rhs.chunks_[cx];
+      if (lc.key != rc.key || lc.card != rc.card) {
+        return false;
+      }
+      if (lc.type == rc.type) {
+        if (lc.vals != rc.vals || lc.bits != rc.bits) {
+          return false;
+        }
+        continue;
+      }
+      lbuf.fill(0);
+      rbuf.fill(0);
+      paint(lc, lbuf.data());
+      paint(rc, rbuf.data());
+      if (lbuf != rbuf) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Serialization
+  //  64-bit size, then the portable Roaring format, all little-endian.
+  std::string serialize() const {
+    std::string out;
+    put(out, size_, 8);
+    auto const nc = chunks_.size();
+    auto const has_run = std::any_of(chunks_.begin(), chunks_.end(),
+                                     [](chunk const & ck) { return ck.type == kind::run; });
+    auto const body = out.size();
+    if (has_run) {
+      put(out, cookie_run | (nc - 1) << 16, 4);
+      std::string marks((nc + 7) / 8, '\0');
+      for (auto cx = 0ul; cx < nc; ++cx) {
+        if (chunks_[cx].type == kind::run) {
+          marks[cx / 8] = static_cast<char>(marks[cx / 8] | 1 << cx % 8);
+        }
+      }
+      out += marks;
+    }
+    else {
+      put(out, cookie, 4);
+      put(out, nc, 4);
+    }
+    for (auto const & ck : chunks_) {
+      put(out, ck.key, 2);
+      put(out, ck.card - 1, 2);
+    }
+    if (!has_run || nc >= offsets_min) {
+      auto offset = out.size() - body + nc * 4;
+      for (auto const & ck : chunks_) {
+        put(out, offset, 4);
+        offset += payload(ck);
+      }
+    }
+    for (auto const & ck : chunks_) {
+      if (ck.type == kind::run) {
+        put(out, ck.vals.size() / 2, 2);
+      }
+      if (ck.type == kind::bitmap) {
+        for (auto const wd : ck.bits) {
+          put(out, wd, 8);
+        }
+        continue;
+      }
+      for (auto const val : ck.vals) {
+        put(out, val, 2);
+      }
+    }
+    return out;
+  }
+
+  static roaring deserialize(std::string_view in) {
+    auto fail = [](char const * why) {
+      throw std::runtime_error("vecbit::roaring: "s + why);
+    };
+    auto at = 0ul;
+    auto skip = [&](std::size_t nb) {
+      if (in.size() - at < nb) {
+        fail("truncated");
+      }
+      at += nb;
+      return in.substr(at - nb, nb);
+    };
+    auto get = [&](std::size_t nb) {
+      auto const bytes = skip(nb);
+      std::uint64_t val = 0;
+      for (auto ix = 0ul; ix < nb; ++ix) {
+        val |= std::uint64_t(static_cast<unsigned char>(bytes[ix])) << 8 * ix;
+      }
+      return val;
     };
+    roaring rb;
+    rb.size_ = get(8);
+    if (rb.size_ > max_bits) {
+      fail("size");
+    }
+    auto const head = get(4);
+    auto const has_run = (head & 0xffff) == cookie_run;
+    if (!has_run && head != cookie) {
+      fail("cookie");
+    }
+    auto const nc = has_run ? (head >> 16) + 1 : get(4);
+    if (nc > (max_bits >> 16)) {
+      fail("container count");
+    }
+    auto const marks = has_run ? skip((nc + 7) / 8) : std::string_view();
+    rb.chunks_.resize(nc);
+    for (auto cx = 0ul; cx < nc; ++cx) {
+      auto & ck = rb.chunks_[cx];
+      ck.key = static_cast<std::uint16_t>(get(2));
+      ck.card = static_cast<std::uint32_t>(get(2) + 1);
+      if (cx != 0 && ck.key <= rb.chunks_[cx - 1].key) {
+        fail("keys out of order");
+      }
+      auto const run = has_run && (static_cast<unsigned char>(marks[cx / 8]) >> cx % 8 & 1) != 0;
+      ck.type = run ? kind::run : ck.card <= array_max ? kind::array : kind::bitmap;
+    }
+    if (!has_run || nc >= offsets_min) {
+      skip(nc * 4);
+    }
+    for (auto & ck : rb.chunks_) {
+      std::uint32_t card = 0;
+      switch (ck.type) {
+      case kind::array:
+        ck.vals.resize(ck.card);
+        for (auto & val : ck.vals) {
+          val = static_cast<std::uint16_t>(get(2));
+        }
+        card = static_cast<std::uint32_t>(
+          std::adjacent_find(ck.vals.begin(), ck.vals.end(), std::greater_equal<>()) == ck.vals.end()
+          ? ck.vals.size() : 0);
+        break;
+      case kind::bitmap:
+        ck.bits.resize(chunk_words);
+        for (auto & wd : ck.bits) {
+          wd = get(8);
+        }
+        card = static_cast<std::uint32_t>(kernel::popcount(ck.bits.data(), chunk_words));
+        break;
+      case kind::run:
+        ck.vals.resize(get(2) * 2);
+        for (auto & val : ck.vals) {
+          val = static_cast<std::uint16_t>(get(2));
+        }
+        //  runs ascend with a gap between them and stay in the chunk.
+        for (auto ix = 0ul; ix < ck.vals.size(); ix += 2) {
+          auto const last = std::uint32_t(ck.vals[ix]) + ck.vals[ix + 1];
+          if (last >= chunk_bits || (ix + 2 < ck.vals.size() && last + 1 >= ck.vals[ix + 2])) {
+            card = 0;
+            break;
+          }
+          card += ck.vals[ix + 1] + 1u;
+        }
+        break;
+      }
+      if (card != ck.card) {
+        fail("container does not match its header");
+      }
+    }
+    if (at != in.size()) {
+      fail("trailing bytes");
+    }
+    if (!rb.chunks_.empty() && rb.find_last() >= rb.size_) {
+      fail("bit past the size");
+    }
+    return rb;
+  }
+
+private:
+  static constexpr std::uint64_t cookie = 12346;
+  static constexpr std::uint64_t cookie_run = 12347;
+  static constexpr size_type offsets_min = 4;   //  run format: offsets only from 4 containers
+
+  static std::uint16_t low(size_type pos) noexcept { return static_cast<std::uint16_t>(pos); }
+
+  static void put(std::string & out, std::uint64_t val, std::size_t nb) {
+    for (auto ix = 0ul; ix < nb; ++ix) {
+      out.push_back(static_cast<char>(val >> 8 * ix));
+    }
+  }
+
+  void touch() noexcept { hashed_ = false; }
+
+  //  index of the first chunk with a key >= key.  Keys ascend from 0, so
+  //  when every chunk so far is present chunk key sits at index key.
+  size_type lower(size_type key) const noexcept {
+    if (key < chunks_.size() && chunks_[key].key == key) {
+      return key;
+    }
+    return static_cast<size_type>(
+      std::lower_bound(chunks_.begin(), chunks_.end(), key,
+                       [](chunk const & ck, size_type kv) { return ck.key < kv; })
+      - chunks_.begin());
+  }
+
+  //  index of the chunk holding pos, or npos.
+  size_type locate(size_type pos) const noexcept {
+    auto const cx = lower(pos >> 16);
+    return cx < chunks_.size() && chunks_[cx].key == pos >> 16 ? cx : npos;
+  }
+
+  size_type find_last() const noexcept {
+    auto const & ck = chunks_.back();
+    size_type val = 0;
+    switch (ck.type) {
+    case kind::array:
+      val = ck.vals.back();
+      break;
+    case kind::run:
+      val = size_type(ck.vals[ck.vals.size() - 2]) + ck.vals.back();
+      break;
+    case kind::bitmap: {
+      auto wx = chunk_words;
+      while (ck.bits[--wx] == 0) {}
+      val = wx * word_bits + word_bits - 1 - static_cast<size_type>(std::countl_zero(ck.bits[wx]));
+      break;
+    }
+    }
+    return size_type(ck.key) << 16 | val;
+  }
+
+  //  serialized container bytes.
+  static size_type payload(chunk const & ck) noexcept {
+    switch (ck.type) {
+    case kind::array: return ck.card * 2ul;
+    case kind::bitmap: return chunk_words * 8;
+    case kind::run: return 2 + ck.vals.size() * 2;
+    }
+    return 0;
+  }
+
+  //  index of the run pair (in vals) starting at or before val, or npos.
+  static size_type run_at(std::vector<std::uint16_t> const & vals, std::uint16_t val) noexcept {
+    size_type lo = 0, hi = vals.size() / 2;
+    while (lo < hi) {
+      auto const mid = lo + (hi - lo) / 2;
+      if (vals[mid * 2] <= val) {
+        lo = mid + 1;
+      }
+      else {
+        hi = mid;
+      }
+    }
+    return lo == 0 ? npos : (lo - 1) * 2;
+  }
+
+  static bool contains(chunk const & ck, std::uint16_t val) noexcept {
+    switch (ck.type) {
+    case kind::array:
+      return std::binary_search(ck.vals.begin(), ck.vals.end(), val);
+    case kind::bitmap:
+      return (ck.bits[val / word_bits] >> val % word_bits & 1) != 0;
+    case kind::run: {
+      auto const rx = run_at(ck.vals, val);
+      return rx != npos && val <= std::uint32_t(ck.vals[rx]) + ck.vals[rx + 1];
+    }
+    }
+    return false;
+  }
+
+  //  the first one at or after val, or chunk_bits.
+  static size_type next(chunk const & ck, std::uint16_t val) noexcept {
+    switch (ck.type) {
+    case kind::array: {
+      auto const it = std::lower_bound(ck.vals.begin(), ck.vals.end(), val);
+      return it == ck.vals.end() ? chunk_bits : *it;
+    }
+    case kind::bitmap: {
+      auto wx = size_type(val / word_bits);
+      auto wd = ck.bits[wx] & (~word(0) << val % word_bits);
+      while (wd == 0 && ++wx < chunk_words) {
+        wd = ck.bits[wx];
+      }
+      return wd == 0 ? chunk_bits : wx * word_bits + static_cast<size_type>(std::countr_zero(wd));
+    }
+    case kind::run: {
+      auto rx = run_at(ck.vals, val);
+      if (rx != npos && val <= std::uint32_t(ck.vals[rx]) + ck.vals[rx + 1]) {
+        return val;
+      }
+      rx = rx == npos ? 0 : rx + 2;
+      return rx < ck.vals.size() ? ck.vals[rx] : chunk_bits;
+    }
+    }
+    return chunk_bits;
+  }
+
+  //  set [first, last) within one chunk's words.
+  static void paint_range(word * wp, size_type first, size_type last) noexcept {
+    for (; first < last && first % word_bits != 0; ++first) {
+      wp[first / word_bits] |= word(1) << first % word_bits;
+    }
+    for (; first + word_bits <= last; first += word_bits) {
+      wp[first / word_bits] = ~word(0);
+    }
+    for (; first < last; ++first) {
+      wp[first / word_bits] |= word(1) << first % word_bits;
+    }
+  }
+
+  //  OR the chunk's ones into 1024 words.
+  static void paint(chunk const & ck, word * wp) noexcept {
+    switch (ck.type) {
+    case kind::array:
+      for (auto const val : ck.vals) {
+        wp[val / word_bits] |= word(1) << val % word_bits;
+      }
+      break;
+    case kind::bitmap:
+      kernel::binary<kernel::bitop::or_>(wp, ck.bits.data(), chunk_words);
+      break;
+    case kind::run:
+      for (auto ix = 0ul; ix < ck.vals.size(); ix += 2) {
+        paint_range(wp, ck.vals[ix], size_type(ck.vals[ix]) + ck.vals[ix + 1] + 1);
+      }
+      break;
+    }
+  }
+
+  //  clear the bits from nb on.
+  static void clip(word * wp, size_type nb) noexcept {
+    if (nb % word_bits != 0) {
+      wp[nb / word_bits] &= ~(~word(0) << nb % word_bits);
+    }
+    std::fill(wp + (nb + word_bits - 1) / word_bits, wp + chunk_words, word(0));
+  }
+
+  //  runs of ones in 1024 words: the ones with a zero (or nothing) below.
+  static size_type runs_in(word const * wp) noexcept {
+    auto runs = 0ul;
+    word carry = 0;
+    for (auto wx = 0ul; wx < chunk_words; ++wx) {
+      runs += static_cast<size_type>(std::popcount(wp[wx] & ~(wp[wx] << 1 | carry)));
+      carry = wp[wx] >> (word_bits - 1);
+    }
+    return runs;
+  }
+
+  static size_type runs_in(chunk const & ck) noexcept {
+    switch (ck.type) {
+    case kind::array: {
+      auto runs = 1ul;
+      for (auto ix = 1ul; ix < ck.vals.size(); ++ix) {
+        runs += ck.vals[ix] != ck.vals[ix - 1] + 1;
+      }
+      return runs;
+    }
+    case kind::bitmap:
+      return runs_in(ck.bits.data());
+    case kind::run:
+      return ck.vals.size() / 2;
+    }
+    return 0;
+  }
+
+  //  the smallest kind for card ones in runs runs.
+  static kind best(size_type card, size_type runs) noexcept {
+    auto const dense = card <= array_max ? card * 2 : chunk_words * 8;
+    if (2 + runs * 4 < dense) {
+      return kind::run;
+    }
+    return card <= array_max ? kind::array : kind::bitmap;
+  }
+
+  //  rebuild ck (keeping its key) from 1024 words; false when they are all zero.
+  static bool load(chunk & ck, word const * wp) {
+    ck.card = static_cast<std::uint32_t>(kernel::popcount(wp, chunk_words));
+    if (ck.card == 0) {
+      return false;
+    }
+    ck.type = best(ck.card, runs_in(wp));
+    ck.vals.clear();
+    ck.bits.clear();
+    switch (ck.type) {
+    case kind::bitmap:
+      ck.bits.assign(wp, wp + chunk_words);
+      break;
+    case kind::array:
+      ck.vals.reserve(ck.card);
+      for (auto wx = 0ul; wx < chunk_words; ++wx) {
+        for (auto wd = wp[wx]; wd != 0; wd &= wd - 1) {
+          ck.vals.push_back(static_cast<std::uint16_t>(wx * word_bits + std::countr_zero(wd)));
+        }
+      }
+      break;
+    case kind::run:
+      for (auto pos = 0ul; pos < chunk_bits;) {
+        auto wx = pos / word_bits;
+        auto wd = wp[wx] & (~word(0) << pos % word_bits);
+        while (wd == 0 && ++wx < chunk_words) {
+          wd = wp[wx];
+        }
+        if (wd == 0) {
+          break;
+        }
+        auto const first = wx * word_bits + static_cast<size_type>(std::countr_zero(wd));
+        wd = ~wp[wx] & (~word(0) << first % word_bits);
+        while (wd == 0 && ++wx < chunk_words) {
+          wd = ~wp[wx];
+        }
+        pos = wd == 0 ? chunk_bits : wx * word_bits + static_cast<size_type>(std::countr_zero(wd));
+        ck.vals.push_back(static_cast<std::uint16_t>(first));
+        ck.vals.push_back(static_cast<std::uint16_t>(pos - first - 1));
+      }
+      break;
+    }
+    ck.vals.shrink_to_fit();
+    ck.bits.shrink_to_fit();
+    return true;
+  }
+
+  static void optimize(chunk & ck) {
+    if (best(ck.card, runs_in(ck)) != ck.type) {
+      std::array<word, chunk_words> buf {};
+      paint(ck, buf.data());
+      load(ck, buf.data());
+    }
+    ck.vals.shrink_to_fit();
+  }
+
+  static void to_bitmap(chunk & ck) {
+    std::vector<word> bits(chunk_words, 0);
+    paint(ck, bits.data());
+    std::vector<std::uint16_t>().swap(ck.vals);
+    ck.bits.swap(bits);
+    ck.type = kind::bitmap;
+  }
+
+  static void to_array(chunk & ck) {
+    std::array<word, chunk_words> buf {};
+    paint(ck, buf.data());
+    std::vector<std::uint16_t> vals;
+    vals.reserve(ck.card);
+    for (auto wx = 0ul; wx < chunk_words; ++wx) {
+      for (auto wd = buf[wx]; wd != 0; wd &= wd - 1) {
+        vals.push_back(static_cast<std::uint16_t>(wx * word_bits + std::countr_zero(wd)));
+      }
+    }
+    ck.vals.swap(vals);
+    std::vector<word>().swap(ck.bits);
+    ck.type = kind::array;
+  }
+
+  //  leave the run kind when the pairs outgrow a bitmap, or the bitmap kind
+  //  when it falls to array_max ones.
+  static void demote(chunk & ck) {
+    if (ck.card <= array_max) {
+      to_array(ck);
+    }
+    else {
+      to_bitmap(ck);
+    }
+  }
+
+  static void add(chunk & ck, std::uint16_t val) {
+    switch (ck.type) {
+    case kind::array: {
+      auto const it = std::lower_bound(ck.vals.begin(), ck.vals.end(), val);
+      if (it != ck.vals.end() && *it == val) {
+        return;
+      }
+      if (ck.card < array_max) {
+        ck.vals.insert(it, val);
+        ++ck.card;
+        return;
+      }
+      to_bitmap(ck);
+      break;
+    }
+    case kind::bitmap:
+      break;
+    case kind::run: {
+      auto & vs = ck.vals;
+      auto const rx = run_at(vs, val);
+      auto const after = rx == npos ? 0 : rx + 2;
+      if (rx != npos && val <= std::uint32_t(vs[rx]) + vs[rx + 1]) {
+        return;
+      }
+      auto const joins_prev = rx != npos && val == std::uint32_t(vs[rx]) + vs[rx + 1] + 1;
+      auto const joins_next = after < vs.size() && val + 1u == vs[after];
+      if (joins_prev && joins_next) {
+        vs[rx + 1] = static_cast<std::uint16_t>(vs[rx + 1] + vs[after + 1] + 2);
+        vs.erase(vs.begin() + static_cast<std::ptrdiff_t>(after),
+                 vs.begin() + static_cast<std::ptrdiff_t>(after + 2));
+      }
+      else if (joins_prev) {
+        ++vs[rx + 1];
+      }
+      else if (joins_next) {
+        --vs[after];
+        ++vs[after + 1];
+      }
+      else {
+        std::uint16_t const pair[2] = { val, 0, };
+        vs.insert(vs.begin() + static_cast<std::ptrdiff_t>(after), pair, pair + 2);
+      }
+      ++ck.card;
+      if (vs.size() * 2 > chunk_words * 8) {
+        demote(ck);
+      }
+      return;
+    }
+    }
+    auto & wd = ck.bits[val / word_bits];
+    auto const mask = word(1) << val % word_bits;
+    if ((wd & mask) == 0) {
+      wd |= mask;
+      ++ck.card;
+    }
+  }
+
+  //  true when val was a one.
+  static bool remove(chunk & ck, std::uint16_t val) {
+    switch (ck.type) {
+    case kind::array: {
+      auto const it = std::lower_bound(ck.vals.begin(), ck.vals.end(), val);
+      if (it == ck.vals.end() || *it != val) {
+        return false;
+      }
+      ck.vals.erase(it);
+      --ck.card;
+      return true;
+    }
+    case kind::bitmap: {
+      auto & wd = ck.bits[val / word_bits];
+      auto const mask = word(1) << val % word_bits;
+      if ((wd & mask) == 0) {
+        return false;
+      }
+      wd &= ~mask;
+      if (--ck.card <= array_max) {
+        demote(ck);
+      }
+      return true;
+    }
+    case kind::run: {
+      auto & vs = ck.vals;
+      auto const rx = run_at(vs, val);
+      if (rx == npos || val > std::uint32_t(vs[rx]) + vs[rx + 1]) {
+        return false;
+      }
+      auto const last = static_cast<std::uint16_t>(vs[rx] + vs[rx + 1]);
+      if (vs[rx + 1] == 0) {
+        vs.erase(vs.begin() + static_cast<std::ptrdiff_t>(rx),
+                 vs.begin() + static_cast<std::ptrdiff_t>(rx + 2));
+      }
+      else if (val == vs[rx]) {
+        ++vs[rx];
+        --vs[rx + 1];
+      }
+      else if (val == last) {
+        --vs[rx + 1];
+      }
+      else {
+        vs[rx + 1] = static_cast<std::uint16_t>(val - vs[rx] - 1);
+        std::uint16_t const pair[2] = {
+          static_cast<std::uint16_t>(val + 1), static_cast<std::uint16_t>(last - val - 1),
+        };
+        vs.insert(vs.begin() + static_cast<std::ptrdiff_t>(rx + 2), pair, pair + 2);
+        if (vs.size() * 2 > chunk_words * 8) {
+          --ck.card;
+          demote(ck);
+          return true;
+        }
+      }
+      --ck.card;
+      return true;
+    }
+    }
+    return false;
+  }
+
+  //  set [first, last), past every one already stored (used by resize).
+  void fill(size_type first, size_type last) {
+    while (first < last) {
+      auto const key = first >> 16;
+      auto const stop = std::min(last, (key + 1) << 16);
+      if (chunks_.empty() || chunks_.back().key != key) {
+        chunk ck;
+        ck.key = static_cast<std::uint16_t>(key);
+        ck.type = kind::run;
+        chunks_.push_back(std::move(ck));
+      }
+      auto & ck = chunks_.back();
+      std::array<word, chunk_words> buf {};
+      paint(ck, buf.data());
+      paint_range(buf.data(), low(first), stop - (key << 16));
+      load(ck, buf.data());
+      first = stop;
+    }
+  }
+
+  template <kernel::bitop Op>
+  static roaring combine(roaring const & lhs, roaring const & rhs) {
+    using kernel::bitop;
+    roaring out;
+    out.size_ = std::max(lhs.size_, rhs.size_);
+    auto const & lcs = lhs.chunks_;
+    auto const & rcs = rhs.chunks_;
+    std::array<word, chunk_words> lbuf, rbuf;
+    auto lx = 0ul, rx = 0ul;
+    while (lx < lcs.size() || rx < rcs.size()) {
+      auto const lkey = lx < lcs.size() ? lcs[lx].key : chunk_bits;
+      auto const rkey = rx < rcs.size() ? rcs[rx].key : chunk_bits;
+      if (lkey != rkey) {
+        //  a chunk on one side only: kept by or/xor, and by andnot from lhs.
+        auto const & ck = lkey < rkey ? lcs[lx++] : rcs[rx++];
+        if (Op == bitop::or_ || Op == bitop::xor_ || (Op == bitop::andnot && lkey < rkey)) {
+          out.chunks_.push_back(ck);
+        }
+        continue;
+      }
+      auto const & lc = lcs[lx++];
+      auto const & rc = rcs[rx++];
+      chunk ck;
+      ck.key = lc.key;
+      if (lc.type == kind::array && rc.type == kind::array) {
+        auto const dst = std::back_inserter(ck.vals);
+        auto const lb = lc.vals.begin(), le = lc.vals.end();
+        auto const rb = rc.vals.begin(), re = rc.vals.end();
+        if constexpr (Op == bitop::and_) { std::set_intersection(lb, le, rb, re, dst); }
+        if constexpr (Op == bitop::or_) { std::set_union(lb, le, rb, re, dst); }
+        if constexpr (Op == bitop::xor_) { std::set_symmetric_difference(lb, le, rb, re, dst); }
+        if constexpr (Op == bitop::andnot) { std::set_difference(lb, le, rb, re, dst); }
+        ck.card = static_cast<std::uint32_t>(ck.vals.size());
+        if (ck.card != 0) {
+          optimize(ck);
+          out.chunks_.push_back(std::move(ck));
+        }
+        continue;
+      }
+      //  an array against anything else: probe the other side.
+      if ((Op == bitop::and_ && (lc.type == kind::array || rc.type == kind::array))
+       || (Op == bitop::andnot && lc.type == kind::array)) {
+        auto const & probe = lc.type == kind::array ? lc : rc;
+        auto const & other = lc.type == kind::array ? rc : lc;
+        for (auto const val : probe.vals) {
+          if (contains(other, val) == (Op == bitop::and_)) {
+            ck.vals.push_back(val);
+          }
+        }
+        ck.card = static_cast<std::uint32_t>(ck.vals.size());
+        if (ck.card != 0) {
+          optimize(ck);
+          out.chunks_.push_back(std::move(ck));
+        }
+        continue;
+      }
+      lbuf.fill(0);
+      paint(lc, lbuf.data());
+      auto src = rc.bits.data();
+      if (rc.type != kind::bitmap) {
+        rbuf.fill(0);
+        paint(rc, rbuf.data());
+        src = rbuf.data();
+      }
+      kernel::binary<Op>(lbuf.data(), src, chunk_words);
+      if (load(ck, lbuf.data())) {
+        out.chunks_.push_back(std::move(ck));
+      }
+    }
+    return out;
+  }
+
+  std::vector<chunk> chunks_;
+  size_type size_ { 0 };
+  mutable word hash_ { 0 };
+  mutable bool hashed_ { false };
+};
+
+} /* namespace vecbit */
+
+template <class Alloc>
+struct std::hash<vecbit::bit_vector<Alloc>> {
+  std::size_t operator()(vecbit::bit_vector<Alloc> const & bv) const noexcept {
+    return bv.hash();
+  }
+};
+
+template <>
+struct std::hash<vecbit::roaring> {
+  std::size_t operator()(vecbit::roaring const & rb) const noexcept {
+    return rb.hash();
+  }
+};
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace vecflat
+/*
+ *  flat_set: an open-addressing hash set in the SwissTable style.
+ *
+ *  Slots are split into aligned groups of 16.  Each slot has a control
+ *  byte: empty, deleted, or the low 7 bits of its hash (h2).  A lookup
+ *  starts at the group picked by the high hash bits (h1), compares all 16
+ *  control bytes against h2 at once (SSE2, or a portable loop), checks the
+ *  candidates, and stops at the first group that still has an empty slot.
+ *  Keys are stored inline in one array, so lookups touch no nodes.  The
+ *  table grows at 7/8 load; erased slots become tombstones unless their
+ *  group still has an empty slot.
+ *
+ *  Heterogeneous find/contains/count are enabled when both Hash and
+ *  KeyEqual define is_transparent.
+ */
+namespace vecflat {
+
+namespace group {
+
+using ctrl_t = std::int8_t;
+static constexpr std::size_t width = 16;
+static constexpr ctrl_t empty = -128;
+static constexpr ctrl_t deleted = -2;
+
+//  one bit per slot of the group.
+inline std::uint32_t match(ctrl_t const * grp, ctrl_t h2) noexcept {
+#if defined(__SSE2__)
+  auto const ctl = _mm_loadu_si128(reinterpret_cast<__m128i const *>(grp));
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctl, _mm_set1_epi8(h2))));
+#else
+  auto bits = std::uint32_t { 0 };
+  for (auto ix = 0ul; ix < width; ++ix) {
+    bits |= static_cast<std::uint32_t>(grp[ix] == h2) << ix;
+  }
+  return bits;
+#endif  /* defined(__SSE2__) */
+}
+
+inline std::uint32_t match_empty(ctrl_t const * grp) noexcept {
+  return match(grp, empty);
+}
+
+//  empty and deleted are the only negative control bytes.
+inline std::uint32_t match_free(ctrl_t const * grp) noexcept {
+#if defined(__SSE2__)
+  auto const ctl = _mm_loadu_si128(reinterpret_cast<__m128i const *>(grp));
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(ctl));
+#else
+  auto bits = std::uint32_t { 0 };
+  for (auto ix = 0ul; ix < width; ++ix) {
+    bits |= static_cast<std::uint32_t>(grp[ix] < 0) << ix;
+  }
+  return bits;
+#endif  /* defined(__SSE2__) */
+}
+
+} /* namespace group */
+
+template <class Key,
+          class Hash = std::hash<Key>,
+          class KeyEqual = std::equal_to<Key>,
+          class Alloc = std::allocator<Key>>
+class flat_set {
+  using ctrl_t = group::ctrl_t;
+  using traits = std::allocator_traits<Alloc>;
+  using ctrl_alloc = typename traits::template rebind_alloc<ctrl_t>;
+  using ctrl_traits = std::allocator_traits<ctrl_alloc>;
+
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  template <class K>
+  static constexpr bool transparent =
+    requires { typename Hash::is_transparent; typename KeyEqual::is_transparent; };
+
+public:
+  using key_type = Key;
+  using value_type = Key;
+  using size_type = std::size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Alloc;
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Key;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Key const *;
+    using reference = Key const &;
+
+    const_iterator() noexcept = default;
+
+    reference operator*() const noexcept { return set_->slots_[ix_]; }
+    pointer operator->() const noexcept { return set_->slots_ + ix_; }
+
+    const_iterator & operator++() noexcept {
+      ix_ = set_->next_full(ix_ + 1);
+      return *this;
+    }
+
+    const_iterator operator++(int) noexcept {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
 
-    auto display = [](std::string comment, std::vector<int> const & vec) {
-      std::cout << comment << "{ "s;
-      for (int el : vec) {
-        std::cout << el << ' ';
-      }
-      std::cout << "}\n"s;
-    };
+    friend bool operator==(const_iterator const & lhs, const_iterator const & rhs) noexcept {
+      return lhs.ix_ == rhs.ix_;
+    }
 
-    std::vector<int> nums1 { 3, 1, 4, 6, 5, 9, };
-    std::vector<int> nums2;
-    std::vector<int> nums3;
+  private:
+    friend class flat_set;
+    const_iterator(flat_set const * set, size_type ix) noexcept : set_(set), ix_(ix) {}
 
-    display_sizes("Initially:\n"s, nums1, nums2, nums3);
-//    display_sizes(co, nums1, nums2, nums3);
+    flat_set const * set_ { nullptr };
+    size_type ix_ { 0 };
+  };
 
-    // copy assignment copies data from nums1 to nums2
-    nums2 = nums1;
+  using iterator = const_iterator;
 
-    display_sizes("After assignment:\n"s, nums1, nums2, nums3);
+  flat_set() = default;
+  explicit flat_set(Alloc const & al) : al_(al) {}
 
-    // move assignment moves data from nums1 to nums3,
-    // modifying both nums1 and nums3
-    nums3 = std::move(nums1);
+  flat_set(std::initializer_list<Key> il, Alloc const & al = Alloc()) : al_(al) {
+    reserve(il.size());
+    for (auto const & key : il) {
+      insert(key);
+    }
+  }
 
-    display_sizes("After move assignment:\n"s, nums1, nums2, nums3);
+  flat_set(flat_set const & other)
+    : hash_(other.hash_), eq_(other.eq_),
+      al_(traits::select_on_container_copy_construction(other.al_)) {
+    reserve(other.size_);
+    for (auto const & key : other) {
+      insert(key);
+    }
+  }
 
-    display("Now nums3 = "s, nums3);
+  flat_set(flat_set && other) noexcept
+    : hash_(std::move(other.hash_)), eq_(std::move(other.eq_)), al_(other.al_),
+      ctrl_(std::exchange(other.ctrl_, nullptr)),
+      slots_(std::exchange(other.slots_, nullptr)),
+      cap_(std::exchange(other.cap_, 0)),
+      size_(std::exchange(other.size_, 0)),
+      growth_left_(std::exchange(other.growth_left_, 0)) {}
+
+  flat_set & operator=(flat_set other) noexcept {
+    swap(other);
+    return *this;
+  }
 
-    // copy assignment of an initializer_list copies data to nums3
-    nums3 = { 1, 2, 3, };
+  ~flat_set() {
+    destroy_all();
+    release(ctrl_, slots_, cap_);
+  }
 
-    display("After assignment of initializer_list \n nums3 = "s, nums3);
-    std::cout << '\n';
+  allocator_type get_allocator() const { return al_; }
+
+  /// Iterators
+  const_iterator begin() const noexcept { return { this, next_full(0), }; }
+  const_iterator end() const noexcept { return { this, cap_, }; }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+  /// Capacity
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  size_type capacity() const noexcept { return cap_; }
+  double load_factor() const noexcept { return cap_ == 0 ? 0.0 : double(size_) / cap_; }
+
+  void reserve(size_type count) {
+    auto want = group::width;
+    while (want * 7 / 8 < count) {
+      want *= 2;
+    }
+    if (want > cap_) {
+      rehash(want);
+    }
   }
-  std::cout << std::endl; //  make sure cout is flushed.
+
+  /// Modifiers
+  void clear() noexcept {
+    destroy_all();
+    if (cap_ != 0) {
+      std::fill(ctrl_, ctrl_ + cap_, group::empty);
+    }
+    size_ = 0;
+    growth_left_ = cap_ * 7 / 8;
+  }
+
+  std::pair<iterator, bool> insert(Key const & key) { return emplace(key); }
+  std::pair<iterator, bool> insert(Key && key) { return emplace(std::move(key)); }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args &&... args) {
+    Key key(std::forward<Args>(args)...);
+    auto const hv = mix(hash_(key));
+    if (auto const ix = find_index(key, hv); ix != npos) {
+      return { { this, ix, }, false, };
+    }
+    if (growth_left_ == 0) {
+      //  clear tombstones in place if that frees enough room, else grow.
+      rehash(cap_ == 0 ? group::width : size_ < cap_ * 7 / 16 ? cap_ : 2 * cap_);
+    }
+    auto const ix = free_index(hv);
+    growth_left_ -= ctrl_[ix] == group::empty;
+    ctrl_[ix] = h2(hv);
+    traits::construct(al_, slots_ + ix, std::move(key));
+    ++size_;
+    return { { this, ix, }, true, };
+  }
+
+  size_type erase(Key const & key) {
+    auto const ix = find_index(key, mix(hash_(key)));
+    if (ix == npos) {
+      return 0;
+    }
+    erase_index(ix);
+    return 1;
+  }
+
+  iterator erase(const_iterator pos) {
+    erase_index(pos.ix_);
+    return { this, next_full(pos.ix_ + 1), };
+  }
+
+  void swap(flat_set & other) noexcept {
+    using std::swap;
+    swap(hash_, other.hash_);
+    swap(eq_, other.eq_);
+    swap(al_, other.al_);
+    swap(ctrl_, other.ctrl_);
+    swap(slots_, other.slots_);
+    swap(cap_, other.cap_);
+    swap(size_, other.size_);
+    swap(growth_left_, other.growth_left_);
+  }
+
+  /// Lookup
+  const_iterator find(Key const & key) const {
+    auto const ix = find_index(key, mix(hash_(key)));
+    return { this, ix == npos ? cap_ : ix, };
+  }
+
+  template <class K>
+    requires transparent<K>
+  const_iterator find(K const & key) const {
+    auto const ix = find_index(key, mix(hash_(key)));
+    return { this, ix == npos ? cap_ : ix, };
+  }
+
+  bool contains(Key const & key) const { return find(key) != end(); }
+
+  template <class K>
+    requires transparent<K>
+  bool contains(K const & key) const { return find(key) != end(); }
+
+  size_type count(Key const & key) const { return contains(key) ? 1 : 0; }
+
+  template <class K>
+    requires transparent<K>
+  size_type count(K const & key) const { return contains(key) ? 1 : 0; }
+
+private:
+  //  std::hash is the identity for integers; spread it before splitting.
+  static std::size_t mix(std::size_t hv) noexcept {
+    auto const rs = static_cast<unsigned __int128>(hv) * 0x9e3779b97f4a7c15ull;
+    return static_cast<std::size_t>(rs) ^ static_cast<std::size_t>(rs >> 64);
+  }
+
+  static ctrl_t h2(std::size_t hv) noexcept {
+    return static_cast<ctrl_t>(hv & 0x7f);
+  }
+
+  size_type groups() const noexcept { return cap_ / group::width; }
+
+  size_type first_group(std::size_t hv) const noexcept {
+    return (hv >> 7) & (groups() - 1);
+  }
+
+  //  triangular probing visits every group when the count is a power of two.
+  template <class K>
+  size_type find_index(K const & key, std::size_t hv) const {
+    if (cap_ == 0) {
+      return npos;
+    }
+    auto gx = first_group(hv);
+    for (auto probe = 1ul; ; ++probe) {
+      auto const grp = ctrl_ + gx * group::width;
+      for (auto mk = group::match(grp, h2(hv)); mk != 0; mk &= mk - 1) {
+        auto const ix = gx * group::width + static_cast<size_type>(std::countr_zero(mk));
+        if (eq_(slots_[ix], key)) {
+          return ix;
+        }
+      }
+      if (group::match_empty(grp) != 0 || probe > groups()) {
+        return npos;
+      }
+      gx = (gx + probe) & (groups() - 1);
+    }
+  }
+
+  size_type free_index(std::size_t hv) const noexcept {
+    auto gx = first_group(hv);
+    for (auto probe = 1ul; ; ++probe) {
+      auto const mk = group::match_free(ctrl_ + gx * group::width);
+      if (mk != 0) {
+        return gx * group::width + static_cast<size_type>(std::countr_zero(mk));
+      }
+      gx = (gx + probe) & (groups() - 1);
+    }
+  }
+
+  size_type next_full(size_type ix) const noexcept {
+    for (; ix < cap_ && ctrl_[ix] < 0; ++ix) {}
+    return ix;
+  }
+
+  void erase_index(size_type ix) {
+    traits::destroy(al_, slots_ + ix);
+    --size_;
+    //  a group with an empty slot ends every probe that reaches it, so
+    //  the freed slot can be empty rather than a tombstone.
+    auto const grp = ctrl_ + ix / group::width * group::width;
+    if (group::match_empty(grp) != 0) {
+      ctrl_[ix] = group::empty;
+      ++growth_left_;
+    }
+    else {
+      ctrl_[ix] = group::deleted;
+    }
+  }
+
+  void destroy_all() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<Key>) {
+      for (auto ix = next_full(0); ix < cap_; ix = next_full(ix + 1)) {
+        traits::destroy(al_, slots_ + ix);
+      }
+    }
+  }
+
+  void release(ctrl_t * ctrl, Key * slots, size_type cap) noexcept {
+    if (cap != 0) {
+      ctrl_alloc cal(al_);
+      ctrl_traits::deallocate(cal, ctrl, cap);
+      traits::deallocate(al_, slots, cap);
+    }
+  }
+
+  void rehash(size_type cap) {
+    ctrl_alloc cal(al_);
+    auto const ctrl = ctrl_traits::allocate(cal, cap);
+    Key * slots = nullptr;
+    try {
+      slots = traits::allocate(al_, cap);
+    }
+    catch (...) {
+      ctrl_traits::deallocate(cal, ctrl, cap);
+      throw;
+    }
+    std::fill(ctrl, ctrl + cap, group::empty);
+
+    auto const old_ctrl = std::exchange(ctrl_, ctrl);
+    auto const old_slots = std::exchange(slots_, slots);
+    auto const old_cap = std::exchange(cap_, cap);
+    for (auto ix = 0ul; ix < old_cap; ++ix) {
+      if (old_ctrl[ix] >= 0) {
+        auto const hv = mix(hash_(old_slots[ix]));
+        auto const nx = free_index(hv);
+        ctrl_[nx] = h2(hv);
+        traits::construct(al_, slots_ + nx, std::move(old_slots[ix]));
+        traits::destroy(al_, old_slots + ix);
+      }
+    }
+    growth_left_ = cap_ * 7 / 8 - size_;
+    release(old_ctrl, old_slots, old_cap);
+  }
+
+  [[no_unique_address]] Hash hash_ {};
+  [[no_unique_address]] KeyEqual eq_ {};
+  [[no_unique_address]] Alloc al_ {};
+  ctrl_t * ctrl_ { nullptr };
+  Key * slots_ { nullptr };
+  size_type cap_ { 0 };
+  size_type size_ { 0 };
+  size_type growth_left_ { 0 };
+};
+
+} /* namespace vecflat */
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+/*
+ *  MARK: C_vector_bool()
+ *  std::vector<bool> is a possibly space-efficient specialization of
+ *  std::vector for the type bool.
+ *
+ *  The manner in which std::vector<bool> is made space efficient (as well as whether
+ *  it is optimized at all) is implementation defined. One potential optimization
+ *  involves coalescing vector elements such that each element occupies a single bit
+ *  instead of sizeof(bool) bytes.
+ *
+ *  std::vector<bool> behaves similarly to std::vector, but in order to be space
+ *  efficient, it:
+ *
+ *  + Does not necessarily store its elements as a contiguous array.
+ *
+ *  + Exposes class std::vector<bool>::reference as a method of accessing individual
+ *    bits. In particular, objects of this class are returned by operator[] by value.
+ *
+ *  + Does not use std::allocator_traits::construct to construct bit values.
+ *
+ *  + Does not guarantee that different elements in the same container can be modified
+ *    concurrently by different threads.
+ */
+int C_vector_bool(int argc, const char * argv[]) {
+  std::cout << "In "s << __func__ << std::endl;
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - assign"s << '\n';
+  std::cout << "std::vector<bool> - constructor, custom allocator"s << '\n';
   {
-    std::vector<char> characters;
+    perf::section const sect("std::vector<bool> - constructor, custom allocator"s);
+    auto constexpr cc_max(10ul);
+    auto cc(0UL);
+    auto prtboolean = [&cc](auto bl) {
+      std::cout << std::boolalpha << std::setw(6) << bl << std::noboolalpha
+                << (++cc % cc_max == 0 ? "\n"s : ""s);
+    };
 
-    auto print_vector = [&](){
-      for (char ch : characters) {
-        std::cout << ch << ' ';
-      }
+    std::vector<bool, valc::Mallocator<bool>> vbl;
+    std::cout << "initial size: "s << std::setw(4) << vbl.size()
+              << ", capacity: "s << std::setw(6) << vbl.capacity()
+              << '\n';
+
+    if (!vbl.empty()) {
+      cc = 0ul;
+      std::for_each(vbl.cbegin(), vbl.cend(), prtboolean);
       std::cout << '\n';
-    };
+    }
+    std::cout << "add a value.\n"s;
+    vbl.push_back(true);
+    std::cout << "add a value.\n"s;
+    vbl.push_back(false);
 
-    characters.assign(5, 'a');
-    print_vector();
+    bool samples[] = {
+      true, false, false, false, true,  true, false,  true, true, true,
+      true,  true, false, true, false, false, false, false, true, true, };
+    std::cout << "adding:\n"s;
+    for (auto nr : samples) {
+      std::cout << ' ' << std::boolalpha << nr;
+      vbl.push_back(nr);
+    }
+    std::cout << std::noboolalpha << '\n';
 
-    const std::string extra(6, 'b');
-    characters.assign(extra.begin(), extra.end());
-    print_vector();
+    std::cout << "add a value.\n"s;
+    vbl.push_back(true);
+    std::cout << "add a value.\n"s;
+    vbl.push_back(false);
+    auto constexpr rn(100ul);
+    std::cout << "reserve "s << rn << " more.\n"s;
+    vbl.reserve(rn);
 
-    characters.assign({ 'C', '+', '+', '1', '1', });
-    print_vector();
+//      std::cout << vbl.data() << '\n';
+    std::cout << "new size: "s << std::setw(4) << vbl.size()
+              << ", capacity: "s << std::setw(6) << vbl.capacity()
+              << '\n';
+    cc = 0ul;
+    if (!vbl.empty()) {
+      std::for_each(vbl.cbegin(), vbl.cend(), prtboolean);
+    }
     std::cout << '\n';
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - get_allocator"s << '\n';
+  std::cout << "std::vector<bool> - arena allocator"s << '\n';
   {
-    std::vector<long> vb1(8);
-    std::vector<long, valc::Mallocator<long>> vb2(8);
-    std::vector<long, valc::Mallocator<long>> vb3(8);
+    perf::section const sect("std::vector<bool> - arena allocator"s);
+    valc::arena::scope sc;
+    std::vector<bool, valc::ArenaAllocator<bool>> vbl;
+    for (auto nr = 0; nr < 200; ++nr) {
+      vbl.push_back(nr % 3 == 0);
+    }
+    std::cout << "size: "s << std::setw(4) << vbl.size()
+              << ", capacity: "s << std::setw(6) << vbl.capacity()
+              << ", set: "s << std::count(vbl.cbegin(), vbl.cend(), true)
+              << '\n';
+    valc::arena::local().report();
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector<bool> - get_allocator"s << '\n';
+  {
+    perf::section const sect("std::vector<bool> - get_allocator"s);
+    std::vector<bool> vb1(8);
+    std::vector<bool, valc::Mallocator<bool>> vb2(8);
+    std::vector<bool, valc::Mallocator<bool>> vb3(8);
     std::vector<uint8_t, valc::Mallocator<uint8_t>> vb4(8);
 
     [[maybe_unused]]
@@ -439,929 +10422,2558 @@ int C_vector(int argc, const char * argv[]) {
     std::cout << "vb2_al == vb4_al: "s << vb2_al_eq_vb4_al  << '\n';
     std::cout << "vb2_al != vb4_al: "s << vb2_al_neq_vb4_al << '\n';
     std::cout << std::noboolalpha;
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector<bool> - flip"s << '\n';
+  {
+    perf::section const sect("std::vector<bool> - flip"s);
+    auto print = [](const std::vector<bool> & vb) {
+      for (bool const b_ : vb) {
+          std::cout << b_;
+      }
+      std::cout << '\n';
+    };
+
+    std::cout << std::noboolalpha;
+    std::vector<bool> vbool { 0, 1, 0, 1, };
+    print(vbool);
+    vbool.flip();
+    print(vbool);
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "std::vector<bool> - swap"s << '\n';
+  {
+    perf::section const sect("std::vector<bool> - swap"s);
+    auto pv = [](auto el) {
+      std::cout << std::setw(3) << el;
+    };
+    std::vector<bool> vb1{ 1, 0, };
+
+    std::cout << std::noboolalpha;
+    std::for_each(vb1.cbegin(), vb1.cend(), pv);
+    std::cout << '\n';
+
+    vb1.swap(vb1[0], vb1[1]);
+    std::for_each(vb1.cbegin(), vb1.cend(), pv);
+    std::cout << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "vecbit::bit_vector - flip, swap, word kernels"s << '\n';
+  {
+    perf::section const sect("vecbit::bit_vector - flip, swap, word kernels"s);
+    using bits = vecbit::bit_vector<>;
+    auto print = [](bits const & vb) {
+      for (bool const b_ : vb) {
+          std::cout << b_;
+      }
+      std::cout << '\n';
+    };
+
+    std::cout << "kernels: "s << vecbit::kernel::name() << '\n';
+    std::cout << std::noboolalpha;
+    bits vbool { 0, 1, 0, 1, };
+    print(vbool);
+    vbool.flip();
+    print(vbool);
+    bits::swap(vbool[0], vbool[1]);
+    print(vbool);
+
+    bits lhs(100), rhs(100);
+    lhs.fill(10, 70);
+    rhs.fill(40, 100);
+    std::cout << "lhs count: "s << lhs.count()
+              << ", rhs count: "s << rhs.count()
+              << ", and: "s << (lhs & rhs).count()
+              << ", or: "s << (lhs | rhs).count()
+              << ", xor: "s << (lhs ^ rhs).count()
+              << ", not lhs: "s << (~lhs).count() << '\n';
+
+    bits vbl(130);
+    for (auto pos : { 3ul, 64ul, 65ul, 127ul, 129ul, }) {
+      vbl.set(pos);
+    }
+    std::cout << "set bits:"s;
+    for (auto pos = vbl.find_first(); pos != bits::npos; pos = vbl.find_next(pos)) {
+      std::cout << ' ' << pos;
+    }
     std::cout << '\n';
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
-  /// Element access
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - at"s << '\n';
+  std::cout << "vecbit::atomic_bitset - concurrent set, test_and_set, count"s << '\n';
   {
-    std::vector<int> data = { 1, 2, 4, 5, 5, 6, };
-
-    // Set element 1
-    data.at(1) = 88;
-
-    // Read element 2
-    std::cout << "Element at index 2 has value "s << data.at(2) << '\n';
-
-    std::cout << "data size = "s << data.size() << '\n';
-
-    try {
-      // Set element 6
-      data.at(6) = 666;
+    perf::section const sect("vecbit::atomic_bitset - concurrent set, test_and_set, count"s);
+    //  four threads strike out the multiples of 2, 3, 5 and 7 below 100 in
+    //  the same words; test_and_set tells each composite's first striker.
+    auto constexpr nb(100ul);
+    vecbit::atomic_bitset composite(nb);
+    composite.set(0, 2);
+    std::array<std::size_t, 4> first {};
+    std::vector<std::thread> workers;
+    for (auto tx = 0ul; tx < first.size(); ++tx) {
+      workers.emplace_back([&composite, &first, tx]() {
+        auto const prime = std::array { 2ul, 3ul, 5ul, 7ul, }[tx];
+        for (auto pos = prime * prime; pos < nb; pos += prime) {
+          first[tx] += !composite.test_and_set(pos);
+        }
+      });
     }
-    catch (std::out_of_range const & exc) {
-      std::cout << exc.what() << '\n';
+    for (auto & th : workers) {
+      th.join();
     }
 
-    // Print final values
-    std::cout << "data:"s;
-    std::for_each(data.cbegin(), data.cend(), [](auto elem) {
-      std::cout << ' ' << elem;
-    });
+    std::cout << "struck first by 2, 3, 5, 7:"s;
+    for (auto ct : first) {
+      std::cout << ' ' << ct;
+    }
+    std::cout << ", total: "s << std::accumulate(first.begin(), first.end(), 0ul)
+              << ", count(): "s << composite.count() - 2 << '\n';
+
+    auto const primes = ~composite.snapshot();
+    std::cout << primes.count() << " primes:"s;
+    for (auto pos = primes.find_first(); pos != vecbit::bit_vector<>::npos;
+         pos = primes.find_next(pos)) {
+      std::cout << ' ' << pos;
+    }
     std::cout << '\n';
 
+    vecbit::atomic_bitset lines(2000);
+    std::cout << "partition of "s << lines.size() << " bits in 3 ("s
+              << vecbit::atomic_bitset::line_bits << "-bit lines):"s;
+    for (auto part = 0ul; part < 3; ++part) {
+      auto const [lo, hi] = lines.partition(part, 3);
+      std::cout << " ["s << lo << ", "s << hi << ')';
+    }
     std::cout << '\n';
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - operator[]"s << '\n';
+  std::cout << "vecbit::rank_select - rank, select, incremental updates"s << '\n';
   {
-    std::vector<int> numbers { 2, 4, 6, 8, };
+    perf::section const sect("vecbit::rank_select - rank, select, incremental updates"s);
+    auto show = [](vecbit::rank_select<> const & rs) {
+      for (auto pos = 0ul; pos < rs.size(); ++pos) {
+        std::cout << rs[pos];
+      }
+      std::cout << "  count: "s << rs.count() << ", rank1:"s;
+      for (auto pos = 0ul; pos <= rs.size(); pos += 4) {
+        std::cout << ' ' << rs.rank1(pos);
+      }
+      std::cout << ", select1:"s;
+      for (auto kth = 0ul; kth < rs.count(); ++kth) {
+        std::cout << ' ' << rs.select1(kth);
+      }
+      std::cout << ", select0(0): "s << rs.select0(0) << '\n';
+    };
 
-    std::cout << "Second element: "s << numbers[1] << '\n';
+    vecbit::rank_select<> rs(vecbit::bit_vector<> { 0, 1, 1, 0, 1, 0, 0, 1, 0, 0, 0, 1, });
+    show(rs);
+    for (auto bit : { 1, 1, 0, 1, }) {
+      rs.push_back(bit != 0);
+    }
+    std::cout << "push_back 1101:\n"s;
+    show(rs);
+    rs.flip(0);
+    rs.set(2, false);
+    std::cout << "flip(0), set(2, false):\n"s;
+    show(rs);
+    rs.flip();
+    std::cout << "flip():\n"s;
+    show(rs);
+
+    auto constexpr nb(1ul << 20);
+    vecbit::bit_vector<> bits(nb);
+    std::mt19937_64 rng(42);
+    for (auto pos = 0ul; pos < nb; ++pos) {
+      bits.set(pos, rng() % 3 == 0);
+    }
+    vecbit::rank_select<> big(std::move(bits));
+    big.build();
+    std::cout << nb << " random bits, "s << big.count() << " ones, index: "s
+              << big.index_bytes() << " bytes ("s << std::fixed << std::setprecision(2)
+              << 100.0 * big.index_bytes() / (nb / 8) << "%)"s << std::defaultfloat
+              << ", rank1(nb / 2): "s << big.rank1(nb / 2)
+              << ", select1(100000): "s << big.select1(100000) << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
 
-    numbers[0] = 5;
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "vecbit::roaring - compressed bitmap, containers, set operations"s << '\n';
+  {
+    perf::section const sect("vecbit::roaring - compressed bitmap, containers, set operations"s);
+    auto show = [](std::string const & name, vecbit::roaring const & rb) {
+      auto const us = rb.footprint();
+      std::cout << std::setw(8) << name << ": size "s << rb.size() << ", count "s << rb.count()
+                << ", containers (array/bitmap/run) "s << us.arrays << '/' << us.bitmaps
+                << '/' << us.runs << ", "s << us.bytes << " bytes, first ones:"s;
+      auto shown = 0;
+      for (auto it = rb.begin(); it != rb.end() && shown < 6; ++it, ++shown) {
+        std::cout << ' ' << *it;
+      }
+      std::cout << '\n';
+    };
 
-    std::cout << "All numbers:"s;
-    std::for_each(numbers.cbegin(), numbers.cend(), [](auto elem) {
-      std::cout << ' ' << elem;
-    });
-    std::cout << '\n';
+    //  three 2^16-bit chunks: sparse, dense random, one long run.
+    auto constexpr nb(3ul << 16);
+    vecbit::roaring rb;
+    std::vector<bool> vb;
+    std::mt19937_64 rng(42);
+    for (auto pos = 0ul; pos < nb; ++pos) {
+      auto const chunk = pos >> 16;
+      auto const bit = chunk == 0 ? pos % 1000 == 7
+                     : chunk == 1 ? rng() % 2 == 0
+                     : (pos & 0xffff) >= 100 && (pos & 0xffff) < 60000;
+      rb.push_back(bit);
+      vb.push_back(bit);
+    }
+    show("rb"s, rb);
+    std::cout << "    std::vector<bool>: "s << vb.capacity() / 8 << " bytes\n"s;
 
-    std::cout << '\n';
+    vecbit::roaring evens(nb);
+    for (auto pos = 0ul; pos < nb; pos += 2) {
+      evens.set(pos);
+    }
+    evens.optimize();
+    show("evens"s, evens);
+    show("rb & ev"s, rb & evens);
+    show("rb | ev"s, rb | evens);
+    show("rb ^ ev"s, rb ^ evens);
+    auto diff = rb;
+    diff.and_not(evens);
+    show("rb - ev"s, diff);
+    auto inv = rb;
+    inv.flip();
+    show("~rb"s, inv);
+    rb.flip(7).set(8).reset(1007);
+    std::cout << "flip(7), set(8), reset(1007): test(7) "s << rb.test(7) << ", test(8) "s
+              << rb.test(8) << ", find_next(8) "s << rb.find_next(8) << '\n';
+
+    auto const bytes = rb.serialize();
+    auto const back = vecbit::roaring::deserialize(bytes);
+    std::cout << "serialized: "s << bytes.size() << " bytes, round trip equal: "s
+              << std::boolalpha << (back == rb) << '\n';
+
+    //  the same bits hash alike as roaring and as bit_vector.
+    vecbit::bit_vector<> bv;
+    for (auto pos = 0ul; pos < rb.size(); ++pos) {
+      bv.push_back(rb.test(pos));
+    }
+    std::unordered_set<vecbit::roaring> seen { rb, back, evens, };
+    std::cout << "hash: roaring "s << std::hex << rb.hash() << ", bit_vector "s << bv.hash()
+              << std::dec << ", unordered_set of {rb, round trip, evens}: "s << seen.size()
+              << std::noboolalpha << '\n';
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - front, back"s << '\n';
+  std::cout << "std::vector<bool> - std::hash"s << '\n';
   {
-    {
-      std::vector<char> letters { 'o', 'm', 'g', 'w', 't', 'f', };
+    perf::section const sect("std::vector<bool> - std::hash"s);
+//    using vb = std::vector<bool>;
 
-      if (!letters.empty()) {
-        std::cout << "The first character is '"s << letters.front() << "'.\n"s;
-      }
-    }
-    std::cout << '\n';
+    auto to_vector_bool = [](unsigned nr) -> std::vector<bool> {
+      std::vector<bool> vec;
+      do {
+          vec.push_back(nr & 1);
+          nr >>= 1;
+      } while (nr);
 
-    {
-      std::vector<char> letters { 'a', 'b', 'c', 'd', 'e', 'f', };
+      return vec;
+    };
 
-      if (!letters.empty()) {
-        std::cout << "The last character is '"s << letters.back() << "'.\n"s;
+    auto print = [](const std::vector<bool> & vec, bool new_line = true) {
+      for (std::cout << "{ "s; bool const el : vec) {
+        std::cout << el << ' ';
       }
+      std::cout << '}' << (new_line ? '\n' : ' ');
+    };
+
+    for (auto i{0U}; i != 8; ++i) {
+      std::cout << std::hex << std::uppercase;
+      std::vector<bool> vec = to_vector_bool(i);
+      std::cout << std::hash<std::vector<bool>>{}(vec) << ' ' << std::dec;
+      print(vec);
     }
 
-    std::cout << '\n';
+    // std::hash for vector<bool> makes it possible to keep them in
+    // unordered_* associative containers, such as unordered_set.
+
+    std::unordered_set vec {
+      std::vector<bool> { 0 }, std::vector<bool> { 0, 0 }, std::vector<bool> { 1 },
+      std::vector<bool> { 1 }, std::vector<bool> { 1, 0 }, std::vector<bool> { 1, 1 } };
+
+    for (std::vector<bool> const & el : vec) {
+      print(el, 0);
+    }
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - data"s << '\n';
+  std::cout << "vecbit::bit_vector - std::hash"s << '\n';
   {
-    auto pointer_func = [](const int* p, std::size_t size) {
-      std::cout << "data = "s;
-      for (std::size_t i_ = 0; i_ < size; ++i_) {
-        std::cout << p[i_] << ' ';
-      }
-      std::cout << '\n';
+    perf::section const sect("vecbit::bit_vector - std::hash"s);
+    using bits = vecbit::bit_vector<>;
+
+    auto to_bit_vector = [](unsigned nr) -> bits {
+      bits vec;
+      do {
+          vec.push_back(nr & 1);
+          nr >>= 1;
+      } while (nr);
+
+      return vec;
     };
-     
-    auto span_func = [](std::span<const int> data) {  // since C++20
-      std::cout << "data = "s;
-      for (const int e_ : data) {
-        std::cout << e_ << ' ';
+
+    auto print = [](bits const & vec, bool new_line = true) {
+      for (std::cout << "{ "s; bool const el : vec) {
+        std::cout << el << ' ';
       }
-      std::cout << '\n';
+      std::cout << '}' << (new_line ? '\n' : ' ');
     };
 
-    std::vector<int> container { 1, 2, 3, 4, };
-
-    // Prefer container.data() over &container[0]
-    pointer_func(container.data(), container.size());
+    //  the hash is computed from the packed words and cached until the
+    //  vector next changes.
+    for (auto i{0U}; i != 8; ++i) {
+      std::cout << std::hex << std::uppercase;
+      bits vec = to_bit_vector(i);
+      std::cout << std::hash<bits>{}(vec) << ' ' << std::dec;
+      print(vec);
+    }
 
-    // std::span (C++20) is a safer alternative to separated pointer/size.
-    span_func({container.data(), container.size()});
+    std::unordered_set<bits> vec {
+      bits { 0 }, bits { 0, 0 }, bits { 1 }, bits { 1 }, bits { 1, 0 }, bits { 1, 1 } };
 
-    std::cout << '\n';
+    for (bits const & el : vec) {
+      print(el, 0);
+    }
+    std::cout << std::nouppercase << '\n';
+
+    //  a proxy taken before hash() still drops the cache when written.
+    bits lhs { 1, 0, 1, }, rhs { 1, 1, 1, };
+    auto proxy = rhs[1];
+    auto const stale = rhs.hash();
+    proxy = false;
+    std::cout << "write through a proxy after hash(): lhs == rhs "s << std::boolalpha
+              << (lhs == rhs) << ", hashes equal "s << (lhs.hash() == rhs.hash())
+              << ", hash changed "s << (rhs.hash() != stale) << std::noboolalpha << '\n';
+    assert(lhs == rhs && lhs.hash() == rhs.hash());
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
-  /// Iterators
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - begin, end, etc."s << '\n';
+  std::cout << "vecflat::flat_set - std::vector<bool>, bit_vector keys"s << '\n';
   {
-    std::cout << "std::vector - begin, end"s << '\n';
-    {
-      std::vector<int> nums { 1, 2, 4, 8, 16, };
-      std::vector<std::string> fruits { "orange"s, "apple"s, "raspberry"s, };
-      std::vector<char> empty;
-
-      // Print vector.
-      std::for_each(nums.begin(), nums.end(), [](const int n_) {
-        std::cout << n_ << ' ';
-      });
-      std::cout << '\n';
-
-      // Sums all integers in the vector nums (if any), printing only the result.
-      std::cout << "Sum of nums: "s
-                << std::accumulate(nums.begin(), nums.end(), 0) << '\n';
-
-      // Prints the first fruit in the vector fruits, checking if there is any.
-      if (!fruits.empty()) {
-        std::cout << "First fruit: "s << *fruits.begin() << '\n';
+    perf::section const sect("vecflat::flat_set - std::vector<bool>, bit_vector keys"s);
+    auto print = [](auto const & vec) {
+      for (std::cout << "{ "s; bool const el : vec) {
+        std::cout << el << ' ';
       }
+      std::cout << "} "s;
+    };
 
-      if (empty.begin() == empty.end()) {
-        std::cout << "vector 'empty' is indeed empty.\n"s;
+    //  the unordered_set from the std::hash section, flat, with its
+    //  control bytes and slots allocated through valc::Mallocator.
+    {
+      valc::trace::mode_scope const quiet(valc::trace::mode::off);
+      vecflat::flat_set<std::vector<bool>,
+                        std::hash<std::vector<bool>>,
+                        std::equal_to<std::vector<bool>>,
+                        valc::Mallocator<std::vector<bool>>> vec {
+        std::vector<bool> { 0 }, std::vector<bool> { 0, 0 }, std::vector<bool> { 1 },
+        std::vector<bool> { 1 }, std::vector<bool> { 1, 0 }, std::vector<bool> { 1, 1 } };
+
+      for (std::vector<bool> const & el : vec) {
+        print(el);
       }
+      std::cout << "\nsize: "s << vec.size() << ", capacity: "s << vec.capacity() << '\n';
+    }
+
+    //  bit_vector keys, probed with a span of words.
+    using bits = vecbit::bit_vector<>;
+    vecflat::flat_set<bits, vecbit::bit_hash, vecbit::bit_equal> vbs {
+      bits { 0 }, bits { 0, 0 }, bits { 1 }, bits { 1 }, bits { 1, 0 }, bits { 1, 1 } };
+    for (bits const & el : vbs) {
+      print(el);
     }
     std::cout << '\n';
 
-    std::cout << "std::vector - rbegin, rend"s << '\n';
-    {
-      std::vector<int> nums { 1, 2, 4, 8, 16, };
-      std::vector<std::string> fruits { "orange"s, "apple"s, "raspberry"s, };
-      std::vector<char> empty;
+    std::uint64_t const raw[] = { 0b11, };
+    std::cout << std::boolalpha
+              << "contains { 1 1 } from words: "s
+              << vbs.contains(vecbit::bit_view { raw, 2, }) << '\n'
+              << "contains { 1 1 0 } from words: "s
+              << vbs.contains(vecbit::bit_view { raw, 3, }) << '\n'
+              << std::noboolalpha;
+    vbs.erase(bits { 1, 1 });
+    std::cout << "after erase { 1 1 }, size: "s << vbs.size() << '\n';
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
 
-      // Print vector.
-      std::for_each(nums.rbegin(), nums.rend(), [](const int n_) {
-        std::cout << n_ << ' ';
-      });
-      std::cout << '\n';
+  return 0;
+}
 
-      // Sums all integers in the vector nums (if any), printing only the result.
-      std::cout << "Sum of nums: "s
-                << std::accumulate(nums.rbegin(), nums.rend(), 0) << '\n';
+//  MARK: - C_vector_bench
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  ================================================================================
+//  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace bench
+namespace bench {
 
-      // Prints the first fruit in the vector fruits, checking if there is any.
-      if (!fruits.empty()) {
-        std::cout << "First fruit: "s << *fruits.rbegin() << '\n';
+using clock = std::chrono::steady_clock;
+
+//  run with --bench-large to include the big (GB-class) sizes.
+inline bool large = false;
+
+template <class Fn>
+double time_ns(Fn && fn) {
+  auto const t0 = clock::now();
+  fn();
+  return std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+}
+
+//  keep the optimiser from discarding a computed value.
+template <class T>
+inline void do_not_optimize(T const & val) {
+  asm volatile("" : : "r,m"(val) : "memory");
+}
+
+//  bytes per nanosecond is GB/s.
+inline double gbps(double bytes, double ns) {
+  return bytes / ns;
+}
+
+} /* namespace bench */
+
+/*
+ *  MARK: C_vector_bench()
+ */
+int C_vector_bench(int argc, const char * argv[]) {
+  std::cout << "In "s << __func__ << std::endl;
+
+  bench::large = std::any_of(argv + 1, argv + argc, [](char const * arg) {
+    return std::string_view(arg) == "--bench-large";
+  });
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "valc::trace - ring record cost"s << '\n';
+  {
+    auto & tc = valc::trace::collector::instance();
+    auto constexpr rounds(256ul);
+    auto constexpr batch(valc::trace::ring::capacity);
+    int probe {};
+
+    valc::trace::mode_scope const traced(valc::trace::mode::ring);
+    auto total(0.0);
+    for (auto rn = 0ul; rn < rounds; ++rn) {
+      total += bench::time_ns([&]() {
+        for (auto ev = 0ul; ev < batch; ++ev) {
+          valc::trace::record(valc::trace::event_type::allocate, ev, &probe,
+                              typeid(int).name());
+        }
+      });
+      tc.drain([](valc::trace::event const & ev) { bench::do_not_optimize(ev); });
+    }
+
+    //  the floor under each event.
+    auto const ns_clock = bench::time_ns([]() {
+      for (auto ev = 0ul; ev < batch; ++ev) {
+        bench::do_not_optimize(std::chrono::steady_clock::now());
       }
+    });
 
-      if (empty.rbegin() == empty.rend()) {
-        std::cout << "vector 'empty' is indeed empty.\n"s;
+    std::cout << "ring record: "s << std::fixed << std::setprecision(1)
+              << total / (rounds * batch) << " ns/event, of which steady_clock::now "s
+              << ns_clock / batch << " ns, dropped: "s
+              << tc.dropped() << '\n' << std::defaultfloat;
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "valc::Mallocator - push_back, ring vs. off"s << '\n';
+  {
+    auto constexpr count(1'000'000);
+    auto push = []() {
+      std::vector<int, valc::Mallocator<int>> vnr;
+      for (int nr = 0; nr < count; ++nr) {
+        vnr.push_back(nr);
       }
+      bench::do_not_optimize(vnr.data());
+    };
+
+    for (auto md : { valc::trace::mode::off, valc::trace::mode::ring, }) {
+      valc::trace::mode_scope const traced(md);
+      auto const ns = bench::time_ns(push);
+      valc::trace::collector::instance().drain([](valc::trace::event const &) {});
+      std::cout << (md == valc::trace::mode::off ? "off:  "s : "ring: "s)
+                << std::fixed << std::setprecision(2) << ns / count
+                << " ns/push_back\n"s << std::defaultfloat;
     }
-    std::cout << '\n';
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
-  /// Capaciity
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - empty"s << '\n';
+  std::cout << "valc::stats - short-lived Mallocator vectors, stats off vs. on"s << '\n';
   {
-    std::cout << std::boolalpha;
-    std::vector<int> numbers;
-    std::cout << "Initially, numbers.empty(): "s
-              << numbers.empty() << '\n';
-
-    numbers.push_back(42);
-    std::cout << "After adding elements, numbers.empty(): "s
-              << numbers.empty() << '\n';
-    std::cout << std::noboolalpha;
+    //  every vector grows through five blocks, so this is allocator-bound.
+    auto constexpr count(200'000);
+    auto churn = []() {
+      for (int vn = 0; vn < count; ++vn) {
+        std::vector<int, valc::Mallocator<int>> vnr;
+        for (int nr = 0; nr < 16; ++nr) {
+          vnr.push_back(nr);
+        }
+        bench::do_not_optimize(vnr.data());
+      }
+    };
 
-    std::cout << '\n';
+    auto const was_enabled = valc::stats::enabled();
+    valc::trace::mode_scope const quiet(valc::trace::mode::off);
+    for (auto on : { false, true, }) {
+      valc::stats::enable(on);
+      valc::stats::site here("bench churn");
+      auto const ns = bench::time_ns(churn);
+      std::cout << (on ? "on:  "s : "off: "s) << std::fixed << std::setprecision(2)
+                << ns / (count * 5.0) << " ns/allocation\n"s << std::defaultfloat;
+    }
+    valc::stats::enable(was_enabled);
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - size"s << '\n';
+  std::cout << "valc::ArenaAllocator - short-lived push_back vectors"s << '\n';
   {
-    std::vector<int> nums { 1, 3, 5, 7, };
+    //  many small vectors, each filled with push_back and then dropped,
+    //  as in the C_vector sections.
+    auto constexpr rounds(100'000);
+    auto constexpr count(100);
+    auto churn = [](auto tag) {
+      using alloc = decltype(tag);
+      return bench::time_ns([]() {
+        for (int rn = 0; rn < rounds; ++rn) {
+          valc::arena::scope sc;
+          std::vector<int, alloc> vnr;
+          for (int nr = 0; nr < count; ++nr) {
+            vnr.push_back(nr);
+          }
+          bench::do_not_optimize(vnr.data());
+        }
+      }) / rounds;
+    };
 
-    std::cout << "nums contains "s << nums.size() << " elements.\n"s;
+    valc::trace::mode_scope const quiet(valc::trace::mode::off);
+    auto const ns_std = churn(std::allocator<int>());
+    auto const ns_mal = churn(valc::Mallocator<int>());
+    auto const ns_arn = churn(valc::ArenaAllocator<int>());
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "std::allocator:       "s << ns_std << " ns/vector\n"s
+              << "valc::Mallocator:     "s << ns_mal << " ns/vector\n"s
+              << "valc::ArenaAllocator: "s << ns_arn << " ns/vector\n"s
+              << std::defaultfloat;
+    valc::arena::local().report();
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "valc::PoolAllocator - grow/shrink churn"s << '\n';
+  {
+    //  vectors grown without reserve to a varying size, then dropped.
+    auto constexpr rounds(20'000);
+    auto churn = [](auto tag) {
+      using alloc = decltype(tag);
+      return bench::time_ns([]() {
+        for (int rn = 0; rn < rounds; ++rn) {
+          std::vector<int, alloc> vnr;
+          auto const count = 64 + rn % 4096;
+          for (int nr = 0; nr < count; ++nr) {
+            vnr.push_back(nr);
+          }
+          bench::do_not_optimize(vnr.data());
+        }
+      }) / rounds;
+    };
 
-    std::cout << '\n';
+    valc::trace::mode_scope const quiet(valc::trace::mode::off);
+    auto const ns_std = churn(std::allocator<int>());
+    auto const ns_mal = churn(valc::Mallocator<int>());
+    valc::pool::reset_stats();
+    auto const ns_pol = churn(valc::PoolAllocator<int>());
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "std::allocator:      "s << ns_std << " ns/vector\n"s
+              << "valc::Mallocator:    "s << ns_mal << " ns/vector\n"s
+              << "valc::PoolAllocator: "s << ns_pol << " ns/vector\n"s
+              << std::defaultfloat;
+    valc::pool::report();
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - max_size"s << '\n';
+  std::cout << "vecgrw::growth_vector - push_back vs. std::vector"s << '\n';
   {
-    std::vector<char> svec;
-    std::cout << "Maximum size of a 'vector' is "s << svec.max_size() << "\n"s;
+    auto const count = bench::large ? 100'000'000 : 10'000'000;
+    auto push = [count](auto tag) {
+      using vector_type = decltype(tag);
+      return bench::time_ns([count]() {
+        vector_type vnr;
+        for (int nr = 0; nr < count; ++nr) {
+          vnr.push_back(nr);
+        }
+        bench::do_not_optimize(vnr.data());
+      }) / count;
+    };
 
-    std::cout << '\n';
+    using mal = valc::Mallocator<int>;
+    valc::trace::mode_scope const quiet(valc::trace::mode::off);
+    auto const ns_std = push(std::vector<int>());
+    auto const ns_stm = push(std::vector<int, mal>());
+    auto const ns_g2a = push(vecgrw::growth_vector<int>());
+    auto const ns_g2m = push(vecgrw::growth_vector<int, mal>());
+    auto const ns_g15 = push(vecgrw::growth_vector<int, mal, vecgrw::growth_1_5x>());
+
+    std::cout << count << " ints\n"s << std::fixed << std::setprecision(2)
+              << "std::vector<int>:                     "s << ns_std << " ns/push_back\n"s
+              << "std::vector<int, Mallocator>:         "s << ns_stm << " ns/push_back\n"s
+              << "growth_vector<int>, 2x:               "s << ns_g2a << " ns/push_back\n"s
+              << "growth_vector<int, Mallocator>, 2x:   "s << ns_g2m << " ns/push_back\n"s
+              << "growth_vector<int, Mallocator>, 1.5x: "s << ns_g15 << " ns/push_back\n"s
+              << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - reserve"s << '\n';
+  std::cout << "vecapp - bulk append vs. push_back loops"s << '\n';
   {
-    int sz = 100;
-    std::cout << "using reserve: \n"s;
-    {
-      std::vector<int, vecrsv::NAlloc<int>> v1;
-      v1.reserve(sz);
-      for (int n_ = 0; n_ < sz; ++n_) {
-        v1.push_back(n_);
-      }
-    }
-    std::cout << "not using reserve: \n"s;
-    {
-      std::vector<int, vecrsv::NAlloc<int>> v1;
-        for (int n_ = 0; n_ < sz; ++n_) {
-          v1.push_back(n_);
-        }
+    auto const count = bench::large ? 100'000'000ul : 1'000'000ul;
+    std::vector<int> source(count);
+    std::iota(source.begin(), source.end(), 0);
+    std::string text;
+    for (auto const nr : source) {
+      text += std::to_string(nr);
+      text += ' ';
     }
 
-    std::cout << '\n';
+    //  allocations counted from the trace rings (sizes fit one ring).
+    auto allocations = []() {
+      auto count(0ul);
+      valc::trace::collector::instance().drain([&count](valc::trace::event const & ev) {
+        count += ev.type == valc::trace::event_type::allocate;
+      });
+      return count;
+    };
+    using grow = vecgrw::growth_vector<int, valc::Mallocator<int>>;
+    using stdv = std::vector<int, valc::Mallocator<int>>;
+    valc::trace::mode_scope const quiet(valc::trace::mode::off);
+    auto row = [&](char const * name, auto && fn) {
+      allocations();
+      auto ns = 0.0;
+      {
+        valc::trace::mode_scope const traced(valc::trace::mode::ring);
+        ns = bench::time_ns(fn);
+      }
+      std::cout << std::setw(36) << name << ": "s << std::setw(7) << ns / count
+                << " ns/element, "s << std::setw(3) << allocations() << " allocations\n"s;
+    };
+
+    std::cout << count << " ints\n"s << std::fixed << std::setprecision(2);
+    row("range, std::vector push_back", [&]() {
+      stdv vec;
+      for (auto const nr : source) {
+        vec.push_back(nr);
+      }
+      bench::do_not_optimize(vec.data());
+    });
+    row("range, std::vector vecapp::append", [&]() {
+      stdv vec;
+      vecapp::append(vec, source);
+      bench::do_not_optimize(vec.data());
+    });
+    row("range, growth_vector append", [&]() {
+      grow vec;
+      vecapp::append(vec, source);
+      bench::do_not_optimize(vec.data());
+    });
+    row("count+fn, std::vector push_back", [&]() {
+      stdv vec;
+      for (auto ix = 0ul; ix < count; ++ix) {
+        vec.push_back(static_cast<int>(ix));
+      }
+      bench::do_not_optimize(vec.data());
+    });
+    row("count+fn, growth_vector append_n", [&]() {
+      grow vec;
+      vecapp::append_n(vec, count, [](std::size_t ix) { return static_cast<int>(ix); });
+      bench::do_not_optimize(vec.data());
+    });
+    row("stream, std::vector >> push_back", [&]() {
+      std::istringstream is(text);
+      stdv vec;
+      for (int nr; is >> nr; ) {
+        vec.push_back(nr);
+      }
+      bench::do_not_optimize(vec.data());
+    });
+    row("stream, growth_vector append_from", [&]() {
+      std::istringstream is(text);
+      grow vec;
+      vecapp::append_from(vec, is);
+      assert(vec.size() == count);
+      bench::do_not_optimize(vec.data());
+    });
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - capacity"s << '\n';
+  std::cout << "resize then overwrite - value-init vs. default-init"s << '\n';
   {
-    int sz = 200;
-    std::vector<int> v1;
-
-    auto cap = v1.capacity();
-    std::cout << "initial capacity=" << cap << '\n';
+    using stdv = std::vector<char, valc::Mallocator<char>>;
+    using dflt = std::vector<char, valc::DefaultInitAllocator<valc::Mallocator<char>>>;
+    using grow = vecgrw::growth_vector<char, valc::Mallocator<char>>;
 
-    for (int n_ = 0; n_ < sz; ++n_) {
-      v1.push_back(n_);
-      if (cap != v1.capacity()) {
-        cap = v1.capacity();
-        std::cout << "new capacity="s << cap << '\n';
-      }
+    std::vector<std::size_t> sizes = { 1ul << 20, 64ul << 20, };
+    if (bench::large) {
+      sizes.push_back(1ul << 30);
     }
 
-    std::cout << "final size="s << v1.size() << '\n';
-    std::cout << "final capacity="s << v1.capacity() << '\n';
-
-    std::cout << '\n';
+    valc::trace::mode_scope const quiet(valc::trace::mode::off);
+    std::cout << std::fixed << std::setprecision(2);
+    for (auto const bytes : sizes) {
+      //  resize, then write every byte once, as a read() into the buffer
+      //  would; best of five, so the first row doesn't pay the warm-up.
+      auto run = [bytes](auto tag, auto && resize) {
+        auto best = std::numeric_limits<double>::max();
+        for (auto rep = 0; rep < 5; ++rep) {
+          decltype(tag) vec;
+          best = std::min(best, bench::time_ns([&]() {
+            resize(vec, bytes);
+            std::memset(vec.data(), 0x5a, vec.size());
+            bench::do_not_optimize(vec.data());
+          }));
+        }
+        return best;
+      };
+      auto const ns_std = run(stdv {}, [](auto & vec, std::size_t nv) { vec.resize(nv); });
+      auto const ns_dfl = run(dflt {}, [](auto & vec, std::size_t nv) { vec.resize(nv); });
+      auto const ns_grz = run(grow {}, [](auto & vec, std::size_t nv) { vec.resize(nv); });
+      auto const ns_gfo = run(grow {}, [](auto & vec, std::size_t nv) { vec.resize_for_overwrite(nv); });
+
+      //  the saving is measured against std::vector's zero-filling resize.
+      auto row = [bytes, ns_std](char const * name, double ns) {
+        std::cout << std::setw(40) << name << ": "s << std::setw(12) << ns << " ns, "s
+                  << std::setw(6) << bench::gbps(bytes, ns) << " GB/s ("s
+                  << ns_std / ns << "x std::vector resize)\n"s;
+      };
+      std::cout << (bytes >> 20) << " MB\n"s;
+      row("std::vector resize", ns_std);
+      row("std::vector DefaultInitAllocator resize", ns_dfl);
+      row("growth_vector resize", ns_grz);
+      row("growth_vector resize_for_overwrite", ns_gfo);
+    }
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - shrink_to_fit"s << '\n';
+  std::cout << "vecers::erase_if - compaction vs. erase loop, std::erase_if"s << '\n';
   {
-    std::vector<int> vec;
-    std::cout << "Default-constructed capacity is "s << vec.capacity() << '\n';
-    vec.resize(100);
-    std::cout << "Capacity of a 100-element vector is "s << vec.capacity() << '\n';
-    vec.resize(50);
-    std::cout << "Capacity after resize(50) is " << vec.capacity() << '\n';
-    vec.shrink_to_fit();
-    std::cout << "Capacity after shrink_to_fit() is "s << vec.capacity() << '\n';
-    vec.clear();
-    std::cout << "Capacity after clear() is "s << vec.capacity() << '\n';
-    vec.shrink_to_fit();
-    std::cout << "Capacity after shrink_to_fit() is "s << vec.capacity() << '\n';
-    for (int i_ = 1000; i_ < 1300; ++i_) {
-      vec.push_back(i_);
+    //  random values, so whether an element goes is unpredictable.
+    std::vector<std::size_t> sizes = { 100'000ul, 1'000'000ul, 10'000'000ul, };
+    if (bench::large) {
+      sizes.push_back(100'000'000ul);
     }
-    std::cout << "Capacity after adding 300 elements is "s << vec.capacity() << '\n';
-    vec.shrink_to_fit();
-    std::cout << "Capacity after shrink_to_fit() is "s << vec.capacity() << '\n';
-
-    std::cout << '\n';
+    //  the erase loop is quadratic: only the smallest size is timed.
+    auto constexpr loop_limit(100'000ul);
+
+    auto run = [&](auto tag, char const * type) {
+      using T = decltype(tag);
+      std::cout << type << ", kernels: "s << vecers::name() << '\n';
+      for (auto const count : sizes) {
+        std::vector<T> source(count);
+        std::mt19937_64 gen(count);
+        std::generate(source.begin(), source.end(), [&gen]() { return static_cast<T>(gen()); });
+        auto even = [](T val) { return val % 2 == 0; };
+
+        auto time = [&](auto && erase) {
+          auto vec = source;
+          auto const ns = bench::time_ns([&]() { erase(vec); });
+          bench::do_not_optimize(vec.data());
+          return std::pair { ns, vec };
+        };
+        auto const [ns_std, by_std] = time([&](auto & vec) { std::erase_if(vec, even); });
+        auto const [ns_ers, by_ers] = time([&](auto & vec) { vecers::erase_if(vec, even); });
+        assert(by_std == by_ers);
+
+        std::cout << std::setw(11) << count << ": "s;
+        if (count <= loop_limit) {
+          auto const [ns_loop, by_loop] = time([&](auto & vec) {
+            for (auto it = vec.begin(); it != vec.end(); ) {
+              it = even(*it) ? vec.erase(it) : it + 1;
+            }
+          });
+          assert(by_loop == by_std);
+          std::cout << "erase loop "s << std::setw(8) << ns_loop / count << ", "s;
+        }
+        else {
+          std::cout << "erase loop "s << std::setw(8) << "-"s << ", "s;
+        }
+        std::cout << "std::erase_if "s << std::setw(5) << ns_std / count
+                  << ", vecers::erase_if "s << std::setw(5) << ns_ers / count
+                  << " ns/element ("s << ns_std / ns_ers << "x)\n"s;
+      }
+    };
+    std::cout << std::fixed << std::setprecision(2);
+    run(std::int32_t {}, "int32_t");
+    run(char {}, "char");
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
-  /// Modifiers
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - clear"s << '\n';
+  std::cout << "vecpar - scaling, 1 to "s << std::thread::hardware_concurrency() << " threads"s << '\n';
   {
-    std::vector<int> container { 1, 2, 3, };
-     
-    auto print = [](const int& n) { std::cout << " " << n; };
-
-    std::cout << "Before clear:";
-    std::for_each(container.begin(), container.end(), print);
-    std::cout << "\nSize=" << container.size()
-              << ", Capacity=" << container.capacity() << '\n';
-
-    std::cout << "Clear\n";
-    container.clear();
+    auto const count = bench::large ? 100'000'000ul : 10'000'000ul;
+    std::vector<int> source(count);
+    std::mt19937 gen(7);
+    std::generate(source.begin(), source.end(), [&gen]() { return static_cast<int>(gen()); });
+
+    std::vector<std::size_t> threads;
+    auto const hw = std::max(1u, std::thread::hardware_concurrency());
+    for (auto th = 1ul; th < hw; th *= 2) {
+      threads.push_back(th);
+    }
+    threads.push_back(hw);
 
-    std::cout << "After clear:";
-    std::for_each(container.begin(), container.end(), print);
-    std::cout << "\nSize=" << container.size()
-              << ", Capacity=" << container.capacity() << '\n';
+    std::cout << count << " ints, ms (speed-up over 1 thread)\n"s;
+    std::cout << std::setw(8) << "threads"s;
+    for (auto const * name : { "sort", "reduce", "scan", "for_each", "std::sort", }) {
+      std::cout << std::setw(18) << name;
+    }
+    std::cout << '\n' << std::fixed << std::setprecision(1);
 
-    std::cout << '\n';
+    std::array<double, 4> base {};
+    auto const ns_std = bench::time_ns([&]() {
+      auto vec = source;
+      std::sort(vec.begin(), vec.end());
+      bench::do_not_optimize(vec.data());
+    });
+    for (auto const th : threads) {
+      vecpar::pool pl(th);
+      auto vec = source;
+      std::vector<long long> sums(count);
+      std::array<double, 4> ns {};
+      ns[0] = bench::time_ns([&]() { vecpar::sort(pl, vec); });
+      assert(std::is_sorted(vec.begin(), vec.end()));
+      ns[1] = bench::time_ns([&]() { bench::do_not_optimize(vecpar::reduce(pl, source, 0ll)); });
+      ns[2] = bench::time_ns([&]() { vecpar::inclusive_scan(pl, source, sums); });
+      ns[3] = bench::time_ns([&]() { vecpar::for_each(pl, vec, [](int & nr) { nr ^= nr >> 7; }); });
+      if (th == 1) {
+        base = ns;
+      }
+      std::cout << std::setw(8) << th;
+      for (auto ix = 0ul; ix < ns.size(); ++ix) {
+        std::cout << std::setw(10) << ns[ix] / 1e6 << " ("s << std::setw(4) << base[ix] / ns[ix] << ")"s;
+      }
+      std::cout << std::setw(18) << ns_std / 1e6 << '\n';
+    }
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - insert"s << '\n';
+  std::cout << "veccmp - compare, equal vs. <=>, <, =="s << '\n';
   {
-    auto print_vec = [](const std::vector<int>& vec) {
-        for (auto x_ : vec) {
-             std::cout << ' ' << x_ ;
+    auto constexpr rounds(64);
+    auto run = [&](auto tag, char const * type, std::size_t count) {
+      using T = decltype(tag);
+      std::vector<T> lhs(count);
+      std::mt19937 gen(5);
+      std::generate(lhs.begin(), lhs.end(), [&gen]() { return static_cast<T>(gen()); });
+      std::cout << type << ", "s << count << " elements, kernels: "s << veccmp::name()
+                << ", ns per comparison\n"s;
+      std::cout << std::setw(16) << "" << std::setw(12) << "<=>"s << std::setw(12) << "<"s
+                << std::setw(12) << "=="s << std::setw(16) << "veccmp::compare"s
+                << std::setw(14) << "veccmp::equal"s << '\n';
+      for (auto const at : { count, std::size_t(3), count - 1, }) {
+        auto rhs = lhs;
+        if (at < count) {
+          rhs[at] = static_cast<T>(rhs[at] + 1);
         }
-        std::cout << '\n';
+        auto per = [&](auto && cmp) {
+          return bench::time_ns([&]() {
+            for (auto rn = 0; rn < rounds; ++rn) {
+              bench::do_not_optimize(cmp());
+            }
+          }) / rounds;
+        };
+        auto const ns_3w = per([&]() { return std::is_lt(lhs <=> rhs); });
+        auto const ns_lt = per([&]() { return lhs < rhs; });
+        auto const ns_eq = per([&]() { return lhs == rhs; });
+        auto const ns_vc = per([&]() { return std::is_lt(veccmp::compare(lhs, rhs)); });
+        auto const ns_ve = per([&]() { return veccmp::equal(lhs, rhs); });
+        assert((lhs <=> rhs) == veccmp::compare(lhs, rhs));
+        std::cout << std::setw(16) << (at == count ? "equal"s : at == 3 ? "early mismatch"s : "late mismatch"s)
+                  << std::setw(12) << ns_3w << std::setw(12) << ns_lt << std::setw(12) << ns_eq
+                  << std::setw(16) << ns_vc << std::setw(14) << ns_ve << '\n';
+      }
     };
-
-    std::vector<int> vec(3, 100);
-    print_vec(vec);
-
-    auto it = vec.begin();
-    it = vec.insert(it, 200);
-    print_vec(vec);
-
-    vec.insert(it, 2, 300);
-    print_vec(vec);
-
-    // "it" no longer valid, get a new one:
-    it = vec.begin();
-
-    std::vector<int> vec2(2, 400);
-    vec.insert(it + 2, vec2.begin(), vec2.end());
-    print_vec(vec);
-
-    int arr[] = { 501, 502, 503, };
-    vec.insert(vec.begin(), arr, arr + 3);
-    print_vec(vec);
-
-    std::cout << '\n';
+    std::cout << std::fixed << std::setprecision(1);
+    run(int {}, "std::vector<int>", 1ul << 20);
+    run(char {}, "std::vector<char>", 1ul << 22);
+
+    //  sorting keys that share a long prefix, as in dedup of near-duplicates.
+    auto constexpr keys(1ul << 15);
+    auto constexpr length(256ul);
+    std::vector<std::vector<int>> source(keys, std::vector<int>(length, 7));
+    std::mt19937 gen(9);
+    for (auto & key : source) {
+      key[length - 1 - gen() % 16] = static_cast<int>(gen() % 64) - 32;
+    }
+    auto sorted = [&](auto cmp) {
+      auto vec = source;
+      auto const ns = bench::time_ns([&]() { std::sort(vec.begin(), vec.end(), cmp); });
+      assert(std::is_sorted(vec.begin(), vec.end()));
+      return ns;
+    };
+    auto const ns_std = sorted(std::less<> {});
+    auto const ns_vcl = sorted(veccmp::less {});
+    std::cout << "std::sort of "s << keys << " keys of "s << length << " ints, shared prefix: "s
+              << "std::less "s << ns_std / 1e6 << " ms, veccmp::less "s << ns_vcl / 1e6 << " ms\n"s;
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - emplace"s << '\n';
+  std::cout << "vecfmt - buffered printers vs. vec, vecpop, vecswp"s << '\n';
   {
-    struct Aempl {
-      std::string str;
-
-      Aempl(std::string str) : str(std::move(str))  {
-        std::cout << " constructed\n"s;
-      }
-
-      Aempl(const Aempl & other) : str(other.str) {
-        std::cout << " copy constructed\n"s;
-      }
-
-      Aempl(Aempl && other) : str(std::move(other.str)) {
-        std::cout << " move constructed\n"s;
-      }
-
-      Aempl & operator=(const Aempl & other) {
-        str = other.str;
-        std::cout << " copy assigned\n"s;
-        return *this;
+    //  counts and discards what is written, so only formatting is timed.
+    struct sink : std::streambuf {
+      std::size_t bytes = 0;
+      int_type overflow(int_type ch) override {
+        ++bytes;
+        return ch;
       }
-
-      Aempl & operator=(Aempl && other) {
-        str = std::move(other.str);
-        std::cout << " move assigned\n"s;
-        return *this;
+      std::streamsize xsputn(char const *, std::streamsize count) override {
+        bytes += static_cast<std::size_t>(count);
+        return count;
       }
     };
 
-    std::vector<Aempl> container;
-    // reserve enough place so vector does not have to resize
-    container.reserve(10);
-    std::cout << "construct 2 times Aempl:\n"s;
-    Aempl two { "two"s };
-    Aempl three { "three"s };
-
-    std::cout << "emplace:\n"s;
-    container.emplace(container.end(), "one"s);
-
-    std::cout << "emplace with Aempl &:\n"s;
-    container.emplace(container.end(), two);
-
-    std::cout << "emplace with Aempl &&:\n"s;
-    container.emplace(container.end(), std::move(three));
-
-    std::cout << "content:\n"s;
-    for (const auto & obj : container)
-      std::cout << ' ' << obj.str;
-    std::cout << '\n';
+    auto const count = bench::large ? 100'000'000ul : 10'000'000ul;
+    std::vector<int> vnr(count);
+    std::mt19937 gen(3);
+    std::generate(vnr.begin(), vnr.end(), [&gen]() { return static_cast<int>(gen() >> 8); });
+    std::vector<bool> vbl(count);
+    std::generate(vbl.begin(), vbl.end(), [&gen]() { return (gen() & 1) != 0; });
+
+    auto mbps = [](auto && print) {
+      sink sk;
+      std::ostream os(&sk);
+      auto * const old = std::cout.rdbuf(&sk);
+      auto const ns = bench::time_ns([&]() { print(os); });
+      std::cout.rdbuf(old);
+      return std::pair { sk.bytes / (ns / 1e3), sk.bytes };
+    };
+    auto row = [&](char const * name, auto && before, auto && after) {
+      auto const [mb_before, bytes_before] = mbps(before);
+      auto const [mb_after, bytes_after] = mbps(after);
+      assert(bytes_before == bytes_after);
+      std::cout << std::setw(26) << name << ": "s << std::setw(8) << mb_before << " MB/s -> "s
+                << std::setw(8) << mb_after << " MB/s vecfmt ("s << bytes_after / 1'000'000 << " MB)\n"s;
+    };
 
-    std::cout << '\n';
+    std::cout << count << " elements\n"s << std::fixed << std::setprecision(1);
+    row("int,  vec::operator<<",
+        [&](std::ostream & os) { using namespace vec; os << vnr; },
+        [&](std::ostream & os) { vecfmt::print(os, vnr); });
+    row("int,  vecpop::print",
+        [&](std::ostream &) { vecpop::print(vnr); },
+        [&](std::ostream &) { vecfmt::print(std::cout, vnr, vecfmt::style::vecpop); });
+    row("int,  vecswp::operator<<",
+        [&](std::ostream & os) { using namespace vecswp; os << vnr; },
+        [&](std::ostream & os) { vecfmt::print(os, vnr, vecfmt::style::vecswp); });
+    row("bool, vecpop::print",
+        [&](std::ostream &) { vecpop::print(vbl); },
+        [&](std::ostream &) { vecfmt::print(std::cout, vbl, vecfmt::style::vecpop); });
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - emplace"s << '\n';
+  std::cout << "vecsnap - binary snapshot vs. text round trip"s << '\n';
   {
-    auto print_container = [](std::vector<int> const & ctr) {
-      for (auto & nr : ctr) {
-        std::cout << nr << ' ';
-      }
-      std::cout << '\n';
-    };
+    auto const dir = std::filesystem::temp_directory_path();
+    auto const snap_path = (dir / "vectors_bench.snap").string();
+    auto const text_path = (dir / "vectors_bench.txt").string();
 
-    std::vector<int> container { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, };
-    print_container(container);
-
-    container.erase(container.begin());
-    print_container(container);
+    auto const bytes = bench::large ? 1ul << 30 : 64ul << 20;
+    std::vector<int> vnr(bytes / sizeof(int));
+    std::mt19937 gen(11);
+    std::generate(vnr.begin(), vnr.end(), [&gen]() { return static_cast<int>(gen()); });
 
-    container.erase(container.begin() + 2, container.begin() + 5);
-    print_container(container);
+    auto row = [](char const * name, double ns) {
+      std::cout << std::setw(32) << name << ": "s << std::setw(10) << ns / 1e6 << " ms\n"s;
+    };
+    std::cout << (bytes >> 20) << " MB of ints (page cache warm)\n"s << std::fixed << std::setprecision(3);
+
+    row("snapshot save", bench::time_ns([&]() { vecsnap::save(snap_path, vnr); }));
+    row("view open, header check", bench::time_ns([&]() {
+      vecsnap::view<int> vw(snap_path);
+      bench::do_not_optimize(vw[vw.size() / 2]);
+    }));
+    row("view open, checksum", bench::time_ns([&]() {
+      vecsnap::view<int> vw(snap_path, vecsnap::check::checksum);
+      bench::do_not_optimize(vw[vw.size() / 2]);
+    }));
+    {
+      valc::trace::mode_scope const quiet(valc::trace::mode::off);
+      row("view open + to_vector(Mallocator)", bench::time_ns([&]() {
+        auto copy = vecsnap::view<int>(snap_path).to_vector(valc::Mallocator<int>());
+        assert(copy.size() == vnr.size() && copy.back() == vnr.back());
+      }));
+    }
 
-    // Erase all even numbers (C++11 and later)
-    for (auto it = container.begin(); it != container.end(); ) {
-      if (*it % 2 == 0) {
-        it = container.erase(it);
+    //  the text round trip is only run at the default size.
+    if (!bench::large) {
+      std::unique_ptr<std::FILE, int (*)(std::FILE *)> fp(std::fopen(text_path.c_str(), "w"),
+                                                          &std::fclose);
+      if (!fp) {
+        std::cout << "text round trip skipped, cannot create "s << text_path << ": "s
+                  << std::strerror(errno) << '\n';
       }
       else {
-        ++it;
+        row("text save (vecfmt)", bench::time_ns([&]() {
+          {
+            vecfmt::writer out(fp.get());
+            for (auto const nr : vnr) {
+              out << nr << ' ';
+            }
+          }
+          fp.reset();
+        }));
+        row("text load (vecapp::append_from)", bench::time_ns([&]() {
+          std::ifstream is(text_path);
+          std::vector<int> loaded;
+          vecapp::append_from(loaded, is);
+          assert(loaded == vnr);
+        }));
+        std::filesystem::remove(text_path);
       }
     }
-    print_container(container);
-
-    std::cout << '\n';
+    std::filesystem::remove(snap_path);
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
+#if defined(VALC_MAPPED)
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - push_back"s << '\n';
+  std::cout << "valc::MappedAllocator - append, random read vs. heap"s << '\n';
   {
-    std::vector<std::string> letters;
-
-    letters.push_back("abc"s);
-    std::string str = "def"s;
-    letters.push_back(std::move(str));
+    auto const count = bench::large ? 500'000'000ul : 20'000'000ul;
+    auto constexpr reads(10'000'000ul);
+    std::vector<std::size_t> probes(reads);
+    std::mt19937_64 gen(13);
+    std::generate(probes.begin(), probes.end(), [&gen, count]() { return gen() % count; });
+
+    valc::trace::mode_scope const quiet(valc::trace::mode::off);
+    auto run = [&](auto tag, char const * name) {
+      auto append(0.0), read(0.0);
+      {
+        decltype(tag) vec;
+        append = bench::time_ns([&]() {
+          for (auto ix = 0ul; ix < count; ++ix) {
+            vec.push_back(static_cast<int>(ix));
+          }
+        });
+        read = bench::time_ns([&]() {
+          long long sum {};
+          for (auto const ix : probes) {
+            sum += vec[ix];
+          }
+          bench::do_not_optimize(sum);
+        });
+      }
+      std::cout << std::setw(38) << name << ": append "s << std::setw(6) << append / count
+                << " ns/element, random read "s << std::setw(6) << read / reads
+                << " ns/read\n"s;
+    };
+    std::cout << count << " ints, "s << reads << " random reads\n"s << std::fixed << std::setprecision(2);
+    run(std::vector<int> {}, "std::vector<int>");
+    run(vecgrw::growth_vector<int, valc::Mallocator<int>> {}, "growth_vector<int, Mallocator>");
+    run(std::vector<int, valc::MappedAllocator<int>> {}, "std::vector<int, MappedAllocator>");
+    run(vecgrw::growth_vector<int, valc::MappedAllocator<int>> {}, "growth_vector<int, MappedAllocator>");
+    std::cout << std::defaultfloat;
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
+#endif  /* defined(VALC_MAPPED) */
 
-    std::cout << "vector holds: "s;
-    for (auto && im : letters) {
-      std::cout << std::quoted(im) << ' ';
-    }
-    std::cout << "\nMoved-from string holds "s << std::quoted(str) << '\n';
-    std::cout << '\n';
+#if defined(VALC_HUGE)
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "valc::HugePageAllocator - scans of a large std::vector<int>"s << '\n';
+  {
+    auto const bytes = bench::large ? 4ul << 30 : 512ul << 20;
+    auto const count = bytes / sizeof(int);
+    auto constexpr reads(10'000'000ul);
+    std::vector<std::uint32_t> probes(reads);
+    std::mt19937 gen(17);
+    std::generate(probes.begin(), probes.end(), [&gen, count]() {
+      return static_cast<std::uint32_t>(gen() % count);
+    });
 
-    std::cout << '\n';
+    valc::trace::mode_scope const quiet(valc::trace::mode::off);
+    auto run = [&](auto tag, char const * name) {
+      using vector_type = decltype(tag);
+      std::optional<vector_type> vec;
+      auto const ns_fill = bench::time_ns([&]() { vec.emplace(count, 1); });
+      auto const ns_scan = bench::time_ns([&]() {
+        bench::do_not_optimize(std::accumulate(vec->begin(), vec->end(), 0ll));
+      });
+      auto const ns_rand = bench::time_ns([&]() {
+        long long sum {};
+        for (auto const ix : probes) {
+          sum += (*vec)[ix];
+        }
+        bench::do_not_optimize(sum);
+      });
+      std::cout << std::setw(36) << name << ": fill "s << std::setw(8) << ns_fill / 1e6
+                << " ms, scan "s << std::setw(6) << bench::gbps(bytes, ns_scan)
+                << " GB/s, random read "s << std::setw(6) << ns_rand / reads << " ns\n"s;
+    };
+    std::cout << (bytes >> 20) << " MB, "s << valc::huge::describe() << '\n'
+              << std::fixed << std::setprecision(2);
+    run(std::vector<int> {}, "std::vector<int>");
+    run(std::vector<int, valc::HugePageAllocator<int>> {}, "std::vector<int, HugePageAllocator>");
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
+#endif  /* defined(VALC_HUGE) */
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - emplace_back"s << '\n';
+  std::cout << "vecsbo::small_vector - tiny vectors vs. std::vector"s << '\n';
   {
-    struct President {
-      std::string name;
-      std::string country;
-      int year;
-
-      President(std::string p_name, std::string p_country, int p_year)
-        : name(std::move(p_name)),
-          country(std::move(p_country)),
-          year(p_year) {
-        std::cout << "I am being constructed.\n"s;
+    //  the first C_vector section: { 7, 5, 16, 8, } plus two push_backs.
+    auto constexpr rounds(1'000'000);
+    auto constexpr probe(1'000);
+    auto tiny = [](auto tag, int count) {
+      using vector_type = decltype(tag);
+      for (int rn = 0; rn < count; ++rn) {
+        vector_type vnr { 7, 5, 16, 8, };
+        vnr.push_back(25);
+        vnr.push_back(rn);
+        bench::do_not_optimize(vnr.data());
       }
-
-      President(President && other)
-        : name(std::move(other.name)),
-          country(std::move(other.country)),
-          year(other.year) {
-        std::cout << "I am being moved.\n"s;
+    };
+    //  allocations per vector, counted by valc::stats under a site of its own.
+    auto allocations = [&tiny](auto tag) {
+      auto counted = []() {
+        auto count(0ul);
+        for (auto const & rc : valc::stats::snapshot()) {
+          count += rc.site == "small_vector probe"s ? rc.allocations : 0;
+        }
+        return count;
+      };
+      auto const was_enabled = valc::stats::enabled();
+      auto const before = counted();
+      valc::stats::enable();
+      {
+        valc::stats::site const st("small_vector probe");
+        tiny(tag, probe);
       }
-
-      President & operator=(const President & other) = default;
+      valc::stats::enable(was_enabled);
+      return static_cast<double>(counted() - before) / probe;
+    };
+    auto latency = [&tiny](auto tag) {
+      return bench::time_ns([&]() { tiny(tag, rounds); }) / rounds;
     };
 
-    std::vector<President> elections;
-    std::cout << "emplace_back:\n"s;
-    auto& ref = elections.emplace_back("Nelson Mandela"s, "South Africa"s, 1994);
-    assert(ref.year != 1984 && "uses a reference to the created object (C++17)");
+    using std_vector = std::vector<int, valc::Mallocator<int>>;
+    using sbo_vector = vecsbo::small_vector<int, 8, valc::Mallocator<int>>;
+    using sbo_spill = vecsbo::small_vector<int, 4, valc::Mallocator<int>>;
+    valc::trace::mode_scope const quiet(valc::trace::mode::off);
+    std::cout << std::fixed << std::setprecision(2)
+              << "std::vector<int, Mallocator>:     "s
+              << latency(std_vector()) << " ns/vector, "s
+              << allocations(std_vector()) << " allocations/vector\n"s
+              << "small_vector<int, 8, Mallocator>: "s
+              << latency(sbo_vector()) << " ns/vector, "s
+              << allocations(sbo_vector()) << " allocations/vector\n"s
+              << "small_vector<int, 4, Mallocator>: "s
+              << latency(sbo_spill()) << " ns/vector, "s
+              << allocations(sbo_spill()) << " allocations/vector\n"s
+              << std::defaultfloat;
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
 
-    std::vector<President> reElections;
-    std::cout << "\npush_back:\n"s;
-    reElections.push_back(President("Franklin Delano Roosevelt"s, "the USA"s, 1936));
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "vecpack::packed_vector - scans vs. std::vector by codec"s << '\n';
+  {
+    auto const count = bench::large ? (1ul << 29) : (1ul << 25);
+    auto constexpr probes(1ul << 20);
+    std::cout << count << " values; GB/s of the values as std::vector<T> holds them\n"s
+              << std::fixed << std::setprecision(2);
+
+    auto state = 0x9e3779b97f4a7c15ull;
+    auto next = [&state]() {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      return state;
+    };
 
-    std::cout << "\nContents:\n"s;
-    for (President const& president: elections) {
-      std::cout << president.name << " was elected president of "s
-                << president.country << " in "s << president.year << ".\n"s;
-    }
+    //  the scan: four independent sums, so neither side is held to one
+    //  add-latency chain per value.
+    auto sum = []<class T>(std::span<T const> vals) {
+      std::int64_t acc[4] {};
+      auto ix = 0ul;
+      for (; ix + 4 <= vals.size(); ix += 4) {
+        for (auto ln = 0ul; ln < 4; ++ln) {
+          acc[ln] += vals[ix + ln];
+        }
+      }
+      for (; ix < vals.size(); ++ix) {
+        acc[0] += vals[ix];
+      }
+      return acc[0] + acc[1] + acc[2] + acc[3];
+    };
 
-    for (President const& president: reElections) {
-      std::cout << president.name << " was re-elected president of "s
-                << president.country << " in "s << president.year << ".\n"s;
-    }
+    auto run = [&](std::string const & name, auto tag, auto make) {
+      using T = decltype(tag);
+      std::vector<T> vec(count);
+      for (auto ix = 0ul; ix < count; ++ix) {
+        vec[ix] = make(ix);
+      }
+      std::vector<std::size_t> at(probes);
+      for (auto & pos : at) {
+        pos = next() % count;
+      }
+      auto const logical = count * sizeof(T);
+      std::int64_t sink {};
+      auto const ns_vec = bench::time_ns([&]() {
+        sink += sum(std::span<T const>(vec));
+      });
+      auto const ns_vec_at = bench::time_ns([&]() {
+        for (auto pos : at) {
+          sink += vec[pos];
+        }
+      }) / probes;
+      std::cout << name << ": std::vector scan "s << std::setw(6) << bench::gbps(logical, ns_vec)
+                << " GB/s, random "s << ns_vec_at << " ns\n"s;
+
+      for (auto cd : { vecpack::codec::packed, vecpack::codec::frame, vecpack::codec::delta, }) {
+        vecpack::packed_vector<T> pv(cd);
+        auto const ns_push = bench::time_ns([&]() {
+          for (auto const val : vec) {
+            pv.push_back(val);
+          }
+        }) / count;
+        pv.shrink_to_fit();
+        auto const ns_decode = bench::time_ns([&]() {
+          pv.for_each_block([&sink](std::span<T const> vals) { sink += vals.back(); });
+        });
+        auto const ns_scan = bench::time_ns([&]() {
+          pv.for_each_block([&sink, &sum](std::span<T const> vals) { sink += sum(vals); });
+        });
+        auto const ns_iter = bench::time_ns([&]() {
+          sink += std::accumulate(pv.begin(), pv.end(), std::int64_t(0));
+        });
+        auto const ns_at = bench::time_ns([&]() {
+          for (auto pos : at) {
+            sink += pv[pos];
+          }
+        }) / probes;
+        std::cout << "  "s << std::setw(6) << vecpack::name(cd) << ' '
+                  << std::setw(5) << 8.0 * pv.bytes() / count << " bits/value, decode "s
+                  << std::setw(6) << bench::gbps(logical, ns_decode) << " GB/s, scan "s
+                  << std::setw(6) << bench::gbps(logical, ns_scan) << " GB/s ("s
+                  << ns_vec / ns_scan << "x), iterator "s << std::setw(6)
+                  << bench::gbps(logical, ns_iter) << " GB/s, random "s
+                  << std::setw(6) << ns_at << " ns, push_back "s << ns_push << " ns\n"s;
+      }
+      bench::do_not_optimize(sink);
+    };
 
-    std::cout << '\n';
+    run("int 0..1023       "s, int(), [&next](std::size_t) { return static_cast<int>(next() % 1024); });
+    run("int sorted, +0..15"s, int(), [&next, stamp = 0](std::size_t) mutable {
+      return stamp += static_cast<int>(next() % 16);
+    });
+    run("long 0..255       "s, long(), [&next](std::size_t) { return static_cast<long>(next() % 256); });
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - pop_back"s << '\n';
+  std::cout << "vecsoa::soa_vector - President field filters vs. std::vector<President>"s << '\n';
   {
-    std::vector<int> numbers;
+    //  about 0.7 GB per layout, so there is no large size.
+    auto constexpr count(10'000'000ul);
+    struct President {
+      std::string name;
+      std::string country;
+      int year;
+    };
+    using presidents = vecsoa::soa_vector<vecsoa::field<"name", std::string>,
+                                          vecsoa::field<"country", std::string>,
+                                          vecsoa::field<"year", int>>;
+    std::cout << count << " rows; sizeof(President) "s << sizeof(President)
+              << " bytes, the year column 4\n"s << std::fixed << std::setprecision(2);
+
+    //  short enough to stay in the strings' own buffers.
+    std::array const names {
+      "Mandela"s, "Roosevelt"s, "Lincoln"s, "da Silva"s, "Robinson"s, "Kenyatta"s, "Bachelet"s, "Nehru"s,
+    };
+    std::array const countries {
+      "South Africa"s, "the USA"s, "Brazil"s, "Ireland"s, "Kenya"s, "Chile"s, "India"s, "France"s,
+    };
 
-    vecpop::print(numbers);
+    auto state = 0x9e3779b97f4a7c15ull;
+    auto next = [&state]() {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      return state;
+    };
 
-    numbers.push_back(5);
-    numbers.push_back(3);
-    numbers.push_back(4);
+    auto report = [](std::string const & what, double ns_aos, double ns_soa) {
+      std::cout << std::setw(20) << std::left << what << std::right
+                << ": std::vector "s << std::setw(9) << ns_aos / 1e6 << " ms, soa_vector "s
+                << std::setw(9) << ns_soa / 1e6 << " ms ("s << ns_aos / ns_soa << "x)\n"s;
+    };
 
-    vecpop::print(numbers);
+    //  the best of three, for the passes short enough to be noisy.
+    auto best = [](auto fn) {
+      auto ns = bench::time_ns(fn);
+      for (auto rep = 0; rep < 2; ++rep) {
+        ns = std::min(ns, bench::time_ns(fn));
+      }
+      return ns;
+    };
 
-    numbers.pop_back();
+    std::vector<President> aos;
+    auto const seed = state;
+    auto const ns_aos_build = bench::time_ns([&]() {
+      aos.reserve(count);
+      for (auto ix = 0ul; ix < count; ++ix) {
+        auto const rnd = next();
+        aos.push_back({ names[rnd % names.size()], countries[rnd / 8 % countries.size()],
+                        1789 + int(rnd / 64 % 236), });
+      }
+    });
+    presidents soa;
+    state = seed;
+    auto const ns_soa_build = bench::time_ns([&]() {
+      soa.reserve(count);
+      for (auto ix = 0ul; ix < count; ++ix) {
+        auto const rnd = next();
+        soa.emplace_back(names[rnd % names.size()], countries[rnd / 8 % countries.size()],
+                         1789 + int(rnd / 64 % 236));
+      }
+    });
+    report("build"s, ns_aos_build, ns_soa_build);
+
+    //  one field: the struct scan pulls every row's strings through the cache.
+    auto in_range = [](int yr) { return yr >= 1900 && yr < 1950; };
+    std::ptrdiff_t hits_aos {}, hits_soa {};
+    auto const ns_aos_year = best([&]() {
+      hits_aos = std::count_if(aos.begin(), aos.end(), [&](President const & pres) {
+        return in_range(pres.year);
+      });
+    });
+    auto const ns_soa_year = best([&]() {
+      auto const years = soa.column<"year">();
+      hits_soa = std::count_if(years.begin(), years.end(), in_range);
+    });
+    assert(hits_aos == hits_soa);
+    bench::do_not_optimize(hits_soa);
+    report("year filter"s, ns_aos_year, ns_soa_year);
+
+    //  two fields: the country test, then the year of the rows that pass.
+    std::int64_t sum_aos {}, sum_soa {};
+    auto const ns_aos_both = best([&]() {
+      std::int64_t acc {};
+      for (auto const & pres : aos) {
+        acc += pres.country == "Chile"s ? pres.year : 0;
+      }
+      sum_aos = acc;
+    });
+    auto const ns_soa_both = best([&]() {
+      auto const ctry = soa.column<"country">();
+      auto const years = soa.column<"year">();
+      std::int64_t acc {};
+      for (auto ix = 0ul; ix < ctry.size(); ++ix) {
+        acc += ctry[ix] == "Chile"s ? years[ix] : 0;
+      }
+      sum_soa = acc;
+    });
+    assert(sum_aos == sum_soa);
+    bench::do_not_optimize(sum_soa);
+    report("country+year filter"s, ns_aos_both, ns_soa_both);
 
-    vecpop::print(numbers);
+    auto const ns_aos_sort = bench::time_ns([&]() {
+      std::sort(aos.begin(), aos.end(), [](President const & lhs, President const & rhs) {
+        return lhs.year < rhs.year;
+      });
+    });
+    auto const ns_soa_sort = bench::time_ns([&]() { soa.sort_by<"year">(); });
+    report("sort by year"s, ns_aos_sort, ns_soa_sort);
 
-    std::cout << '\n';
+    auto const ns_aos_erase = bench::time_ns([&]() {
+      std::erase_if(aos, [](President const & pres) { return pres.year < 1900; });
+    });
+    auto const ns_soa_erase = bench::time_ns([&]() {
+      erase_if(soa, [](presidents::const_reference row) { return row.get<"year">() < 1900; });
+    });
+    assert(aos.size() == soa.size());
+    report("erase_if year"s, ns_aos_erase, ns_soa_erase);
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - resize"s << '\n';
+  std::cout << "vecbit::bit_vector - word kernels vs. std::vector<bool>"s << '\n';
   {
-    auto print_element = [](auto & el) {
-      std::cout << el << ' ';
+    auto const nb = bench::large ? (1ul << 33) : (1ul << 26);
+    auto const bytes = static_cast<double>(nb / 8);
+    std::cout << nb << " bits, kernels: "s << vecbit::kernel::name() << '\n';
+
+    std::vector<bool> sva(nb), svb(nb);
+    vecbit::bit_vector<> bva(nb), bvb(nb);
+    for (auto pos = 0ul; pos < nb; pos += 7) {
+      sva[pos] = true;
+      bva.set(pos);
+    }
+    for (auto pos = 0ul; pos < nb; pos += 5) {
+      svb[pos] = true;
+      bvb.set(pos);
+    }
+
+    auto row = [bytes](char const * op, double ns_std, double ns_bit) {
+      std::cout << std::setw(10) << op << ": std::vector<bool> "s
+                << std::setw(8) << bench::gbps(bytes, ns_std) << " GB/s, bit_vector "s
+                << std::setw(8) << bench::gbps(bytes, ns_bit) << " GB/s\n"s;
     };
-    auto print = [&](auto & container) {
-      std::for_each(container.cbegin(), container.cend(), print_element);
+    std::cout << std::fixed << std::setprecision(2);
+
+    row("flip",
+        bench::time_ns([&]() { sva.flip(); }),
+        bench::time_ns([&]() { bva.flip(); }));
+
+    row("and",
+        bench::time_ns([&]() {
+          for (auto pos = 0ul; pos < nb; ++pos) {
+            sva[pos] = sva[pos] && svb[pos];
+          }
+        }),
+        bench::time_ns([&]() { bva &= bvb; }));
+
+    row("or",
+        bench::time_ns([&]() {
+          for (auto pos = 0ul; pos < nb; ++pos) {
+            sva[pos] = sva[pos] || svb[pos];
+          }
+        }),
+        bench::time_ns([&]() { bva |= bvb; }));
+
+    std::size_t cs {}, cb {};
+    row("popcount",
+        bench::time_ns([&]() { cs = std::count(sva.cbegin(), sva.cend(), true); }),
+        bench::time_ns([&]() { cb = bva.count(); }));
+    assert(cs == cb);
+
+    row("find_next",
+        bench::time_ns([&]() {
+          auto count(0ul);
+          for (auto pos = 0ul; pos < nb; ++pos) {
+            count += svb[pos];
+          }
+          bench::do_not_optimize(count);
+        }),
+        bench::time_ns([&]() {
+          auto count(0ul);
+          for (auto pos = bvb.find_first(); pos != vecbit::bit_vector<>::npos;
+               pos = bvb.find_next(pos)) {
+            ++count;
+          }
+          bench::do_not_optimize(count);
+        }));
+
+    row("fill",
+        bench::time_ns([&]() { std::fill(sva.begin() + 3, sva.end() - 3, true); }),
+        bench::time_ns([&]() { bva.fill(3, nb - 3); }));
+
+    //  the same binary kernel at each instruction set level.
+    auto const words = bva.words();
+    std::vector<vecbit::word> dst(words.begin(), words.end());
+    auto level = [&](char const * name, auto && fn) {
+      auto const ns = bench::time_ns([&]() { fn(dst.data(), words.data(), dst.size()); });
+      std::cout << std::setw(10) << name << ": xor "s
+                << std::setw(8) << bench::gbps(bytes, ns) << " GB/s\n"s;
     };
-
-    std::vector<int> container = { 1, 2, 3, };
-    std::cout << "The vector holds: "s;
-    print(container);
-    std::cout << '\n';
-
-    container.resize(5);
-    std::cout << "After resize up to 5: "s;
-    print(container);
-    std::cout << '\n';
-
-    container.resize(2);
-    std::cout << "After resize down to 2: "s;
-    print(container);
-    std::cout << '\n';
-
-    std::cout << '\n';
+    using vecbit::kernel::bitop;
+    level("portable", vecbit::kernel::portable_binary<bitop::xor_>);
+#if defined(VECBIT_X86)
+#if defined(__SSE2__)
+    level("sse2", vecbit::kernel::sse2_binary<bitop::xor_>);
+#endif  /* defined(__SSE2__) */
+    if (vecbit::kernel::active == vecbit::kernel::isa::avx2) {
+      level("avx2", vecbit::kernel::avx2_binary<bitop::xor_>);
+    }
+#endif  /* defined(VECBIT_X86) */
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - swap"s << '\n';
+  std::cout << "vecbit::atomic_bitset - threads vs. mutex-guarded std::vector<bool>"s << '\n';
   {
-    using namespace vecswp;
+    //  a mark phase: every thread test-and-sets random bits and counts the
+    //  ones it marked first; each thread's sequence is fixed by its index.
+    auto const nb = bench::large ? (1ul << 30) : (1ul << 24);
+    auto const marks = bench::large ? (1ul << 26) : (1ul << 23);
+    auto const hw = std::max(4u, std::thread::hardware_concurrency());
+    std::cout << nb << " bits, "s << marks << " marks, hardware threads: "s
+              << std::thread::hardware_concurrency() << '\n'
+              << std::fixed << std::setprecision(2);
+
+    auto run = [](unsigned threads, auto && work) {
+      std::vector<std::size_t> firsts(threads);
+      std::vector<std::thread> workers;
+      auto const ns = bench::time_ns([&]() {
+        for (auto tx = 0u; tx < threads; ++tx) {
+          workers.emplace_back([&work, &firsts, tx, threads]() {
+            firsts[tx] = work(tx, threads);
+          });
+        }
+        for (auto & th : workers) {
+          th.join();
+        }
+      });
+      return std::pair { ns, std::accumulate(firsts.begin(), firsts.end(), 0ul), };
+    };
+    auto positions = [nb](unsigned tx, auto && fn) {
+      auto state = 0x9e3779b97f4a7c15ull * (tx + 1);
+      return [nb, state, fn]() mutable {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return fn(state & (nb - 1));
+      };
+    };
 
-    std::vector<int> a1{ 1, 2, 3, }, a2{ 4, 5, };
+    for (auto threads = 1u; threads <= hw; threads *= 2) {
+      auto const share = marks / threads;
 
-    auto it1 = std::next(a1.begin());
-    auto it2 = std::next(a2.begin());
+      vecbit::atomic_bitset abs(nb);
+      auto const [ns_atomic, first_atomic] = run(threads, [&](unsigned tx, unsigned) {
+        auto next = positions(tx, [&abs](std::size_t pos) { return !abs.test_and_set(pos); });
+        auto first = 0ul;
+        for (auto mk = 0ul; mk < share; ++mk) {
+          first += next();
+        }
+        return first;
+      });
 
-    int& ref1 = a1.front();
-    int& ref2 = a2.front();
+      std::vector<bool> vb(nb);
+      std::mutex mtx;
+      auto const [ns_mutex, first_mutex] = run(threads, [&](unsigned tx, unsigned) {
+        auto next = positions(tx, [&vb, &mtx](std::size_t pos) {
+          std::lock_guard<std::mutex> lock(mtx);
+          bool const was = vb[pos];
+          vb[pos] = true;
+          return !was;
+        });
+        auto first = 0ul;
+        for (auto mk = 0ul; mk < share; ++mk) {
+          first += next();
+        }
+        return first;
+      });
 
-    std::cout << a1 << a2 << *it1 << ' ' << *it2 << ' ' << ref1 << ' ' << ref2 << '\n';
-    a1.swap(a2);
-    std::cout << a1 << a2 << *it1 << ' ' << *it2 << ' ' << ref1 << ' ' << ref2 << '\n';
+      //  every thread fills its own line-aligned partition.
+      abs.clear(0, nb);
+      auto const [ns_range, filled] = run(threads, [&abs](unsigned tx, unsigned parts) {
+        auto const [lo, hi] = abs.partition(tx, parts);
+        abs.set(lo, hi);
+        return hi - lo;
+      });
 
-    // Note that after swap the iterators and references stay associated with their
-    // original elements, e.g. it1 that pointed to an element in 'a1' with value 2
-    // still points to the same element, though this element was moved into 'a2'.
+      std::size_t counted {};
+      auto const ns_count = bench::time_ns([&]() { counted = abs.count(); });
+      assert(first_atomic == first_mutex && counted == filled && filled == nb);
 
-    std::cout << '\n';
+      std::cout << std::setw(2) << threads << " threads: test_and_set "s
+                << std::setw(8) << share * threads / ns_atomic * 1e3 << " M/s, mutex "s
+                << std::setw(8) << share * threads / ns_mutex * 1e3 << " M/s, range set "s
+                << std::setw(6) << bench::gbps(nb / 8, ns_range) << " GB/s, count "s
+                << std::setw(6) << bench::gbps(nb / 8, ns_count) << " GB/s ("s
+                << first_atomic << " distinct)\n"s;
+    }
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
-  /// Non-member functions
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - std::operator== etc."s << '\n';
+  std::cout << "vecbit::rank_select - rank, select vs. scanning"s << '\n';
   {
-    std::vector<int> alice{1, 2, 3};
-    std::vector<int> bob{7, 8, 9, 10};
-    std::vector<int> eve{1, 2, 3};
-
-    std::cout << std::boolalpha;
+    auto const nb = bench::large ? (1ul << 33) : (1ul << 28);
+    auto constexpr queries(1ul << 20);
+    auto constexpr scans(16ul);
+    std::cout << nb << " bits\n"s << std::fixed << std::setprecision(2);
+
+    for (auto per_mille : { 500ul, 10ul, }) {
+      vecbit::bit_vector<> bits(nb);
+      auto state = 0x9e3779b97f4a7c15ull;
+      auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+      };
+      for (auto pos = 0ul; pos < nb; ++pos) {
+        if (next() % 1000 < per_mille) {
+          bits.set(pos);
+        }
+      }
+      auto const words = bits.words();
 
-    // Compare non equal containers
-    std::cout << "alice == bob returns "s << (alice == bob) << '\n';
-    std::cout << "alice != bob returns "s << (alice != bob) << '\n';
-    std::cout << "alice <  bob returns "s << (alice < bob) << '\n';
-    std::cout << "alice <= bob returns "s << (alice <= bob) << '\n';
-    std::cout << "alice >  bob returns "s << (alice > bob) << '\n';
-    std::cout << "alice >= bob returns "s << (alice >= bob) << '\n';
+      vecbit::rank_select<> rs;
+      auto const ns_build = bench::time_ns([&]() {
+        rs = vecbit::rank_select<>(std::move(bits));
+        rs.build();
+      });
+      auto const ones = rs.count();
 
-    std::cout << '\n';
+      std::vector<std::size_t> at(queries), kth(queries);
+      for (auto qx = 0ul; qx < queries; ++qx) {
+        at[qx] = next() % nb;
+        kth[qx] = next() % ones;
+      }
+      std::size_t sink {};
+      auto const ns_rank = bench::time_ns([&]() {
+        for (auto pos : at) {
+          sink += rs.rank1(pos);
+        }
+      }) / queries;
+      auto const ns_select = bench::time_ns([&]() {
+        for (auto kx : kth) {
+          sink += rs.select1(kx);
+        }
+      }) / queries;
+
+      //  the linear alternatives: popcount the prefix, walk the set bits.
+      auto const & bv = rs.bits();
+      auto const ns_rank_scan = bench::time_ns([&]() {
+        for (auto qx = 0ul; qx < scans; ++qx) {
+          auto const pos = at[qx];
+          auto count = vecbit::kernel::popcount(words.data(), pos / vecbit::word_bits);
+          for (auto bx = pos / vecbit::word_bits * vecbit::word_bits; bx < pos; ++bx) {
+            count += bv.test(bx);
+          }
+          sink += count;
+        }
+      }) / scans;
+      auto const ns_select_scan = bench::time_ns([&]() {
+        for (auto qx = 0ul; qx < scans; ++qx) {
+          auto pos = bv.find_first();
+          for (auto kx = kth[qx]; kx != 0; --kx) {
+            pos = bv.find_next(pos);
+          }
+          sink += pos;
+        }
+      }) / scans;
+      bench::do_not_optimize(sink);
+
+      //  incremental maintenance: appends, single-bit flips.
+      auto constexpr updates(1ul << 16);
+      rs.reserve(rs.size() + updates);
+      auto const ns_push = bench::time_ns([&]() {
+        for (auto ux = 0ul; ux < updates; ++ux) {
+          rs.push_back((next() % 1000) < per_mille);
+          if (ux % 1024 == 0) {
+            sink += rs.rank1(rs.size());
+          }
+        }
+      }) / updates;
+      auto const ns_flip = bench::time_ns([&]() {
+        for (auto ux = 0ul; ux < updates; ++ux) {
+          rs.flip(at[ux]);
+        }
+      }) / updates;
+      auto const ns_flip_rank = bench::time_ns([&]() {
+        for (auto ux = 0ul; ux < updates; ++ux) {
+          rs.flip(at[ux]);
+          sink += rs.rank1(at[ux + updates]);
+        }
+      }) / updates;
+      //  fold the pending changes into the entries, resample.
+      auto const ns_fold = bench::time_ns([&]() { rs.build(); });
+      bench::do_not_optimize(sink);
+
+      std::cout << std::setw(5) << per_mille / 10.0 << "% ones: build "s
+                << std::setw(7) << bench::gbps(nb / 8, ns_build) << " GB/s, index "s
+                << 100.0 * rs.index_bytes() / (nb / 8) << "%\n"s
+                << "  rank1  "s << std::setw(8) << ns_rank << " ns (scan "s
+                << std::setw(12) << ns_rank_scan << " ns), select1 "s
+                << std::setw(8) << ns_select << " ns (scan "s
+                << std::setw(14) << ns_select_scan << " ns)\n"s
+                << "  push_back "s << ns_push << " ns, flip(pos) "s << ns_flip
+                << " ns, flip(pos) + rank1 "s << ns_flip_rank << " ns, build after "s
+                << 2 * updates << " flips "s << ns_fold / 1e6 << " ms\n"s;
+    }
+    std::cout << std::defaultfloat;
+  }
+  std::cout << std::endl; //  make sure cout is flushed.
 
-    // Compare equal containers
-    std::cout << "alice == eve returns "s << (alice == eve) << '\n';
-    std::cout << "alice != eve returns "s << (alice != eve) << '\n';
-    std::cout << "alice <  eve returns "s << (alice < eve) << '\n';
-    std::cout << "alice <= eve returns "s << (alice <= eve) << '\n';
-    std::cout << "alice >  eve returns "s << (alice > eve) << '\n';
-    std::cout << "alice >= eve returns "s << (alice >= eve) << '\n';
+  // ....+....!....+....!....+....!....+....!....+....!....+....!
+  std::cout << konst::dot << '\n';
+  std::cout << "vecbit::roaring - memory and throughput vs. std::vector<bool> by density"s << '\n';
+  {
+    auto const nb = bench::large ? (1ul << 30) : (1ul << 26);
+    auto constexpr probes(1ul << 20);
+    std::cout << nb << " bits; times in ns per bit (build, and/or/xor, iterate) or per probe (test)\n"s
+              << std::fixed << std::setprecision(2);
+
+    auto state = 0x9e3779b97f4a7c15ull;
+    auto next = [&state]() {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      return state;
+    };
+    //  per_million ones at random, or (0) runs of about 1000 ones and zeros.
+    auto pattern = [&next](std::size_t per_million) {
+      return [&next, per_million, on = false]() mutable {
+        if (per_million != 0) {
+          return next() % 1000000 < per_million;
+        }
+        if (next() % 1000 == 0) {
+          on = !on;
+        }
+        return on;
+      };
+    };
 
-#if (__cplusplus > 201707L)
-    //`TODO:  add spaceship operator tests
-    auto eq = std::is_eq(alice <=> eve);
-    auto ne = std::is_neq(alice <=> eve);
-    auto lt = std::is_lt(alice <=> eve);
-    auto le = std::is_lteq(alice <=> eve);
-    auto le = std::is_gt(alice <=> eve);
-    auto le = std::is_gteq(alice <=> eve);
-#endif  /* (__cplusplus > 201707L) */
+    for (auto per_million : { 10ul, 1000ul, 10000ul, 100000ul, 500000ul, 0ul, }) {
+      std::vector<bool> va, vb;
+      vecbit::roaring ra, rb;
+      auto const seed = state;
+      auto const ns_vb_build = bench::time_ns([&, bit = pattern(per_million)]() mutable {
+        for (auto pos = 0ul; pos < nb; ++pos) {
+          va.push_back(bit());
+        }
+      }) / nb;
+      state = seed;   //  the same bits again
+      auto const ns_rb_build = bench::time_ns([&, bit = pattern(per_million)]() mutable {
+        for (auto pos = 0ul; pos < nb; ++pos) {
+          ra.push_back(bit());
+        }
+      }) / nb;
+      auto bit = pattern(per_million);
+      for (auto pos = 0ul; pos < nb; ++pos) {
+        auto const val = bit();
+        vb.push_back(val);
+        rb.push_back(val);
+      }
 
-    std::cout << '\n';
+      std::vector<std::size_t> at(probes);
+      for (auto & pos : at) {
+        pos = next() % nb;
+      }
+      std::size_t sink {};
+      auto const ns_vb_test = bench::time_ns([&]() {
+        for (auto pos : at) {
+          sink += va[pos];
+        }
+      }) / probes;
+      auto const ns_rb_test = bench::time_ns([&]() {
+        for (auto pos : at) {
+          sink += ra.test(pos);
+        }
+      }) / probes;
+
+      //  std::vector<bool> has no bulk operations: loop over the bits.
+      std::vector<bool> vr(nb);
+      auto vb_op = [&](auto op) {
+        return bench::time_ns([&]() {
+          for (auto pos = 0ul; pos < nb; ++pos) {
+            vr[pos] = op(va[pos], vb[pos]);
+          }
+          sink += vr[nb / 2];
+        }) / nb;
+      };
+      auto rb_op = [&](auto op) {
+        return bench::time_ns([&]() {
+          sink += op(ra, rb).count();
+        }) / nb;
+      };
+      double const ns_vb_ops[] = {
+        vb_op([](bool lhs, bool rhs) { return lhs && rhs; }),
+        vb_op([](bool lhs, bool rhs) { return lhs || rhs; }),
+        vb_op([](bool lhs, bool rhs) { return lhs != rhs; }),
+      };
+      double const ns_rb_ops[] = {
+        rb_op([](auto const & lhs, auto const & rhs) { return lhs & rhs; }),
+        rb_op([](auto const & lhs, auto const & rhs) { return lhs | rhs; }),
+        rb_op([](auto const & lhs, auto const & rhs) { return lhs ^ rhs; }),
+      };
+
+      auto const ns_vb_iter = bench::time_ns([&]() {
+        for (auto pos = 0ul; pos < nb; ++pos) {
+          if (va[pos]) {
+            sink += pos;
+          }
+        }
+      }) / nb;
+      auto const ns_rb_iter = bench::time_ns([&]() {
+        ra.for_each([&sink](std::size_t pos) { sink += pos; });
+      }) / nb;
+      bench::do_not_optimize(sink);
+
+      auto const us = ra.footprint();
+      auto const ones = ra.count();
+      if (per_million != 0) {
+        std::cout << std::setprecision(3) << std::setw(7) << per_million / 10000.0
+                  << "% ones"s << std::setprecision(2);
+      }
+      else {
+        std::cout << "   runs ~1000"s;
+      }
+      std::cout << ": memory vector<bool> "s << std::setw(10) << va.capacity() / 8
+                << " B, roaring "s << std::setw(10) << us.bytes << " B ("s
+                << std::setw(6) << 8.0 * us.bytes / std::max(ones, 1ul) << " bits/one; "s
+                << us.arrays << '/' << us.bitmaps << '/' << us.runs << " array/bitmap/run), serialized "s
+                << ra.serialize().size() << " B\n"s
+                << "               build "s << ns_vb_build << " / "s << ns_rb_build
+                << ", test "s << ns_vb_test << " / "s << ns_rb_test
+                << ", and "s << ns_vb_ops[0] << " / "s << std::setprecision(4) << ns_rb_ops[0]
+                << ", or "s << std::setprecision(2) << ns_vb_ops[1] << " / "s << std::setprecision(4) << ns_rb_ops[1]
+                << ", xor "s << std::setprecision(2) << ns_vb_ops[2] << " / "s << std::setprecision(4) << ns_rb_ops[2]
+                << ", iterate "s << std::setprecision(2) << ns_vb_iter << " / "s << std::setprecision(4) << ns_rb_iter
+                << std::setprecision(2) << "  (vector<bool> / roaring)\n"s;
+    }
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
-  /// Non-member functions
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - std::swap"s << '\n';
+  std::cout << "vecbit::bit_vector - hash, unordered_set dedupe"s << '\n';
   {
-    std::vector<int> alice{ 1, 2, 3, };
-    std::vector<int> bob{ 7, 8, 9, 10, };
-
-    auto print = [](const int & n) {
-      std::cout << ' ' << n;
+    //  random bit vectors of 8 to 4096 bits, a quarter of them duplicates.
+    auto const count = bench::large ? 1'000'000ul : 200'000ul;
+    std::vector<std::vector<bool>> keys_std;
+    std::vector<vecbit::bit_vector<>> keys_bit;
+    keys_std.reserve(count);
+    keys_bit.reserve(count);
+    auto seed = std::uint64_t { 0x2545f4914f6cdd1dull };
+    auto next = [&seed]() {
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      return seed;
     };
+    auto bit_bytes(0.0);
+    for (auto kx = 0ul; kx < count; ++kx) {
+      if (kx % 4 == 3) {
+        auto const dup = next() % kx;
+        keys_std.push_back(keys_std[dup]);
+        keys_bit.push_back(keys_bit[dup]);
+        continue;
+      }
+      auto const nb = 8 + next() % (4096 - 8 + 1);
+      std::vector<bool> sv(nb);
+      vecbit::bit_vector<> bv(nb);
+      for (auto pos = 0ul; pos < nb; pos += 64) {
+        auto wd = next();
+        for (auto bx = pos; bx < std::min(nb, pos + 64); ++bx, wd >>= 1) {
+          sv[bx] = wd & 1;
+          bv.set(bx, wd & 1);
+        }
+      }
+      bit_bytes += static_cast<double>(bv.words().size_bytes());
+      keys_std.push_back(std::move(sv));
+      keys_bit.push_back(std::move(bv));
+    }
 
-    // Print state before swap
-    std::cout << "alice:"s;
-    std::for_each(alice.begin(), alice.end(), print);
-    std::cout << "\n" "bob  :"s;
-    std::for_each(bob.begin(), bob.end(), print);
-    std::cout << '\n';
+    std::cout << count << " keys\n"s << std::fixed << std::setprecision(2);
 
-    std::cout << "-- SWAP\n"s;
-    std::swap(alice, bob);
+    auto const hs_std = bench::time_ns([&]() {
+      auto acc = std::size_t { 0 };
+      for (auto const & key : keys_std) {
+        acc ^= std::hash<std::vector<bool>>{}(key);
+      }
+      bench::do_not_optimize(acc);
+    });
+    auto const hs_bit = bench::time_ns([&]() {
+      auto acc = std::size_t { 0 };
+      for (auto const & key : keys_bit) {
+        acc ^= vecbit::kernel::hash(key.words().data(), key.words().size(), key.size());
+      }
+      bench::do_not_optimize(acc);
+    });
+    std::cout << "hash, std::hash<std::vector<bool>>: "s
+              << std::setw(8) << bench::gbps(bit_bytes, hs_std) << " GB/s\n"s
+              << "hash, vecbit::kernel::hash ("s << vecbit::kernel::name() << "): "s
+              << std::setw(8) << bench::gbps(bit_bytes, hs_bit) << " GB/s\n"s;
 
-    // Print state after swap
-    std::cout << "alice:"s;
-    std::for_each(alice.begin(), alice.end(), print);
-    std::cout << "\n" "bob  :"s;
-    std::for_each(bob.begin(), bob.end(), print);
-    std::cout << '\n';
+    //  the keys above are scattered over tens of MB, so both hashes mostly
+    //  wait on memory; one long key that stays in cache times the kernels.
+    {
+      auto constexpr nb(1ul << 20);
+      auto constexpr reps(256);
+      std::vector<bool> sv(nb);
+      vecbit::bit_vector<> bv(nb);
+      for (auto pos = 0ul; pos < nb; ++pos) {
+        auto const bit = (next() & 1) != 0;
+        sv[pos] = bit;
+        bv.set(pos, bit);
+      }
+      auto const ls_std = bench::time_ns([&]() {
+        auto acc = std::size_t { 0 };
+        for (auto rp = 0; rp < reps; ++rp) {
+          acc ^= std::hash<std::vector<bool>>{}(sv);
+        }
+        bench::do_not_optimize(acc);
+      });
+      auto const ls_bit = bench::time_ns([&]() {
+        auto acc = std::size_t { 0 };
+        for (auto rp = 0; rp < reps; ++rp) {
+          acc ^= vecbit::kernel::hash(bv.words().data(), bv.words().size(), bv.size());
+        }
+        bench::do_not_optimize(acc);
+      });
+      auto const bytes = static_cast<double>(reps * bv.words().size_bytes());
+      std::cout << "hash, one 1 Mbit key in cache: std::hash "s
+                << std::setw(6) << bench::gbps(bytes, ls_std) << " GB/s, vecbit::kernel::hash "s
+                << std::setw(6) << bench::gbps(bytes, ls_bit) << " GB/s\n"s;
+    }
 
-    std::cout << '\n';
+    auto dedupe = [&](auto const & keys) {
+      using key_type = typename std::decay_t<decltype(keys)>::value_type;
+      std::unordered_set<key_type> set;
+      auto const ins = bench::time_ns([&]() {
+        for (auto const & key : keys) {
+          set.insert(key);
+        }
+      });
+      auto found(0ul);
+      auto const lkp = bench::time_ns([&]() {
+        for (auto const & key : keys) {
+          found += set.count(key);
+        }
+      });
+      assert(found == keys.size());
+      std::cout << "unique: "s << set.size()
+                << ", insert: "s << ins / keys.size() << " ns/key"s
+                << ", lookup: "s << lkp / keys.size() << " ns/key\n"s;
+    };
+    std::cout << "std::unordered_set<std::vector<bool>>:  "s;
+    dedupe(keys_std);
+    std::cout << "std::unordered_set<vecbit::bit_vector>: "s;
+    dedupe(keys_bit);
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
-  /// Non-member functions
   // ....+....!....+....!....+....!....+....!....+....!....+....!
   std::cout << konst::dot << '\n';
-  std::cout << "std::vector - std::erase, std::erase_if"s << '\n';
+  std::cout << "vecflat::flat_set - vs. std::unordered_set"s << '\n';
   {
-    auto print_container = [](std::string_view comment,
-                              std::vector<char> const & ctr) {
-      std::cout << comment;
-      for (auto xv : ctr) {
-        std::cout << xv << ' ';
-      }
-      std::cout << '\n';
+    auto const count = bench::large ? 10'000'000ul : 1'000'000ul;
+    auto seed = std::uint64_t { 0x9e3779b97f4a7c15ull };
+    auto next = [&seed]() {
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      return seed;
     };
 
-    std::vector<char> cnt(10);
-    std::iota(cnt.begin(), cnt.end(), '0');
-    print_container("Init:\n"s, cnt);
-
-    std::erase(cnt, '3');
-    print_container("Erase '3':\n"s, cnt);
-
-#if (__cplusplus > 201707L)
-    auto erased = std::erase_if(cnt, [](char x_) {
-      return (x_ - '0') % 2 == 0;
-    });
-
-    print_container("Erase all even numbers:\n"s, cnt);
-    std::cout << "In all "s << erased << " even numbers were erased.\n"s;
-#else
-    int erased = 0;
-    std::erase_if(cnt, [&erased](char x_) {
-      auto ok = (x_ - '0') % 2 == 0;
-      if (ok) {
-        ++erased;
-      }
-      return ok;
-    });
+    //  keys in [0, count) are inserted, keys in [count, 2 * count) miss.
+    auto run = [count](char const * name, auto set, auto const & keys) {
+      auto const ins = bench::time_ns([&]() {
+        for (auto kx = 0ul; kx < count; ++kx) {
+          set.insert(keys[kx]);
+        }
+      });
+      auto found(0ul);
+      auto const hit = bench::time_ns([&]() {
+        for (auto kx = 0ul; kx < count; ++kx) {
+          found += set.count(keys[kx]);
+        }
+      });
+      auto const miss = bench::time_ns([&]() {
+        for (auto kx = count; kx < 2 * count; ++kx) {
+          found += set.count(keys[kx]);
+        }
+      });
+      auto const ers = bench::time_ns([&]() {
+        for (auto kx = 0ul; kx < count; ++kx) {
+          set.erase(keys[kx]);
+        }
+      });
+      assert(found == count && set.empty());
+      std::cout << std::setw(40) << name
+                << ": insert "s << std::setw(7) << ins / count
+                << ", hit "s << std::setw(7) << hit / count
+                << ", miss "s << std::setw(7) << miss / count
+                << ", erase "s << std::setw(7) << ers / count << " ns/op\n"s;
+    };
 
-    print_container("Erase all even numbers:\n"s, cnt);
-    std::cout << "In all "s << erased << " even numbers were erased.\n"s;
-#endif  /* (__cplusplus > 201707L) */
+    std::vector<std::uint64_t> ints(2 * count);
+    for (auto & key : ints) {
+      key = next();
+    }
+    std::vector<vecbit::bit_vector<>> bvs;
+    bvs.reserve(2 * count);
+    for (auto const key : ints) {
+      vecbit::bit_vector<> bv(128);
+      for (auto bx = 0ul; bx < 64; ++bx) {
+        bv.set(bx, (key >> bx) & 1);
+        bv.set(127 - bx, (key >> bx) & 1);
+      }
+      bvs.push_back(std::move(bv));
+    }
 
-    std::cout << '\n';
+    std::cout << count << " keys\n"s << std::fixed << std::setprecision(1);
+    run("std::unordered_set<uint64_t>",
+        std::unordered_set<std::uint64_t>(), ints);
+    run("vecflat::flat_set<uint64_t>",
+        vecflat::flat_set<std::uint64_t>(), ints);
+    run("std::unordered_set<bit_vector>",
+        std::unordered_set<vecbit::bit_vector<>>(), bvs);
+    run("vecflat::flat_set<bit_vector>",
+        vecflat::flat_set<vecbit::bit_vector<>, vecbit::bit_hash, vecbit::bit_equal>(), bvs);
+    std::cout << std::defaultfloat;
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
   return 0;
 }
 
-//  MARK: - C_vector_bool
+//  MARK: - C_vector_suite
 //  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
 //  ================================================================================
 //  ....+....!....+....!....+....!....+....!....+....!....+....!....+....!....+....!
+//  MARK: namespace bench::suite
 /*
- *  MARK: C_vector_bool()
- *  std::vector<bool> is a possibly space-efficient specialization of
- *  std::vector for the type bool.
+ *  A Google-Benchmark-style suite: one parameterised benchmark per operation
+ *  the C_vector / C_vector_bool sections demonstrate, run over element types
+ *  (int, double, std::string; bool for flip and hash), allocators
+ *  (std::allocator, valc::Mallocator, vecrsv::NAlloc) and sizes 1, 10, ...
+ *  10^6 (10^8 with --bench-large; vectors over 1 GiB are skipped).
  *
- *  The manner in which std::vector<bool> is made space efficient (as well as whether
- *  it is optimized at all) is implementation defined. One potential optimization
- *  involves coalescing vector elements such that each element occupies a single bit
- *  instead of sizeof(bool) bytes.
- *
- *  std::vector<bool> behaves similarly to std::vector, but in order to be space
- *  efficient, it:
- *
- *  + Does not necessarily store its elements as a contiguous array.
- *
- *  + Exposes class std::vector<bool>::reference as a method of accessing individual
- *    bits. In particular, objects of this class are returned by operator[] by value.
+ *  Each benchmark drives a state loop, while (st.keep_running()) { ... },
+ *  which runs in doubling batches until the minimum time has passed and
+ *  reads the clock only between batches.  Work between st.pause() and
+ *  st.resume() is neither timed nor counted.  An "op" is one call for
+ *  construct, assign, insert, emplace, erase, resize and swap, and one
+ *  element (or bit) for the others.  Allocations and bytes are those of
+ *  the vector's own allocator, counted by the bench::suite::counted wrapper.
  *
- *  + Does not use std::allocator_traits::construct to construct bit values.
+ *  The JSON follows Google Benchmark's meanings: real_time and cpu_time
+ *  are per iteration of the state loop (wall clock and process CPU time,
+ *  from std::clock), items_per_second counts ops against CPU time, and
+ *  ns_per_op, bytes_per_op and allocs_per_op are user counters.  Each
+ *  st.pause() / st.resume() pair adds its two std::clock calls (system
+ *  calls, about 0.2 us each here) to cpu_time but not to real_time, so
+ *  small erase_if runs show cpu_time above real_time.  With
+ *  --bench-json=- main() sends everything else to stderr, so stdout holds
+ *  the JSON alone.
  *
- *  + Does not guarantee that different elements in the same container can be modified
- *    concurrently by different threads.
+ *  --bench-suite                run the suite
+ *  --bench-filter=<text>        only benchmarks whose name contains text
+ *  --bench-min-time=<ms>        minimum time per benchmark (default 10)
+ *  --bench-json=<file>          also write Google Benchmark JSON ("-": stdout)
  */
-int C_vector_bool(int argc, const char * argv[]) {
-  std::cout << "In "s << __func__ << std::endl;
+namespace bench::suite {
 
-  // ....+....!....+....!....+....!....+....!....+....!....+....!
-  std::cout << konst::dot << '\n';
-  std::cout << "std::vector<bool> - constructor, custom allocator"s << '\n';
-  {
-    auto constexpr cc_max(10ul);
-    auto cc(0UL);
-    auto prtboolean = [&cc](auto bl) {
-      std::cout << std::boolalpha << std::setw(6) << bl << std::noboolalpha
-                << (++cc % cc_max == 0 ? "\n"s : ""s);
-    };
+//  the suite runs on one thread.
+inline std::uint64_t allocations = 0;
+inline std::uint64_t allocated_bytes = 0;
 
-    std::vector<bool, valc::Mallocator<bool>> vbl;
-    std::cout << "initial size: "s << std::setw(4) << vbl.size()
-              << ", capacity: "s << std::setw(6) << vbl.capacity()
-              << '\n';
+template <class Alloc>
+struct counted : Alloc {
+  using value_type = typename Alloc::value_type;
+  using is_always_equal = typename std::allocator_traits<Alloc>::is_always_equal;
 
-    if (!vbl.empty()) {
-      cc = 0ul;
-      std::for_each(vbl.cbegin(), vbl.cend(), prtboolean);
-      std::cout << '\n';
-    }
-    std::cout << "add a value.\n"s;
-    vbl.push_back(true);
-    std::cout << "add a value.\n"s;
-    vbl.push_back(false);
+  template <class U>
+  struct rebind {
+    using other = counted<typename std::allocator_traits<Alloc>::template rebind_alloc<U>>;
+  };
+
+  counted() = default;
+  template <class Other>
+  counted(counted<Other> const & other) noexcept : Alloc(static_cast<Other const &>(other)) {}
+
+  value_type * allocate(std::size_t nv) {
+    ++allocations;
+    allocated_bytes += nv * sizeof(value_type);
+    return Alloc::allocate(nv);
+  }
 
-    bool samples[] = {
-      true, false, false, false, true,  true, false,  true, true, true,
-      true,  true, false, true, false, false, false, false, true, true, };
-    std::cout << "adding:\n"s;
-    for (auto nr : samples) {
-      std::cout << ' ' << std::boolalpha << nr;
-      vbl.push_back(nr);
-    }
-    std::cout << std::noboolalpha << '\n';
+  void deallocate(value_type * pv, std::size_t nv) {
+    Alloc::deallocate(pv, nv);
+  }
+};
 
-    std::cout << "add a value.\n"s;
-    vbl.push_back(true);
-    std::cout << "add a value.\n"s;
-    vbl.push_back(false);
-    auto constexpr rn(100ul);
-    std::cout << "reserve "s << rn << " more.\n"s;
-    vbl.reserve(rn);
+//  the wrapped allocators are stateless; don't call their (chatty) operator==.
+template <class A1, class A2>
+bool operator==(counted<A1> const &, counted<A2> const &) noexcept {
+  return true;
+}
 
-//      std::cout << vbl.data() << '\n';
-    std::cout << "new size: "s << std::setw(4) << vbl.size()
-              << ", capacity: "s << std::setw(6) << vbl.capacity()
-              << '\n';
-    cc = 0ul;
-    if (!vbl.empty()) {
-      std::for_each(vbl.cbegin(), vbl.cend(), prtboolean);
+class state {
+public:
+  state(std::size_t size, double min_ns) : size(size), min_ns_(min_ns) {}
+
+  bool keep_running() {
+    if (remaining_ != 0) {
+      --remaining_;
+      ++iterations_;
+      return true;
     }
-    std::cout << '\n';
+    if (started_) {
+      pause();
+      if (ns_ >= min_ns_) {
+        return false;
+      }
+      batch_ *= 2;
+    }
+    started_ = true;
+    remaining_ = batch_ - 1;
+    ++iterations_;
+    resume();
+    return true;
   }
-  std::cout << std::endl; //  make sure cout is flushed.
 
-  // ....+....!....+....!....+....!....+....!....+....!....+....!
-  std::cout << konst::dot << '\n';
-  std::cout << "std::vector<bool> - get_allocator"s << '\n';
-  {
-    std::vector<bool> vb1(8);
-    std::vector<bool, valc::Mallocator<bool>> vb2(8);
-    std::vector<bool, valc::Mallocator<bool>> vb3(8);
-    std::vector<uint8_t, valc::Mallocator<uint8_t>> vb4(8);
+  //  the wall clock is read inside the CPU clock, so it doesn't pay for std::clock.
+  void pause() {
+    ns_ += std::chrono::duration<double, std::nano>(clock::now() - t0_).count();
+    cpu_ns_ += double(std::clock() - c0_) * 1e9 / CLOCKS_PER_SEC;
+    allocations_ += allocations - allocations0_;
+    bytes_ += allocated_bytes - bytes0_;
+  }
 
-    [[maybe_unused]]
-    auto vb1_al = vb1.get_allocator();
-    auto vb2_al = vb2.get_allocator();
-    auto vb3_al = vb3.get_allocator();
-    auto vb4_al = vb4.get_allocator();
+  void resume() {
+    allocations0_ = allocations;
+    bytes0_ = allocated_bytes;
+    c0_ = std::clock();
+    t0_ = clock::now();
+  }
 
-    std::cout << std::boolalpha;
-    auto vb2_al_eq_vb2_al  = vb2_al == vb2_al;
-    auto vb2_al_neq_vb2_al = vb2_al != vb2_al;
-    std::cout << "vb2_al == vb2_al: "s << vb2_al_eq_vb2_al  << '\n';
-    std::cout << "vb2_al != vb2_al: "s << vb2_al_neq_vb2_al << '\n';
+  //  elements (or bits) processed per iteration; 1 unless set.
+  void set_ops(std::size_t ops) noexcept { ops_ = ops; }
 
-    auto vb2_al_eq_vb3_al  = vb2_al == vb3_al;
-    auto vb2_al_neq_vb3_al = vb2_al != vb3_al;
-    std::cout << "vb2_al == vb3_al: "s << vb2_al_eq_vb3_al  << '\n';
-    std::cout << "vb2_al != vb3_al: "s << vb2_al_neq_vb3_al << '\n';
+  double ops() const noexcept { return double(iterations_) * ops_; }
+  std::uint64_t iterations() const noexcept { return iterations_; }
+  double ns() const noexcept { return ns_; }
+  double cpu_ns() const noexcept { return cpu_ns_; }
+  std::uint64_t allocations_made() const noexcept { return allocations_; }
+  std::uint64_t bytes_allocated() const noexcept { return bytes_; }
 
-    auto vb2_al_eq_vb4_al  = vb2_al == vb4_al;
-    auto vb2_al_neq_vb4_al = vb2_al != vb4_al;
-    std::cout << "vb2_al == vb4_al: "s << vb2_al_eq_vb4_al  << '\n';
-    std::cout << "vb2_al != vb4_al: "s << vb2_al_neq_vb4_al << '\n';
-    std::cout << std::noboolalpha;
+  std::size_t const size;
+
+private:
+  double min_ns_;
+  bool started_ { false };
+  std::uint64_t batch_ { 1 };
+  std::uint64_t remaining_ { 0 };
+  std::uint64_t iterations_ { 0 };
+  std::size_t ops_ { 1 };
+  double ns_ { 0.0 };
+  double cpu_ns_ { 0.0 };
+  std::uint64_t allocations_ { 0 };
+  std::uint64_t bytes_ { 0 };
+  std::uint64_t allocations0_ { 0 };
+  std::uint64_t bytes0_ { 0 };
+  clock::time_point t0_ {};
+  std::clock_t c0_ {};
+};
+
+template <class T>
+T value(std::size_t nv) {
+  if constexpr (std::is_same_v<T, std::string>) {
+    return std::to_string(nv);
   }
-  std::cout << std::endl; //  make sure cout is flushed.
+  else if constexpr (std::is_same_v<T, bool>) {
+    return (nv & 1) != 0;
+  }
+  else {
+    return static_cast<T>(nv);
+  }
+}
 
-  // ....+....!....+....!....+....!....+....!....+....!....+....!
-  std::cout << konst::dot << '\n';
-  std::cout << "std::vector<bool> - flip"s << '\n';
-  {
-    auto print = [](const std::vector<bool> & vb) {
-      for (bool const b_ : vb) {
-          std::cout << b_;
-      }
-      std::cout << '\n';
-    };
+template <class V>
+V filled(std::size_t nv) {
+  V vec;
+  vec.reserve(nv);
+  for (auto ix = 0ul; ix < nv; ++ix) {
+    vec.push_back(value<typename V::value_type>(ix));
+  }
+  return vec;
+}
 
-    std::cout << std::noboolalpha;
-    std::vector<bool> vbool { 0, 1, 0, 1, };
-    print(vbool);
-    vbool.flip();
-    print(vbool);
+//  ....+....!....+....!....+....!....+....!....+....!....+....!
+template <class V>
+void construct(state & st) {
+  while (st.keep_running()) {
+    V vec(st.size);
+    do_not_optimize(vec.data());
   }
-  std::cout << std::endl; //  make sure cout is flushed.
+}
 
-  // ....+....!....+....!....+....!....+....!....+....!....+....!
-  std::cout << konst::dot << '\n';
-  std::cout << "std::vector<bool> - swap"s << '\n';
-  {
-    auto pv = [](auto el) {
-      std::cout << std::setw(3) << el;
-    };
-    std::vector<bool> vb1{ 1, 0, };
+template <class V>
+void assign(state & st) {
+  auto const src = filled<V>(st.size);
+  V vec;
+  while (st.keep_running()) {
+    vec.assign(src.begin(), src.end());
+    do_not_optimize(vec.data());
+  }
+}
 
-    std::cout << std::noboolalpha;
-    std::for_each(vb1.cbegin(), vb1.cend(), pv);
-    std::cout << '\n';
+template <class V>
+void at(state & st) {
+  auto const vec = filled<V>(st.size);
+  st.set_ops(st.size);
+  while (st.keep_running()) {
+    for (auto ix = 0ul; ix < st.size; ++ix) {
+      do_not_optimize(vec.at(ix));
+    }
+  }
+}
 
-    vb1.swap(vb1[0], vb1[1]);
-    std::for_each(vb1.cbegin(), vb1.cend(), pv);
-    std::cout << '\n';
+template <class V>
+void subscript(state & st) {
+  auto const vec = filled<V>(st.size);
+  st.set_ops(st.size);
+  while (st.keep_running()) {
+    for (auto ix = 0ul; ix < st.size; ++ix) {
+      do_not_optimize(vec[ix]);
+    }
   }
-  std::cout << std::endl; //  make sure cout is flushed.
+}
 
-  // ....+....!....+....!....+....!....+....!....+....!....+....!
-  std::cout << konst::dot << '\n';
-  std::cout << "std::vector<bool> - std::hash"s << '\n';
-  {
-//    using vb = std::vector<bool>;
+//  insert / emplace / erase in the middle; the size stays at st.size.
+template <class V>
+void insert(state & st) {
+  auto vec = filled<V>(st.size);
+  auto const val = value<typename V::value_type>(7);
+  while (st.keep_running()) {
+    vec.insert(vec.begin() + vec.size() / 2, val);
+    vec.pop_back();
+  }
+  do_not_optimize(vec.data());
+}
 
-    auto to_vector_bool = [](unsigned nr) -> std::vector<bool> {
-      std::vector<bool> vec;
-      do {
-          vec.push_back(nr & 1);
-          nr >>= 1;
-      } while (nr);
+template <class V>
+void emplace(state & st) {
+  auto vec = filled<V>(st.size);
+  while (st.keep_running()) {
+    vec.emplace(vec.begin() + vec.size() / 2, value<typename V::value_type>(7));
+    vec.pop_back();
+  }
+  do_not_optimize(vec.data());
+}
 
-      return vec;
-    };
+template <class V>
+void erase(state & st) {
+  auto vec = filled<V>(st.size);
+  auto const val = value<typename V::value_type>(7);
+  while (st.keep_running()) {
+    vec.erase(vec.begin() + vec.size() / 2);
+    vec.push_back(val);
+  }
+  do_not_optimize(vec.data());
+}
 
-    auto print = [](const std::vector<bool> & vec, bool new_line = true) {
-      for (std::cout << "{ "s; bool const el : vec) {
-        std::cout << el << ' ';
-      }
-      std::cout << '}' << (new_line ? '\n' : ' ');
-    };
+template <class V>
+void push_back(state & st) {
+  auto const val = value<typename V::value_type>(7);
+  st.set_ops(st.size);
+  while (st.keep_running()) {
+    V vec;
+    for (auto ix = 0ul; ix < st.size; ++ix) {
+      vec.push_back(val);
+    }
+    do_not_optimize(vec.data());
+  }
+}
 
-    for (auto i{0U}; i != 8; ++i) {
-      std::cout << std::hex << std::uppercase;
-      std::vector<bool> vec = to_vector_bool(i);
-      std::cout << std::hash<std::vector<bool>>{}(vec) << ' ' << std::dec;
-      print(vec);
+template <class V>
+void emplace_back(state & st) {
+  st.set_ops(st.size);
+  while (st.keep_running()) {
+    V vec;
+    for (auto ix = 0ul; ix < st.size; ++ix) {
+      vec.emplace_back(value<typename V::value_type>(7));
     }
+    do_not_optimize(vec.data());
+  }
+}
 
-    // std::hash for vector<bool> makes it possible to keep them in
-    // unordered_* associative containers, such as unordered_set.
+//  grow from empty, then shrink to half.
+template <class V>
+void resize(state & st) {
+  while (st.keep_running()) {
+    V vec;
+    vec.resize(st.size);
+    vec.resize(st.size / 2);
+    do_not_optimize(vec.data());
+  }
+}
 
-    std::unordered_set vec {
-      std::vector<bool> { 0 }, std::vector<bool> { 0, 0 }, std::vector<bool> { 1 },
-      std::vector<bool> { 1 }, std::vector<bool> { 1, 0 }, std::vector<bool> { 1, 1 } };
+template <class V>
+void swap(state & st) {
+  auto lhs = filled<V>(st.size);
+  auto rhs = filled<V>(st.size / 2);
+  while (st.keep_running()) {
+    lhs.swap(rhs);
+    do_not_optimize(lhs.data());
+  }
+}
 
-    for (std::vector<bool> const & el : vec) {
-      print(el, 0);
+template <class V>
+void erase_if(state & st) {
+  auto const src = filled<V>(st.size);
+  auto const mid = value<typename V::value_type>(st.size / 2);
+  V vec;
+  vec.reserve(st.size);
+  st.set_ops(st.size);
+  while (st.keep_running()) {
+    st.pause();
+    vec.assign(src.begin(), src.end());
+    st.resume();
+    std::erase_if(vec, [&mid](auto const & el) { return el < mid; });
+    do_not_optimize(vec.data());
+  }
+}
+
+template <class V>
+void flip(state & st) {
+  auto vec = filled<V>(st.size);
+  st.set_ops(st.size);
+  while (st.keep_running()) {
+    vec.flip();
+    do_not_optimize(vec.begin());
+  }
+}
+
+template <class V>
+void hash(state & st) {
+  auto const vec = filled<V>(st.size);
+  st.set_ops(st.size);
+  while (st.keep_running()) {
+    do_not_optimize(std::hash<V>{}(vec));
+  }
+}
+
+//  ....+....!....+....!....+....!....+....!....+....!....+....!
+struct benchmark {
+  std::string name;                     //  op<type, allocator>
+  std::size_t element_size;
+  void (* run)(state &);
+};
+
+struct result {
+  std::string name;                     //  op<type, allocator>/size
+  std::uint64_t iterations;
+  double ops;
+  double real_ns;                       //  per iteration
+  double cpu_ns;                        //  per iteration
+  double ns_per_op;
+  double bytes_per_op;
+  double allocs_per_op;
+};
+
+template <template <class> class Alloc, class T>
+void add_vector(std::vector<benchmark> & bms, std::string_view type, std::string_view alloc) {
+  using V = std::vector<T, counted<Alloc<T>>>;
+  auto const tail = "<"s + std::string(type) + ", "s + std::string(alloc) + ">"s;
+  auto add = [&](char const * name, void (* run)(state &)) {
+    bms.push_back({ name + tail, sizeof(T), run, });
+  };
+  add("construct", &construct<V>);
+  add("assign", &assign<V>);
+  add("at", &at<V>);
+  add("operator[]", &subscript<V>);
+  add("insert", &insert<V>);
+  add("emplace", &emplace<V>);
+  add("erase", &erase<V>);
+  add("push_back", &push_back<V>);
+  add("emplace_back", &emplace_back<V>);
+  add("resize", &resize<V>);
+  add("swap", &swap<V>);
+  add("erase_if", &erase_if<V>);
+}
+
+template <template <class> class Alloc>
+void add_bool(std::vector<benchmark> & bms, std::string_view alloc) {
+  using V = std::vector<bool, counted<Alloc<bool>>>;
+  auto const tail = "<bool, "s + std::string(alloc) + ">"s;
+  bms.push_back({ "flip"s + tail, 0, &flip<V>, });
+  bms.push_back({ "hash"s + tail, 0, &hash<V>, });
+}
+
+template <template <class> class Alloc>
+void add_allocator(std::vector<benchmark> & bms, std::string_view alloc) {
+  add_vector<Alloc, int>(bms, "int", alloc);
+  add_vector<Alloc, double>(bms, "double", alloc);
+  add_vector<Alloc, std::string>(bms, "std::string", alloc);
+  add_bool<Alloc>(bms, alloc);
+}
+
+inline std::vector<benchmark> all() {
+  std::vector<benchmark> bms;
+  add_allocator<std::allocator>(bms, "std::allocator");
+  add_allocator<valc::Mallocator>(bms, "valc::Mallocator");
+  add_allocator<vecrsv::NAlloc>(bms, "vecrsv::NAlloc");
+  return bms;
+}
+
+inline void json(std::vector<result> const & rs, std::string_view executable, std::ostream & os) {
+  auto const now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  char date[32];
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+  os << "{\n  \"context\": {\n    \"date\": "s;
+  valc::stats::json_string(os, date);
+  os << ",\n    \"executable\": "s;
+  valc::stats::json_string(os, executable);
+  os << ",\n    \"num_cpus\": "s << std::thread::hardware_concurrency()
+     << ",\n    \"large\": "s << (large ? "true"s : "false"s)
+     << "\n  },\n  \"benchmarks\": ["s;
+  char const * sep = "\n";
+  os << std::setprecision(6);
+  for (auto const & rs_ : rs) {
+    os << sep << "    {\"name\": "s;
+    valc::stats::json_string(os, rs_.name);
+    os << ", \"run_name\": "s;
+    valc::stats::json_string(os, rs_.name);
+    os << ", \"run_type\": \"iteration\", \"repetitions\": 1, \"repetition_index\": 0"s
+       << ", \"threads\": 1, \"iterations\": "s << rs_.iterations
+       << ", \"real_time\": "s << rs_.real_ns << ", \"cpu_time\": "s << rs_.cpu_ns
+       << ", \"time_unit\": \"ns\", \"items_per_second\": "s
+       << (rs_.cpu_ns > 0.0 ? rs_.ops / rs_.iterations / rs_.cpu_ns * 1e9 : 0.0)
+       << ", \"ns_per_op\": "s << rs_.ns_per_op
+       << ", \"bytes_per_op\": "s << rs_.bytes_per_op
+       << ", \"allocs_per_op\": "s << rs_.allocs_per_op << '}';
+    sep = ",\n";
+  }
+  os << "\n  ]\n}\n"s << std::defaultfloat;
+}
+
+} /* namespace bench::suite */
+
+/*
+ *  MARK: C_vector_suite()
+ */
+int C_vector_suite(int argc, const char * argv[]) {
+  std::cout << "In "s << __func__ << std::endl;
+
+  auto filter = ""s;
+  auto json_path = ""s;
+  auto min_ns = 10e6;
+  for (auto arg : std::span(argv + 1, argv + argc)) {
+    auto const opt = std::string_view(arg);
+    auto const val = opt.substr(opt.find('=') + 1);
+    if (opt == "--bench-large") {
+      bench::large = true;
+    }
+    else if (opt.starts_with("--bench-filter=")) {
+      filter = val;
+    }
+    else if (opt.starts_with("--bench-json=")) {
+      json_path = val;
+    }
+    else if (opt.starts_with("--bench-min-time=")) {
+      min_ns = std::strtod(std::string(val).c_str(), nullptr) * 1e6;
+    }
+  }
+
+  auto const max_size = bench::large ? 100'000'000ul : 1'000'000ul;
+  auto constexpr max_bytes = 1ul << 30;
+
+  std::cout << std::left << std::setw(56) << "Benchmark"s << std::right
+            << std::setw(14) << "ns/op"s << std::setw(14) << "bytes/op"s
+            << std::setw(14) << "allocs/op"s << std::setw(14) << "iterations"s << '\n'
+            << std::string(112, '-') << '\n';
+
+  std::vector<bench::suite::result> results;
+  valc::trace::mode_scope const quiet(valc::trace::mode::off);
+  for (auto const & bm : bench::suite::all()) {
+    for (auto size = 1ul; size <= max_size; size *= 10) {
+      auto name = bm.name + '/' + std::to_string(size);
+      if (name.find(filter) == name.npos || size * bm.element_size > max_bytes) {
+        continue;
+      }
+      bench::suite::state st(size, min_ns);
+      bm.run(st);
+      auto const & rs = results.emplace_back(bench::suite::result {
+        std::move(name), st.iterations(), st.ops(), st.ns() / st.iterations(),
+        st.cpu_ns() / st.iterations(), st.ns() / st.ops(),
+        st.bytes_allocated() / st.ops(), st.allocations_made() / st.ops(),
+      });
+      std::cout << std::left << std::setw(56) << rs.name << std::right << std::fixed
+                << std::setprecision(2) << std::setw(14) << rs.ns_per_op
+                << std::setw(14) << rs.bytes_per_op << std::setprecision(4)
+                << std::setw(14) << rs.allocs_per_op << std::setw(14) << rs.iterations
+                << '\n' << std::defaultfloat;
     }
   }
   std::cout << std::endl; //  make sure cout is flushed.
 
+  if (json_path == "-") {
+    //  std::cout is on stderr (see main()); the JSON goes to stdout itself.
+    std::ostringstream oss;
+    bench::suite::json(results, argv[0], oss);
+    std::fputs(oss.str().c_str(), stdout);
+    std::fflush(stdout);
+  }
+  else if (!json_path.empty()) {
+    std::ofstream ofs(json_path);
+    if (!ofs) {
+      std::cerr << "cannot write "s << json_path << '\n';
+      return 1;
+    }
+    bench::suite::json(results, argv[0], ofs);
+    std::cout << "wrote "s << results.size() << " results to "s << json_path << std::endl;
+  }
+
   return 0;
 }